@@ -0,0 +1,199 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - benchmark harness
+ *
+ * A small self-contained micro-benchmark harness. Benchmarks are
+ * registered with BENCHMARK(), run for a calibrated number of
+ * iterations and repeated to report the minimum and the median
+ * time per processed item.
+ *
+ * Command line options:
+ *   --filter=<text>      Only run benchmarks whose name contains text
+ *   --min-time=<sec>     Minimum measured time per repetition
+ *   --repetitions=<n>    Number of repetitions per benchmark
+ *****************************************************************/
+
+#ifndef RWANDA_BENCH_HARNESS_H
+#define RWANDA_BENCH_HARNESS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+/**
+ * Passed to every benchmark run
+ * The benchmark builds its fixture, then brackets the measured
+ * loop with startTimer() and stopTimer()
+ */
+class State {
+private:
+    using Clock = std::chrono::steady_clock;
+
+    size_t iterationCount;
+    long argument;
+    size_t items;
+    Clock::time_point started;
+    double elapsed;             // Measured time in nanoseconds
+
+public:
+    State(size_t iterations, long arg)
+        : iterationCount(iterations), argument(arg), items(0), elapsed(0.0) {}
+
+    size_t iterations() const { return iterationCount; }
+    long arg() const { return argument; }
+
+    void startTimer() { started = Clock::now(); }
+
+    void stopTimer() {
+        elapsed += std::chrono::duration<double, std::nano>(Clock::now() - started).count();
+    }
+
+    /**
+     * Sets how many items the measured loop processed
+     * Defaults to the number of iterations
+     */
+    void setItemsProcessed(size_t count) { items = count; }
+
+    size_t itemsProcessed() const { return items ? items : iterationCount; }
+    double elapsedNs() const { return elapsed; }
+};
+
+/**
+ * Keeps a value alive so the compiler cannot remove its computation
+ */
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * A registered benchmark
+ * fixedIterations disables calibration for benchmarks whose
+ * iterations cannot be repeated cheaply (0 means calibrate)
+ */
+struct Benchmark {
+    std::string name;
+    std::function<void(State&)> function;
+    std::vector<long> args;
+    size_t fixedIterations;
+};
+
+inline std::vector<Benchmark>& registry() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+struct Registrar {
+    Registrar(const std::string& name, std::function<void(State&)> function,
+              std::vector<long> args, size_t fixedIterations = 0) {
+        registry().push_back({name, function, args, fixedIterations});
+    }
+};
+
+/**
+ * Redirects std::cout to nowhere while in scope
+ * The library reports every operation on the console, which would
+ * otherwise dominate the measurements
+ */
+class SilenceStdout {
+private:
+    std::ostringstream sink;
+    std::streambuf* previous;
+
+public:
+    SilenceStdout() : previous(std::cout.rdbuf()) {
+        sink.setstate(std::ios::badbit);
+        std::cout.rdbuf(sink.rdbuf());
+    }
+    ~SilenceStdout() { std::cout.rdbuf(previous); }
+};
+
+/**
+ * Runs the registered benchmarks and prints a result table
+ * @return Process exit code
+ */
+inline int runBenchmarks(int argc, char** argv) {
+    std::string filter;
+    double minTime = 0.2;
+    int repetitions = 5;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option.rfind("--filter=", 0) == 0) {
+            filter = option.substr(9);
+        } else if (option.rfind("--min-time=", 0) == 0) {
+            minTime = std::atof(option.c_str() + 11);
+        } else if (option.rfind("--repetitions=", 0) == 0) {
+            repetitions = std::max(1, std::atoi(option.c_str() + 14));
+        } else {
+            std::cerr << "Unknown option " << option << std::endl;
+            return 1;
+        }
+    }
+
+    std::printf("%-48s %12s %14s %14s %14s\n", "Benchmark", "Iterations",
+                "Min ns/item", "Median ns/item", "Items/s");
+
+    for (const Benchmark& benchmark : registry()) {
+        for (long arg : benchmark.args) {
+            std::string name = benchmark.name + "/" + std::to_string(arg);
+            if (!filter.empty() && name.find(filter) == std::string::npos) {
+                continue;
+            }
+
+            // Grow the iteration count until one run takes minTime
+            size_t iterations = benchmark.fixedIterations ? benchmark.fixedIterations : 1;
+            while (!benchmark.fixedIterations) {
+                State state(iterations, arg);
+                {
+                    SilenceStdout silence;
+                    benchmark.function(state);
+                }
+                if (state.elapsedNs() >= minTime * 1e9 || iterations >= (size_t(1) << 30)) {
+                    break;
+                }
+                double scale = state.elapsedNs() > 0 ? minTime * 1e9 / state.elapsedNs() : 10.0;
+                iterations = static_cast<size_t>(iterations * std::min(10.0, std::max(2.0, scale * 1.2)));
+            }
+
+            std::vector<double> perItem;
+            for (int rep = 0; rep < repetitions; ++rep) {
+                State state(iterations, arg);
+                {
+                    SilenceStdout silence;
+                    benchmark.function(state);
+                }
+                perItem.push_back(state.elapsedNs() / state.itemsProcessed());
+            }
+            std::sort(perItem.begin(), perItem.end());
+            double median = perItem[perItem.size() / 2];
+
+            std::printf("%-48s %12zu %14.1f %14.1f %14.3g\n", name.c_str(), iterations,
+                        perItem.front(), median, median > 0 ? 1e9 / median : 0.0);
+            std::fflush(stdout);
+        }
+    }
+    return 0;
+}
+
+} // namespace bench
+
+#define BENCH_CONCAT_INNER(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_INNER(a, b)
+
+/**
+ * Registers a benchmark function for a list of arguments
+ * Usage: BENCHMARK(BM_Name, {10, 100}) or with a fixed iteration
+ * count as the third argument
+ */
+#define BENCHMARK(function, ...) \
+    static bench::Registrar BENCH_CONCAT(benchRegistrar_, __LINE__)(#function, function, __VA_ARGS__)
+
+#endif // RWANDA_BENCH_HARNESS_H
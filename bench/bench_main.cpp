@@ -0,0 +1,797 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - micro-benchmarks
+ *
+ * Measures the core RwandaInfrastructure operations on networks
+ * of increasing size, and the graph engine with each storage
+ * layout so deployments can pick the fastest one. Files written by saveToFiles go to a
+ * scratch directory under the system temp directory.
+ *
+ * Usage: rwanda_bench [--filter=<text>] [--min-time=<sec>] [--repetitions=<n>]
+ *****************************************************************/
+
+#include "bench_harness.h"
+#include "budget_kernels.h"
+#include "budget_history.h"
+#include "directed_graph.h"
+#include "generator.h"
+#include "graph_engine.h"
+#include "infrastructure.h"
+#include "name_key.h"
+#include "prefix_index.h"
+#include "snapshot.h"
+#include "spatial_index.h"
+#include "trigram_index.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+//====================================================================
+// FIXTURES
+//====================================================================
+
+/**
+ * Builds the name of the i-th synthetic city
+ */
+static string cityName(long i) {
+    return "City" + to_string(i);
+}
+
+/**
+ * Generates a road-like network with about three roads per city
+ */
+static GeneratedNetwork makeNetwork(long cityCount) {
+    GeneratorOptions options;
+    options.cityCount = cityCount;
+    options.averageDegree = 3.0;
+    return generateNetwork(options);
+}
+
+//====================================================================
+// BENCHMARKS
+//====================================================================
+
+static void BM_AddCities(bench::State& state) {
+    vector<string> names;
+    for (long i = 0; i < state.arg(); ++i) {
+        names.push_back(cityName(i));
+    }
+
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        RwandaInfrastructure network;
+        for (const string& name : names) {
+            network.addCity(name);
+        }
+        bench::doNotOptimize(network);
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations() * names.size());
+}
+BENCHMARK(BM_AddCities, {100, 1000}, 3);
+
+static void BM_AddRoads(bench::State& state) {
+    RwandaInfrastructure network;
+    for (long i = 0; i < state.arg(); ++i) {
+        network.addCity(cityName(i));
+    }
+    mt19937 rng(7);
+    uniform_int_distribution<long> pick(0, state.arg() - 1);
+    vector<pair<string, string>> pairs;
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        pairs.emplace_back(cityName(pick(rng)), cityName(pick(rng)));
+    }
+
+    state.startTimer();
+    for (const auto& p : pairs) {
+        network.addRoad(p.first, p.second);
+    }
+    state.stopTimer();
+}
+BENCHMARK(BM_AddRoads, {100, 1000}, 20000);
+
+static void BM_AddBudget(bench::State& state) {
+    GeneratedNetwork generated = makeNetwork(state.arg());
+    RwandaInfrastructure network;
+    loadGeneratedNetwork(network, generated);
+    const Road& road = generated.roads[generated.roads.size() / 2];
+    string a = generated.cityNames[road.city1 - 1];
+    string b = generated.cityNames[road.city2 - 1];
+
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        network.addBudget(a, b, static_cast<Budget>(it % 100) * BUDGET_PER_BILLION);
+    }
+    state.stopTimer();
+}
+BENCHMARK(BM_AddBudget, {100, 1000});
+
+static void BM_FindCityIndex(bench::State& state) {
+    RwandaInfrastructure network;
+    for (long i = 0; i < state.arg(); ++i) {
+        network.addCity(cityName(i));
+    }
+    mt19937 rng(3);
+    uniform_int_distribution<long> pick(0, state.arg() - 1);
+    vector<string> queries;
+    for (int q = 0; q < 1024; ++q) {
+        queries.push_back(cityName(pick(rng)));
+    }
+
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        bench::doNotOptimize(network.findCityIndex(queries[it & 1023]));
+    }
+    state.stopTimer();
+}
+BENCHMARK(BM_FindCityIndex, {10, 100, 1000, 10000});
+
+static void BM_LoadNetwork(bench::State& state) {
+    GeneratedNetwork generated = makeNetwork(state.arg());
+
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        RwandaInfrastructure network;
+        loadGeneratedNetwork(network, generated);
+        bench::doNotOptimize(network);
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations() * generated.cityNames.size());
+}
+BENCHMARK(BM_LoadNetwork, {100, 1000, 5000});
+
+static void BM_GenerateNetwork(bench::State& state) {
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        bench::doNotOptimize(makeNetwork(state.arg()));
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations() * state.arg());
+}
+BENCHMARK(BM_GenerateNetwork, {1000, 100000});
+
+static void BM_SaveToFiles(bench::State& state) {
+    RwandaInfrastructure network;
+    loadGeneratedNetwork(network, makeNetwork(state.arg()));
+
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        network.saveToFiles();
+    }
+    state.stopTimer();
+}
+BENCHMARK(BM_SaveToFiles, {100, 1000});
+
+/**
+ * Builds a road table straight from a generated network, without
+ * the dense storage that limits RwandaInfrastructure's size
+ */
+static RoadTable makeRoadTable(const GeneratedNetwork& generated) {
+    RoadTable table;
+    mt19937 rng(5);
+    uniform_int_distribution<int> condition(0, 5);
+    for (const Road& road : generated.roads) {
+        table.city1.push_back(road.city1 - 1);
+        table.city2.push_back(road.city2 - 1);
+        table.budget.push_back(road.budget);
+        table.length.push_back(static_cast<float>(road.budget / BUDGET_PER_BILLION));
+        table.surface.push_back(rng() % 5);
+        table.lanes.push_back(2);
+        table.condition.push_back(condition(rng));
+        table.district1.push_back(-1);
+        table.district2.push_back(-1);
+    }
+    return table;
+}
+
+static void BM_RoadQuery(bench::State& state) {
+    RoadTable table = makeRoadTable(makeNetwork(state.arg()));
+    RoadQuery query;
+    string error;
+    parseRoadQuery("budget >= 20 and budget < 80 and condition < 3 sum by bucket 10", query, error);
+
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        bench::doNotOptimize(executeRoadQuery(table, query));
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations() * table.size());
+}
+BENCHMARK(BM_RoadQuery, {1000, 100000});
+
+static void BM_RoadQuerySum(bench::State& state) {
+    RoadTable table = makeRoadTable(makeNetwork(state.arg()));
+    RoadQuery query;
+    string error;
+    parseRoadQuery("budget >= 20 sum", query, error);
+
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        bench::doNotOptimize(executeRoadQuery(table, query));
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations() * table.size());
+}
+BENCHMARK(BM_RoadQuerySum, {1000, 100000});
+
+//====================================================================
+// BUDGET SUM BENCHMARKS
+//====================================================================
+
+/**
+ * Budgets with two decimals, as entered, in thousands of RWF
+ */
+static vector<Budget> makeBudgets(long count) {
+    mt19937_64 rng(5);
+    vector<Budget> budgets(count);
+    for (Budget& budget : budgets) {
+        budget = static_cast<Budget>(rng() % 15000) * (BUDGET_PER_BILLION / 100);
+    }
+    return budgets;
+}
+
+static void BM_BudgetSumDouble(bench::State& state) {
+    vector<Budget> budgets = makeBudgets(state.arg());
+    vector<double> billions(budgets.size());
+    for (size_t k = 0; k < budgets.size(); ++k) {
+        billions[k] = static_cast<double>(budgets[k]) / BUDGET_PER_BILLION;
+    }
+
+    // The in-order floating-point sum the budgets used to have
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        double total = 0.0;
+        for (double value : billions) {
+            total += value;
+        }
+        bench::doNotOptimize(total);
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations() * budgets.size());
+}
+BENCHMARK(BM_BudgetSumDouble, {1000, 1000000});
+
+static void BM_BudgetSumFixed(bench::State& state) {
+    vector<Budget> budgets = makeBudgets(state.arg());
+
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        bench::doNotOptimize(sumBudgets(budgets.data(), budgets.size()));
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations() * budgets.size());
+}
+BENCHMARK(BM_BudgetSumFixed, {1000, 1000000});
+
+/**
+ * The fused summary at one kernel level; levels the processor lacks
+ * fall back to the widest one it has
+ */
+template <BudgetKernelLevel Level>
+static void BM_BudgetSummary(bench::State& state) {
+    vector<Budget> budgets = makeBudgets(state.arg());
+    const Budget threshold = 50 * BUDGET_PER_BILLION;
+    setBudgetKernelLevel(Level);
+
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        bench::doNotOptimize(summarizeBudgets(budgets.data(), budgets.size(), threshold));
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations() * budgets.size());
+    setBudgetKernelLevel(bestBudgetKernelLevel());
+}
+BENCHMARK(BM_BudgetSummary<BudgetKernelLevel::Baseline>, {1000, 1000000});
+BENCHMARK(BM_BudgetSummary<BudgetKernelLevel::Avx2>, {1000, 1000000});
+BENCHMARK(BM_BudgetSummary<BudgetKernelLevel::Avx512>, {1000, 1000000});
+
+//====================================================================
+// BUDGET HISTORY BENCHMARKS
+//====================================================================
+
+/**
+ * Builds 25 years of budgets for the given number of roads, each
+ * drifting a few percent a year
+ */
+static BudgetTimeSeries makeBudgetHistory(long roadCount) {
+    BudgetTimeSeries history;
+    mt19937 rng(11);
+    uniform_real_distribution<double> start(10.0, 500.0);
+    normal_distribution<double> drift(0.0, 0.03);
+    vector<double> budgets(roadCount);
+    for (long road = 0; road < roadCount; ++road) {
+        budgets[road] = start(rng);
+    }
+    for (int year = 2000; year < 2025; ++year) {
+        for (long road = 0; road < roadCount; ++road) {
+            budgets[road] = max(0.0, budgets[road] * (1.0 + drift(rng)));
+            history.setBudget(road, year, budgetFromBillions(budgets[road]));
+        }
+    }
+    return history;
+}
+
+static void BM_BudgetYearOverYear(bench::State& state) {
+    BudgetTimeSeries history = makeBudgetHistory(state.arg());
+
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        bench::doNotOptimize(history.yearOverYear(2001 + it % 24));
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations() * state.arg());
+}
+BENCHMARK(BM_BudgetYearOverYear, {1000, 100000});
+
+static void BM_BudgetCumulative(bench::State& state) {
+    BudgetTimeSeries history = makeBudgetHistory(state.arg());
+
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        bench::doNotOptimize(history.cumulativeBudgets(2024));
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations() * state.arg() * history.yearCount());
+}
+BENCHMARK(BM_BudgetCumulative, {1000, 100000});
+
+//====================================================================
+// SNAPSHOT DIFF BENCHMARKS
+//====================================================================
+
+static void BM_SnapshotDiff(bench::State& state) {
+    GeneratedNetwork generated = makeNetwork(state.arg());
+    NetworkSnapshot before{generated.cityNames, generated.roads};
+
+    // About 1% of the cities renamed and budgets changed, a few
+    // roads dropped and as many added, in shuffled order
+    NetworkSnapshot after = before;
+    mt19937 rng(5);
+    for (size_t i = 0; i < after.cityNames.size(); i += 100) {
+        after.cityNames[i] += "-renamed";
+    }
+    for (size_t r = 0; r < after.roads.size(); r += 100) {
+        after.roads[r].budget += BUDGET_PER_BILLION;
+    }
+    after.roads.resize(after.roads.size() - after.roads.size() / 200);
+    for (long i = 0; i + 1 < state.arg(); i += 200) {
+        after.roads.push_back({static_cast<int>(i + 1), static_cast<int>(state.arg() - i), 5 * BUDGET_PER_BILLION});
+    }
+    shuffle(after.roads.begin(), after.roads.end(), rng);
+
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        bench::doNotOptimize(diffSnapshots(before, after));
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations() * (before.roads.size() + after.roads.size()));
+}
+BENCHMARK(BM_SnapshotDiff, {1000, 100000, 1000000});
+
+//====================================================================
+// SPATIAL INDEX BENCHMARKS
+//====================================================================
+
+/**
+ * Indexes the given number of cities spread uniformly over Rwanda
+ */
+static SpatialIndex makeSpatialIndex(long cityCount) {
+    SpatialIndex index;
+    mt19937 rng(3);
+    uniform_real_distribution<double> latitude(-2.84, -1.05);
+    uniform_real_distribution<double> longitude(28.86, 30.90);
+    for (long city = 0; city < cityCount; ++city) {
+        index.setLocation(city, {latitude(rng), longitude(rng)});
+    }
+    return index;
+}
+
+static void BM_SpatialInsert(bench::State& state) {
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        bench::doNotOptimize(makeSpatialIndex(state.arg()));
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations() * state.arg());
+}
+BENCHMARK(BM_SpatialInsert, {1000, 100000}, 5);
+
+static void BM_SpatialNearest(bench::State& state) {
+    SpatialIndex index = makeSpatialIndex(state.arg());
+    mt19937 rng(4);
+    uniform_real_distribution<double> latitude(-2.84, -1.05);
+    uniform_real_distribution<double> longitude(28.86, 30.90);
+
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        bench::doNotOptimize(index.nearest({latitude(rng), longitude(rng)}, 5));
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SpatialNearest, {1000, 100000, 1000000}, 20000);
+
+//====================================================================
+// NAME SEARCH BENCHMARKS
+//====================================================================
+
+/**
+ * Builds place-like names from random syllables, e.g. "Rukigamu"
+ */
+static vector<string> makePlaceNames(long count) {
+    static const char* syllables[] = {"ru", "ki", "ga", "li", "mu", "sa", "nze", "nya", "ta", "re",
+                                      "hu", "ye", "bu", "ngo", "ka", "mo", "zi", "gi", "ma", "ra"};
+    mt19937 rng(8);
+    uniform_int_distribution<int> pick(0, 19);
+    uniform_int_distribution<int> length(2, 5);
+    vector<string> names(count);
+    for (string& name : names) {
+        for (int s = length(rng); s > 0; --s) {
+            name += syllables[pick(rng)];
+        }
+        name[0] = static_cast<char>(toupper(name[0]));
+    }
+    return names;
+}
+
+static void BM_FuzzyNameSearch(bench::State& state) {
+    vector<string> names = makePlaceNames(state.arg());
+    TrigramIndex index;
+    for (long city = 0; city < state.arg(); ++city) {
+        index.add(city, names[city]);
+    }
+
+    // Look up normalized names with one letter dropped
+    mt19937 rng(9);
+    uniform_int_distribution<long> pick(0, state.arg() - 1);
+    vector<string> queries(64);
+    for (string& query : queries) {
+        query = normalizeName(names[pick(rng)]);
+        query.erase(query.size() / 2, 1);
+    }
+
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        bench::doNotOptimize(index.search(queries[it % queries.size()], 5));
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FuzzyNameSearch, {1000, 100000});
+
+static void BM_PrefixComplete(bench::State& state) {
+    PrefixIndex index;
+    index.build(makePlaceNames(state.arg()));
+
+    // Two- to four-letter prefixes of existing names
+    vector<string> names = makePlaceNames(64);
+    vector<string> prefixes;
+    for (size_t i = 0; i < names.size(); ++i) {
+        prefixes.push_back(names[i].substr(0, 2 + i % 3));
+    }
+
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        bench::doNotOptimize(index.complete(prefixes[it % prefixes.size()], 5));
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PrefixComplete, {1000, 100000});
+
+/**
+ * Directed arcs of a generated network with every third road one-way
+ */
+static DirectedRoadGraph makeRouteGraph(long cityCount) {
+    GeneratedNetwork generated = makeNetwork(cityCount);
+    for (size_t id = 0; id < generated.roads.size(); id += 3) {
+        generated.roads[id].oneWay = true;
+    }
+    DirectedRoadGraph graph;
+    graph.build(cityCount, generated.roads);
+    return graph;
+}
+
+static void BM_RouteOneSided(bench::State& state) {
+    DirectedRoadGraph graph = makeRouteGraph(state.arg());
+
+    // A full forward search answers one source-target query
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        bench::doNotOptimize(graph.cheapestFrom(static_cast<int>(it * 7919 % state.arg())));
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RouteOneSided, {1000, 100000});
+
+static void BM_RouteBidirectional(bench::State& state) {
+    DirectedRoadGraph graph = makeRouteGraph(state.arg());
+
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        int source = static_cast<int>(it * 7919 % state.arg());
+        int target = static_cast<int>((it * 104729 + 1) % state.arg());
+        bench::doNotOptimize(graph.cheapestRoute(source, target));
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RouteBidirectional, {1000, 100000});
+
+//====================================================================
+// STORAGE LAYOUT BENCHMARKS
+//====================================================================
+
+/**
+ * Loads a generated network into an engine with the given layout
+ */
+template <template <typename> class StoragePolicy>
+static void loadEngine(BasicInfrastructure<StoragePolicy, Budget>& engine, const GeneratedNetwork& generated) {
+    engine.loadNetwork(generated.cityNames, generated.roads);
+}
+
+template <template <typename> class StoragePolicy>
+static void BM_EngineLoad(bench::State& state) {
+    GeneratedNetwork generated = makeNetwork(state.arg());
+
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        BasicInfrastructure<StoragePolicy, Budget> engine;
+        loadEngine(engine, generated);
+        bench::doNotOptimize(engine);
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations() * generated.roads.size());
+}
+BENCHMARK(BM_EngineLoad<DenseStorage>, {1000, 5000});
+BENCHMARK(BM_EngineLoad<TriangularStorage>, {1000, 5000});
+BENCHMARK(BM_EngineLoad<BitsetStorage>, {1000, 5000});
+BENCHMARK(BM_EngineLoad<CsrStorage>, {1000, 5000});
+
+template <template <typename> class StoragePolicy>
+static void BM_EngineComponents(bench::State& state) {
+    BasicInfrastructure<StoragePolicy, Budget> engine;
+    loadEngine(engine, makeNetwork(state.arg()));
+
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        bench::doNotOptimize(engine.componentLabels());
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations() * state.arg());
+}
+BENCHMARK(BM_EngineComponents<DenseStorage>, {1000, 5000});
+BENCHMARK(BM_EngineComponents<TriangularStorage>, {1000, 5000});
+BENCHMARK(BM_EngineComponents<BitsetStorage>, {1000, 5000});
+BENCHMARK(BM_EngineComponents<CsrStorage>, {1000, 5000});
+
+template <template <typename> class StoragePolicy>
+static void BM_EngineCheapestCosts(bench::State& state) {
+    BasicInfrastructure<StoragePolicy, Budget> engine;
+    loadEngine(engine, makeNetwork(state.arg()));
+
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        bench::doNotOptimize(engine.cheapestCosts(static_cast<int>(it % state.arg())));
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations() * state.arg());
+}
+BENCHMARK(BM_EngineCheapestCosts<DenseStorage>, {1000, 5000});
+BENCHMARK(BM_EngineCheapestCosts<TriangularStorage>, {1000, 5000});
+BENCHMARK(BM_EngineCheapestCosts<BitsetStorage>, {1000, 5000});
+BENCHMARK(BM_EngineCheapestCosts<CsrStorage>, {1000, 5000});
+
+template <template <typename> class StoragePolicy>
+static void BM_EngineBudgetTotal(bench::State& state) {
+    BasicInfrastructure<StoragePolicy, Budget> engine;
+    loadEngine(engine, makeNetwork(state.arg()));
+
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        bench::doNotOptimize(engine.networkBudgetTotal());
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations() * engine.roadCount());
+}
+BENCHMARK(BM_EngineBudgetTotal<DenseStorage>, {1000, 5000});
+BENCHMARK(BM_EngineBudgetTotal<TriangularStorage>, {1000, 5000});
+BENCHMARK(BM_EngineBudgetTotal<BitsetStorage>, {1000, 5000});
+BENCHMARK(BM_EngineBudgetTotal<CsrStorage>, {1000, 5000});
+
+/**
+ * Summarizes every row of the dense budget matrix at one kernel level
+ */
+template <BudgetKernelLevel Level>
+static void BM_EngineCitySummary(bench::State& state) {
+    BasicInfrastructure<DenseStorage, Budget> engine;
+    loadEngine(engine, makeNetwork(state.arg()));
+    const Budget threshold = 50 * BUDGET_PER_BILLION;
+    setBudgetKernelLevel(Level);
+
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        for (int slot = 0; slot < state.arg(); ++slot) {
+            bench::doNotOptimize(engine.citySummary(slot, threshold));
+        }
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations() * state.arg() * state.arg());
+    setBudgetKernelLevel(bestBudgetKernelLevel());
+}
+BENCHMARK(BM_EngineCitySummary<BudgetKernelLevel::Baseline>, {1000, 5000});
+BENCHMARK(BM_EngineCitySummary<BudgetKernelLevel::Avx2>, {1000, 5000});
+BENCHMARK(BM_EngineCitySummary<BudgetKernelLevel::Avx512>, {1000, 5000});
+
+//====================================================================
+// CITY ORDER BENCHMARKS
+//====================================================================
+
+/**
+ * A generated network with its cities numbered in random order, as
+ * when cities are entered without regard to geography; generated
+ * networks are otherwise numbered row by row and already banded
+ */
+static GeneratedNetwork makeShuffledNetwork(long cityCount) {
+    GeneratedNetwork generated = makeNetwork(cityCount);
+    vector<int> newIndex(generated.cityNames.size());
+    for (size_t i = 0; i < newIndex.size(); ++i) {
+        newIndex[i] = i;
+    }
+    shuffle(newIndex.begin(), newIndex.end(), mt19937(11));
+
+    vector<string> names(newIndex.size());
+    for (size_t i = 0; i < newIndex.size(); ++i) {
+        names[newIndex[i]] = generated.cityNames[i];
+    }
+    generated.cityNames.swap(names);
+    for (Road& road : generated.roads) {
+        road.city1 = newIndex[road.city1 - 1] + 1;
+        road.city2 = newIndex[road.city2 - 1] + 1;
+    }
+    return generated;
+}
+
+template <template <typename> class StoragePolicy>
+static void runShuffledComponents(bench::State& state, CityOrder order) {
+    BasicInfrastructure<StoragePolicy, Budget> engine;
+    loadEngine(engine, makeShuffledNetwork(state.arg()));
+    engine.reorderStorage(order);
+
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        bench::doNotOptimize(engine.componentLabels());
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations() * state.arg());
+}
+
+template <template <typename> class StoragePolicy>
+static void runShuffledCheapestCosts(bench::State& state, CityOrder order) {
+    BasicInfrastructure<StoragePolicy, Budget> engine;
+    loadEngine(engine, makeShuffledNetwork(state.arg()));
+    engine.reorderStorage(order);
+
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        bench::doNotOptimize(engine.cheapestCosts(static_cast<int>(it % state.arg())));
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations() * state.arg());
+}
+
+template <template <typename> class StoragePolicy>
+static void BM_ShuffledComponents(bench::State& state) {
+    runShuffledComponents<StoragePolicy>(state, CityOrder::Insertion);
+}
+BENCHMARK(BM_ShuffledComponents<DenseStorage>, {1000, 5000});
+BENCHMARK(BM_ShuffledComponents<CsrStorage>, {5000, 100000});
+
+template <template <typename> class StoragePolicy>
+static void BM_ReorderedComponents(bench::State& state) {
+    runShuffledComponents<StoragePolicy>(state, CityOrder::ReverseCuthillMcKee);
+}
+BENCHMARK(BM_ReorderedComponents<DenseStorage>, {1000, 5000});
+BENCHMARK(BM_ReorderedComponents<CsrStorage>, {5000, 100000});
+
+template <template <typename> class StoragePolicy>
+static void BM_ShuffledCheapestCosts(bench::State& state) {
+    runShuffledCheapestCosts<StoragePolicy>(state, CityOrder::Insertion);
+}
+BENCHMARK(BM_ShuffledCheapestCosts<DenseStorage>, {1000, 5000});
+BENCHMARK(BM_ShuffledCheapestCosts<CsrStorage>, {5000, 100000});
+
+template <template <typename> class StoragePolicy>
+static void BM_ReorderedCheapestCosts(bench::State& state) {
+    runShuffledCheapestCosts<StoragePolicy>(state, CityOrder::ReverseCuthillMcKee);
+}
+BENCHMARK(BM_ReorderedCheapestCosts<DenseStorage>, {1000, 5000});
+BENCHMARK(BM_ReorderedCheapestCosts<CsrStorage>, {5000, 100000});
+
+static void BM_ReorderStorage(bench::State& state) {
+    BasicInfrastructure<CsrStorage, Budget> engine;
+    loadEngine(engine, makeShuffledNetwork(state.arg()));
+
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        engine.reorderStorage(it % 2 == 0 ? CityOrder::ReverseCuthillMcKee : CityOrder::Insertion);
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations() * state.arg());
+}
+BENCHMARK(BM_ReorderStorage, {5000, 100000});
+
+//====================================================================
+// GRAPH MEMORY BENCHMARKS
+//====================================================================
+
+/**
+ * Summarizes the whole dense budget matrix, a sequential scan
+ */
+template <PageMode Mode>
+static void BM_PagesScan(bench::State& state) {
+    setGraphMemoryOptions({Mode, NodePlacement::FirstTouch});
+    BasicInfrastructure<DenseStorage, Budget> engine;
+    loadEngine(engine, makeNetwork(state.arg()));
+    const Budget threshold = 50 * BUDGET_PER_BILLION;
+
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        bench::doNotOptimize(engine.networkSummary(threshold));
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations() * state.arg() * state.arg());
+    setGraphMemoryOptions({});
+}
+BENCHMARK(BM_PagesScan<PageMode::Standard>, {2048, 8192});
+BENCHMARK(BM_PagesScan<PageMode::Transparent>, {2048, 8192});
+
+/**
+ * Visits every pair of the dense matrix column by column, as an
+ * all-pairs kernel reading the matrix transposed does; each step
+ * moves to another row and, past 512 cities, another 4 KiB page
+ */
+template <PageMode Mode>
+static void BM_PagesAllPairs(bench::State& state) {
+    setGraphMemoryOptions({Mode, NodePlacement::FirstTouch});
+    BasicInfrastructure<DenseStorage, Budget> engine;
+    loadEngine(engine, makeNetwork(state.arg()));
+    const DenseStorage<Budget>& storage = engine.roadStorage();
+    int n = state.arg();
+
+    state.startTimer();
+    for (size_t it = 0; it < state.iterations(); ++it) {
+        Budget largest = 0;
+        for (int j = 0; j < n; ++j) {
+            for (int i = 0; i < n; ++i) {
+                largest = max(largest, storage.weight(i, j));
+            }
+        }
+        bench::doNotOptimize(largest);
+    }
+    state.stopTimer();
+    state.setItemsProcessed(state.iterations() * n * n);
+    setGraphMemoryOptions({});
+}
+BENCHMARK(BM_PagesAllPairs<PageMode::Standard>, {2048, 8192});
+BENCHMARK(BM_PagesAllPairs<PageMode::Transparent>, {2048, 8192});
+
+//====================================================================
+// MAIN FUNCTION
+//====================================================================
+
+int main(int argc, char** argv) {
+    // Keep the benchmark output files away from the real data files
+    fs::path scratch = fs::temp_directory_path() / "rwanda_bench";
+    fs::create_directories(scratch);
+    fs::current_path(scratch);
+
+    return bench::runBenchmarks(argc, argv);
+}
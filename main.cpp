@@ -6,38 +6,32 @@
  * functionality for adding cities, roads, and their associated
  * budgets, as well as displaying and storing this information.
  * 
- * Data is persisted in real-time to text files:
- * - cities.txt: Contains information about all cities
- * - roads.txt: Contains information about roads and their budgets
+ * This file contains the interactive menu. The data structures
+ * and algorithms live in the rwanda_infra library (src/).
  *****************************************************************/
 
+#include "graph_memory.h"
+#include "infrastructure.h"
+#include "memory_report.h"
+#include "metrics.h"
+#include "trace.h"
+
 #include <iostream>
-#include <fstream>
 #include <vector>
 #include <string>
-#include <iomanip>
 #include <algorithm>
-#include <filesystem>  
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
 #include <limits>
+#include <sstream>
 
 using namespace std;
-namespace fs = std::filesystem;
 
 //====================================================================
 // UTILITY FUNCTIONS
 //====================================================================
 
-/**
- * Gets the absolute path of a file relative to the current directory
- * @param filename The name of the file
- * @return The absolute path as a string
- */
-string getAbsolutePath(const string& filename) {
-    fs::path currentPath = fs::current_path();
-    fs::path filePath = currentPath / filename;
-    return filePath.string();
-}
-
 /**
  * Clears input buffer and handles invalid input
  */
@@ -78,6 +72,39 @@ double getValidDoubleInput(const string& prompt) {
     return input;
 }
 
+/**
+ * Gets a budget in billion RWF, converted exactly as typed
+ * @param prompt Message to display to user
+ * @return Valid budget in thousands of RWF
+ */
+Budget getValidBudgetInput(const string& prompt) {
+    string input;
+    Budget budget;
+    cout << prompt;
+    while (!(cin >> input) || !parseBudget(input, budget)) {
+        cout << "Invalid input. Please enter an amount with at most " << BUDGET_DECIMALS << " decimals: ";
+        clearInputBuffer();
+    }
+    clearInputBuffer();
+    return budget;
+}
+
+/**
+ * Gets a coordinate in decimal degrees, which may be negative
+ * @param prompt Message to display to user
+ * @return Valid double input
+ */
+double getValidCoordinateInput(const string& prompt) {
+    double input;
+    cout << prompt;
+    while (!(cin >> input)) {
+        cout << "Invalid input. Please enter a number: ";
+        clearInputBuffer();
+    }
+    clearInputBuffer();
+    return input;
+}
+
 /**
  * Gets non-empty string input from user
  * @param prompt Message to display to user
@@ -94,374 +121,155 @@ string getValidStringInput(const string& prompt) {
     return input;
 }
 
-//====================================================================
-// STRUCTURES
-//====================================================================
+/**
+ * Gets a possibly empty line of input from user
+ * @param prompt Message to display to user
+ * @return The line entered, which may be empty
+ */
+string getOptionalStringInput(const string& prompt) {
+    string input;
+    cout << prompt;
+    getline(cin, input);
+    return input;
+}
 
 /**
- * Represents a city with an index and name
+ * Gets the name of an existing city, completing names that end in *
+ * ("Mu*" lists Muhanga and Musanze; a prefix with one match is
+ * completed to it)
+ * @param rwanda The infrastructure system holding the cities
+ * @param prompt Message to display to user
+ * @return Non-empty string input
  */
-struct City {
-    int index;      
-    string name;    
-};
+string getCityNameInput(const RwandaInfrastructure& rwanda, const string& prompt) {
+    const size_t shown = 10;
+    string input = getValidStringInput(prompt);
+    while (input.back() == '*') {
+        string prefix = input.substr(0, input.size() - 1);
+        vector<string> completions = rwanda.completeCityName(prefix, shown + 1);
+        if (completions.size() == 1) {
+            cout << "-> " << completions[0] << endl;
+            return completions[0];
+        }
+        if (completions.empty()) {
+            cout << "No city starts with " << prefix << ". ";
+        } else {
+            for (size_t i = 0; i < min(completions.size(), shown); ++i) {
+                cout << (i == 0 ? "" : ", ") << completions[i];
+            }
+            cout << (completions.size() > shown ? ", ..." : "") << endl;
+        }
+        input = getValidStringInput(prompt);
+    }
+    return input;
+}
 
 /**
- * Represents a road connection between two cities with a budget
+ * Asks which road is meant when several roads join two cities
+ * @param rwanda The infrastructure system holding the roads
+ * @return The road number, or 0 if the cities share at most one road
  */
-struct Road {
-    int city1;      
-    int city2;      
-    double budget;  
-};
+int getRoadNumberInput(RwandaInfrastructure& rwanda, const string& city1, const string& city2) {
+    if (rwanda.roadIdsBetween(city1, city2).size() < 2) {
+        return 0;
+    }
+    rwanda.displayRoadsBetween(city1, city2);
+    return getValidIntInput("Enter the road number: ");
+}
 
 //====================================================================
-// RWANDA INFRASTRUCTURE CLASS
+// INTERACTIVE VIEWS
 //====================================================================
 
 /**
- * Main class for managing Rwanda's infrastructure data
- * Handles cities, roads, and budget allocations
+ * Lets the user page through a window of the road and budget matrices
+ * Only the current window is rendered on each step
+ * @param rwanda The infrastructure system to display
  */
-class RwandaInfrastructure {
-private:
-    vector<City> cities;                  
-    vector<vector<int>> roadMatrix;       
-    vector<vector<double>> budgetMatrix; 
+void browseMatrixWindow(RwandaInfrastructure& rwanda) {
+    int mode = getValidIntInput("Select by (1) index range or (2) list of city indices: ");
     
-    int findCityIndex(const string& name) {
-        for (const auto& city : cities) {
-            if (city.name == name) {
-                return city.index;
-            }
+    if (mode == 2) {
+        string line = getValidStringInput("Enter city indices separated by spaces: ");
+        istringstream stream(line);
+        vector<int> indices;
+        int idx;
+        while (stream >> idx) {
+            indices.push_back(idx);
         }
-        return -1;
+        rwanda.displayRoadsSubset(indices);
+        rwanda.displayBudgetsSubset(indices);
+        return;
     }
-    
-    /**
-     * Initializes the road and budget matrices
-     * Called when the first city is added
-     */
-    void initializeMatrices() {
-        int size = cities.size();
-        roadMatrix.resize(size, vector<int>(size, 0));
-        budgetMatrix.resize(size, vector<double>(size, 0.0));
+    if (mode != 1) {
+        cout << "Invalid selection." << endl;
+        return;
     }
     
-    /**
-     * Resizes the matrices when new cities are added
-     * Preserves existing connections and budgets
-     */
-    void resizeMatrices() {
-        int newSize = cities.size();
-        // Resize road matrix
-        for (auto& row : roadMatrix) {
-            row.resize(newSize, 0);
-        }
-        roadMatrix.resize(newSize, vector<int>(newSize, 0));
-        
-        // Resize budget matrix
-        for (auto& row : budgetMatrix) {
-            row.resize(newSize, 0.0);
-        }
-        budgetMatrix.resize(newSize, vector<double>(newSize, 0.0));
-    }
-    
-public:
-    /**
-     * Constructor for the RwandaInfrastructure class
-     * Initializes with empty matrices
-     */
-    RwandaInfrastructure() {
-        // Initialize with empty matrices
+    int pageSize = getValidIntInput("Enter the page size (cities per side): ");
+    if (pageSize <= 0) {
+        cout << "Page size must be positive." << endl;
+        return;
     }
+    MatrixWindow window;
+    window.rowStart = getValidIntInput("Enter the first row city index: ");
+    window.colStart = getValidIntInput("Enter the first column city index: ");
+    window.rowCount = pageSize;
+    window.colCount = pageSize;
     
-    bool addCity(const string& name) {
-        // Check if city already exists
-        if (findCityIndex(name) != -1) {
-            cout << "City " << name << " already exists." << endl;
-            return false;
-        }
-        
-        int newIndex = cities.empty() ? 1 : cities.back().index + 1;
-        cities.push_back({newIndex, name});
-        
-        // Resize matrices if they exist
-        if (!roadMatrix.empty()) {
-            resizeMatrices();
-        } else {
-            initializeMatrices();
-        }
-        
-        cout << "City " << name << " added with index " << newIndex << endl;
-        return true;
-    }
-    
-    bool addRoad(const string& city1, const string& city2) {
-        if (city1 == city2) {
-            cout << "Cannot add a road between the same city." << endl;
-            return false;
-        }
-        
-        int idx1 = findCityIndex(city1);
-        int idx2 = findCityIndex(city2);
-        
-        if (idx1 == -1 || idx2 == -1) {
-            cout << "One or both cities not found." << endl;
-            return false;
-        }
-        
-        // Adjust for 0-based index in matrix
-        int i = idx1 - 1;
-        int j = idx2 - 1;
-        
-        if (roadMatrix[i][j] == 1) {
-            cout << "A road already exists between " << city1 << " and " << city2 << endl;
-            return false;
-        }
-        
-        roadMatrix[i][j] = 1;
-        roadMatrix[j][i] = 1;
-        
-        cout << "Road added between " << city1 << " and " << city2 << endl;
-        return true;
-    }
-    
-
-    bool addBudget(const string& city1, const string& city2, double budget) {
-        if (budget < 0) {
-            cout << "Budget cannot be negative." << endl;
-            return false;
-        }
-        
-        int idx1 = findCityIndex(city1);
-        int idx2 = findCityIndex(city2);
-        
-        if (idx1 == -1 || idx2 == -1) {
-            cout << "One or both cities not found." << endl;
-            return false;
-        }
-        
-        // Adjust for 0-based index in matrix
-        int i = idx1 - 1;
-        int j = idx2 - 1;
+    // Steps are computed in 64 bits, as start + pageSize can pass INT_MAX
+    int64_t total = rwanda.cityCount();
+    auto forward = [&](int start) {
+        int64_t next = static_cast<int64_t>(start) + pageSize;
+        return next <= total ? static_cast<int>(next) : start;
+    };
+    auto back = [&](int start) {
+        return static_cast<int>(max<int64_t>(1, static_cast<int64_t>(start) - pageSize));
+    };
+    string command;
+    do {
+        rwanda.displayRoadsWindow(window);
+        rwanda.displayBudgetsWindow(window);
         
-        if (roadMatrix[i][j] == 0) {
-            cout << "No road exists between " << city1 << " and " << city2 << endl;
-            return false;
+        command = getValidStringInput("\n[n]ext rows, [p]revious rows, [r]ight, [l]eft, [q]uit: ");
+        switch (command[0]) {
+            case 'n':
+                window.rowStart = forward(window.rowStart);
+                break;
+            case 'p':
+                window.rowStart = back(window.rowStart);
+                break;
+            case 'r':
+                window.colStart = forward(window.colStart);
+                break;
+            case 'l':
+                window.colStart = back(window.colStart);
+                break;
         }
-        
-        budgetMatrix[i][j] = budget;
-        budgetMatrix[j][i] = budget;
-        
-        cout << "Budget of " << budget << " billion RWF added for road between " 
-             << city1 << " and " << city2 << endl;
-        return true;
-    }
-    
+    } while (command[0] != 'q');
+}
 
-    bool editCity(const string& oldName, const string& newName) {
-        if (oldName == newName) {
-            cout << "New name is the same as the old name." << endl;
-            return false;
-        }
-        
-        int idx = findCityIndex(oldName);
-        if (idx == -1) {
-            cout << "City " << oldName << " not found." << endl;
-            return false;
-        }
-        
-        // Check if new name already exists
-        if (findCityIndex(newName) != -1) {
-            cout << "City " << newName << " already exists." << endl;
-            return false;
-        }
-        
-        for (auto& city : cities) {
-            if (city.name == oldName) {
-                city.name = newName;
-                cout << "City renamed from " << oldName << " to " << newName << endl;
-                return true;
-            }
-        }
-        
-        return false;
-    }
-    
-    void searchCityByIndex(int idx) {
-        for (const auto& city : cities) {
-            if (city.index == idx) {
-                cout << "City found: " << city.index << ": " << city.name << endl;
-                return;
-            }
-        }
-        cout << "City with index " << idx << " not found." << endl;
-    }
-    
-    bool hasCities() const {
-        return !cities.empty();
-    }
-    
-    /**
-     * Displays all cities and their indices
-     */
-    void displayCities() {
-        if (cities.empty()) {
-            cout << "No cities recorded yet." << endl;
-            return;
-        }
-        
-        cout << "\nCities:\n";
-        for (const auto& city : cities) {
-            cout << city.index << ": " << city.name << endl;
-        }
-    }
-    
-    /**
-     * Displays the road network as an adjacency matrix
-     */
-    void displayRoads() {
-        if (cities.empty()) {
-            cout << "No cities recorded yet." << endl;
-            return;
-        }
-        
-        cout << "\nRoads Adjacency Matrix:\n";
-        cout << "    ";
-        for (const auto& city : cities) {
-            cout << setw(4) << city.index;
-        }
-        cout << endl;
-        
-        for (size_t i = 0; i < roadMatrix.size(); ++i) {
-            cout << setw(4) << cities[i].index;
-            for (size_t j = 0; j < roadMatrix[i].size(); ++j) {
-                cout << setw(4) << roadMatrix[i][j];
-            }
-            cout << endl;
-        }
-    }
-    
-    /**
-     * Displays the budget allocations as a matrix
-     */
-    void displayBudgets() {
-        if (cities.empty()) {
-            cout << "No cities recorded yet." << endl;
-            return;
-        }
-        
-        cout << "\nBudgets Adjacency Matrix (in billion RWF):\n";
-        cout << fixed << setprecision(1);
-        cout << "    ";
-        for (const auto& city : cities) {
-            cout << setw(8) << city.index;
-        }
-        cout << endl;
-        
-        for (size_t i = 0; i < budgetMatrix.size(); ++i) {
-            cout << setw(4) << cities[i].index;
-            for (size_t j = 0; j < budgetMatrix[i].size(); ++j) {
-                cout << setw(8) << budgetMatrix[i][j];
-            }
-            cout << endl;
-        }
-    }
-    
-    /**
-     * Displays all data (cities, roads, and budgets)
-     */
-    void displayAllData() {
-        displayCities();
-        displayRoads();
-        displayBudgets();
+/**
+ * Shows the roads as neighbor lists or as a sorted edge list
+ * @param rwanda The infrastructure system to display
+ */
+void browseRoadLists(RwandaInfrastructure& rwanda) {
+    int mode = getValidIntInput("Show (1) neighbors per city, (2) edge list by city or (3) edge list by budget: ");
+    if (mode < 1 || mode > 3) {
+        cout << "Invalid selection." << endl;
+        return;
     }
     
-    /**
-     * Saves all data to text files (cities.txt and roads.txt)
-     * Creates well-formatted tables with proper column alignment
-     */
-    void saveToFiles() {
-        // Get absolute paths for files
-        string cityFilePath = getAbsolutePath("cities.txt");
-        string roadFilePath = getAbsolutePath("roads.txt");
-        
-        // Save cities to cities.txt
-        ofstream cityFile(cityFilePath);
-        if (!cityFile.is_open()) {
-            cerr << "Error: Could not open cities.txt for writing!" << endl;
-            return;
-        }
-        
-        // Write header with proper spacing
-        cityFile << left << setw(8) << "Index" << setw(20) << "City_Name" << endl;
-        // Write city data
-        for (const auto& city : cities) {
-            cityFile << left << setw(8) << city.index << setw(20) << city.name << endl;
-        }
-        cityFile.close();
-        
-        // Save roads to roads.txt
-        ofstream roadFile(roadFilePath);
-        if (!roadFile.is_open()) {
-            cerr << "Error: Could not open roads.txt for writing!" << endl;
-            return;
-        }
-        
-        // Write header with proper spacing
-        roadFile << left << setw(5) << "Nbr" << setw(25) << "Road" << setw(10) << "Budget" << endl;
-        int counter = 1;
-        for (size_t i = 0; i < roadMatrix.size(); ++i) {
-            for (size_t j = i + 1; j < roadMatrix[i].size(); ++j) {
-                if (roadMatrix[i][j] == 1) {
-                    string roadName = cities[i].name + "-" + cities[j].name;
-                    roadFile << left << setw(5) << (to_string(counter++) + ".")
-                           << setw(25) << roadName
-                           << setw(10) << budgetMatrix[i][j] << endl;
-                }
-            }
-        }
-        roadFile.close();
-    }
+    RoadFilter filter;
+    filter.minBudget = getValidBudgetInput("Enter the minimum budget (0 for all): ");
+    filter.cityPrefix = getOptionalStringInput("Enter a city name prefix (empty for all): ");
     
-    /**
-     * Loads initial data for Rwanda's infrastructure
-     * Creates cities and roads with predefined budget allocations
-     */
-    void loadInitialData() {
-        // Add the 7 initial cities
-        vector<string> initialCities = {
-            "Kigali", "Huye", "Muhanga", "Musanze", 
-            "Nyagatare", "Rubavu", "Rusizi"
-        };
-        
-        for (const auto& city : initialCities) {
-            addCity(city);
-        }
-        
-        // Add the initial roads with budgets
-        vector<tuple<string, string, double>> initialRoads = {
-            {"Kigali", "Muhanga", 28.6},
-            {"Kigali", "Musanze", 28.6},
-            {"Kigali", "Nyagatare", 70.84},
-            {"Muhanga", "Huye", 56.7},
-            {"Musanze", "Rubavu", 33.7},
-            {"Huye", "Rusizi", 80.96},
-            {"Muhanga", "Rusizi", 117.5},
-            {"Musanze", "Nyagatare", 96.14},
-            {"Muhanga", "Musanze", 66.3}
-        };
-        
-        for (const auto& road : initialRoads) {
-            addRoad(get<0>(road), get<1>(road));
-            addBudget(get<0>(road), get<1>(road), get<2>(road));
-        }
-        
-        // Save to files after initial data is loaded
-        saveToFiles();
+    if (mode == 1) {
+        rwanda.displayNeighbors(filter);
+    } else {
+        rwanda.displayEdgeList(filter, mode == 3);
     }
-};
+}
 
 //====================================================================
 // MAIN FUNCTION
@@ -470,14 +278,49 @@ public:
 /**
  * Main function - Entry point of the program
  * Initializes the infrastructure system 
+ * Setting RWANDA_TRACE=<file> records a trace of the whole session
+ * Setting RWANDA_UNDO_LIMIT=<bytes> caps the memory of the undo journal
+ * Setting RWANDA_HUGE_PAGES=standard|thp|explicit and
+ * RWANDA_NUMA=first-touch|interleave place the large graph arrays
  */
 int main() {
+    const char* tracePath = getenv("RWANDA_TRACE");
+    if (tracePath != nullptr && *tracePath != '\0') {
+        startTracing();
+    }
+    
+    // Set before the first graph array is allocated
+    GraphMemoryOptions memoryOptions;
+    const char* hugePages = getenv("RWANDA_HUGE_PAGES");
+    if (hugePages != nullptr && *hugePages != '\0' && !parsePageMode(hugePages, memoryOptions.pages)) {
+        cerr << "Ignoring RWANDA_HUGE_PAGES=" << hugePages << "; expected standard, thp or explicit." << endl;
+    }
+    const char* numa = getenv("RWANDA_NUMA");
+    if (numa != nullptr && *numa != '\0' && !parseNodePlacement(numa, memoryOptions.placement)) {
+        cerr << "Ignoring RWANDA_NUMA=" << numa << "; expected first-touch or interleave." << endl;
+    }
+    setGraphMemoryOptions(memoryOptions);
+    
     // Create and initialize the Rwanda infrastructure system
     RwandaInfrastructure rwanda;
     rwanda.loadInitialData();
     
+    const char* undoLimit = getenv("RWANDA_UNDO_LIMIT");
+    if (undoLimit != nullptr && *undoLimit != '\0') {
+        // Only plain digits; strtoull alone would turn text into 0 and
+        // wrap negative numbers
+        char* end = nullptr;
+        errno = 0;
+        unsigned long long bytes = strtoull(undoLimit, &end, 10);
+        if (!isdigit(static_cast<unsigned char>(undoLimit[0])) || *end != '\0' || errno == ERANGE ||
+            bytes > numeric_limits<size_t>::max()) {
+            cerr << "Ignoring RWANDA_UNDO_LIMIT=" << undoLimit << "; expected a number of bytes." << endl;
+        } else {
+            rwanda.setUndoLimit(static_cast<size_t>(bytes));
+        }
+    }
+    
     int choice;
-    bool validInput;
     
     do {
         // Display the main menu
@@ -491,6 +334,30 @@ int main() {
         cout << "7. Display roads\n";
         cout << "8. Display recorded data on the console\n";
         cout << "9. Exit\n";
+        cout << "10. Display road lists\n";
+        cout << "11. Show operation metrics\n";
+        cout << "12. Show memory report\n";
+        cout << "13. " << (tracingActive() ? "Stop trace recording" : "Start trace recording") << "\n";
+        cout << "14. Assign a city to a district\n";
+        cout << "15. Show regional report\n";
+        cout << "16. Set road attributes\n";
+        cout << "17. Find roads by surface and condition\n";
+        cout << "18. Add a fiscal-year road budget\n";
+        cout << "19. Show budget history\n";
+        cout << "20. Query roads\n";
+        cout << "21. Undo last edit\n";
+        cout << "22. Redo\n";
+        cout << "23. Save a snapshot\n";
+        cout << "24. Compare with a snapshot\n";
+        cout << "25. Set city coordinates\n";
+        cout << "26. Find the nearest cities\n";
+        cout << "27. Find cities in an area\n";
+        cout << "28. Find cities by approximate name\n";
+        cout << "29. Add a one-way road\n";
+        cout << "30. Find the cheapest route\n";
+        cout << "31. Show budget summary\n";
+        cout << "32. Reorder road storage\n";
+        cout << "33. Browse matrix window\n";
         
         choice = getValidIntInput("Enter your choice: ");
         
@@ -525,10 +392,20 @@ int main() {
                     break;
                 }
                 
-                string city1 = getValidStringInput("Enter the name of the first city: ");
-                string city2 = getValidStringInput("Enter the name of the second city: ");
+                string city1 = getCityNameInput(rwanda, "Enter the name of the first city: ");
+                string city2 = getCityNameInput(rwanda, "Enter the name of the second city: ");
                 
-                if (rwanda.addRoad(city1, city2)) {
+                // A second road between the same cities is added on request
+                bool parallel = false;
+                if (!rwanda.roadIdsBetween(city1, city2).empty()) {
+                    rwanda.displayRoadsBetween(city1, city2);
+                    parallel = getValidIntInput("Add another road between them? (1 = yes, 0 = no): ") == 1;
+                    if (!parallel) {
+                        break;
+                    }
+                }
+                
+                if (rwanda.addRoad(city1, city2, parallel)) {
                     rwanda.saveToFiles(); // Save after road is added
                 }
                 break;
@@ -540,11 +417,12 @@ int main() {
                     break;
                 }
                 
-                string city1 = getValidStringInput("Enter the name of the first city: ");
-                string city2 = getValidStringInput("Enter the name of the second city: ");
-                double budget = getValidDoubleInput("Enter the budget for the road (in billion RWF): ");
+                string city1 = getCityNameInput(rwanda, "Enter the name of the first city: ");
+                string city2 = getCityNameInput(rwanda, "Enter the name of the second city: ");
+                int roadNumber = getRoadNumberInput(rwanda, city1, city2);
+                Budget budget = getValidBudgetInput("Enter the budget for the road (in billion RWF): ");
                 
-                if (rwanda.addBudget(city1, city2, budget)) {
+                if (rwanda.addBudget(city1, city2, budget, roadNumber)) {
                     rwanda.saveToFiles(); // Save after budget is added
                 }
                 break;
@@ -556,7 +434,7 @@ int main() {
                     break;
                 }
                 
-                string oldName = getValidStringInput("Enter the current city name: ");
+                string oldName = getCityNameInput(rwanda, "Enter the current city name: ");
                 string newName = getValidStringInput("Enter the new city name: ");
                 
                 if (rwanda.editCity(oldName, newName)) {
@@ -591,10 +469,236 @@ int main() {
                 // Exit the program
                 cout << "Exiting program.\n";
                 break;
+            case 10:
+                // List roads without printing the matrices
+                if (!rwanda.hasCities()) {
+                    cout << "No cities exist yet. Add cities first." << endl;
+                    break;
+                }
+                browseRoadLists(rwanda);
+                break;
+            case 11:
+                // Show operation counts and latency percentiles
+                printMetricsReport(cout);
+                break;
+            case 12: {
+                // Show memory usage and predict larger networks
+                printMemoryReport(rwanda, cout);
+                printMemoryPrediction(rwanda.cityCount(), rwanda.roadCount(), rwanda.pairCount(), cout);
+                
+                int cityTarget = getValidIntInput("\nEnter a city count to size for (0 to skip): ");
+                if (cityTarget > 0) {
+                    int roadTarget = getValidIntInput("Enter the expected road count: ");
+                    // A planned network is taken to have no parallel roads
+                    printMemoryPrediction(cityTarget, max(roadTarget, 0), max(roadTarget, 0), cout);
+                }
+                break;
+            }
+            case 13: {
+                // Record a timeline of the following operations
+                if (!tracingAvailable()) {
+                    cout << "Tracing is disabled in this build (RWANDA_ENABLE_TRACING is off)." << endl;
+                    break;
+                }
+                if (!tracingActive()) {
+                    startTracing();
+                    cout << "Trace recording started." << endl;
+                    break;
+                }
+                
+                stopTracing();
+                string path = getOptionalStringInput("Enter the trace file name (empty for trace.json): ");
+                if (path.empty()) {
+                    path = "trace.json";
+                }
+                if (writeChromeTrace(path)) {
+                    cout << "Trace written to " << path << ". Open it in ui.perfetto.dev or chrome://tracing." << endl;
+                }
+                break;
+            }
+            case 14: {
+                // Place a city in the province/district hierarchy
+                string cityName = getCityNameInput(rwanda, "Enter the city name: ");
+                string districtName = getValidStringInput("Enter the district name: ");
+                rwanda.assignDistrict(cityName, districtName);
+                break;
+            }
+            case 15:
+                // Totals per province and district
+                rwanda.displayRegionReport();
+                break;
+            case 16: {
+                // Record length, surface, lanes and condition of a road
+                string city1 = getCityNameInput(rwanda, "Enter the first city name: ");
+                string city2 = getCityNameInput(rwanda, "Enter the second city name: ");
+                int roadNumber = getRoadNumberInput(rwanda, city1, city2);
+                RoadAttributes values;
+                values.lengthKm = getValidDoubleInput("Enter the length in km: ");
+                values.surface = getValidStringInput("Enter the surface (asphalt, concrete, gravel, earth, ...): ");
+                values.lanes = getValidIntInput("Enter the number of lanes: ");
+                values.condition = getValidIntInput("Enter the condition score (1-5, 0 if not rated): ");
+                rwanda.setRoadAttributes(city1, city2, values, roadNumber);
+                break;
+            }
+            case 17: {
+                // Scan the surface and condition columns
+                string surface = getValidStringInput("Enter the surface: ");
+                int conditionBelow = getValidIntInput("List roads rated below (0 for all): ");
+                rwanda.displayRoadsBySurface(surface, conditionBelow);
+                break;
+            }
+            case 18: {
+                // Record one year of a road's budget time series
+                string city1 = getCityNameInput(rwanda, "Enter the first city name: ");
+                string city2 = getCityNameInput(rwanda, "Enter the second city name: ");
+                int roadNumber = getRoadNumberInput(rwanda, city1, city2);
+                int year = getValidIntInput("Enter the fiscal year: ");
+                Budget budget = getValidBudgetInput("Enter the budget for that year (in billion RWF): ");
+                rwanda.addYearBudget(city1, city2, year, budget, roadNumber);
+                break;
+            }
+            case 19: {
+                // Yearly totals, then optionally the per-road changes of one year
+                rwanda.displayBudgetHistory();
+                if (rwanda.budgetTimeSeries().yearCount() == 0) {
+                    break;
+                }
+                int year = getValidIntInput("\nEnter a year to list per-road changes (0 to skip): ");
+                if (year != 0) {
+                    rwanda.displayYearOverYear(year);
+                }
+                break;
+            }
+            case 20: {
+                // Ad-hoc filters and aggregates over the roads
+                cout << "Query syntax:\n" << roadQueryHelp();
+                string text = getValidStringInput("Enter the query: ");
+                rwanda.runRoadQuery(text);
+                break;
+            }
+            case 21:
+                // Reverse the last city, road, budget or rename edit
+                if (rwanda.undo()) {
+                    rwanda.saveToFiles(); // Save after undo
+                }
+                break;
+            case 22:
+                // Re-apply the last undone edit
+                if (rwanda.redo()) {
+                    rwanda.saveToFiles(); // Save after redo
+                }
+                break;
+            case 23: {
+                // Copy the current network to another directory
+                string directory = getValidStringInput("Enter the snapshot directory: ");
+                if (writeSnapshot(rwanda.snapshot(), directory)) {
+                    cout << "Snapshot saved to " << directory << "." << endl;
+                }
+                break;
+            }
+            case 24: {
+                // Changes from a saved snapshot to the current network
+                string directory = getValidStringInput("Enter the snapshot directory: ");
+                NetworkSnapshot saved;
+                if (readSnapshot(directory, saved)) {
+                    NetworkSnapshot current = rwanda.snapshot();
+                    printChanges(saved, current, diffSnapshots(saved, current), cout);
+                }
+                break;
+            }
+            case 25: {
+                // GPS coordinates for the spatial index
+                string cityName = getCityNameInput(rwanda, "Enter the city name: ");
+                GeoPoint point;
+                point.latitude = getValidCoordinateInput("Enter the latitude (negative for south): ");
+                point.longitude = getValidCoordinateInput("Enter the longitude (negative for west): ");
+                rwanda.setCityLocation(cityName, point);
+                break;
+            }
+            case 26: {
+                // k nearest cities to a GPS point
+                GeoPoint point;
+                point.latitude = getValidCoordinateInput("Enter the latitude: ");
+                point.longitude = getValidCoordinateInput("Enter the longitude: ");
+                int count = getValidIntInput("Enter the number of cities to list: ");
+                rwanda.displayNearestCities(point, count);
+                break;
+            }
+            case 27: {
+                // Cities inside a bounding box
+                GeoBox area;
+                area.south = getValidCoordinateInput("Enter the southern latitude: ");
+                area.north = getValidCoordinateInput("Enter the northern latitude: ");
+                area.west = getValidCoordinateInput("Enter the western longitude: ");
+                area.east = getValidCoordinateInput("Enter the eastern longitude: ");
+                rwanda.displayCitiesInArea(area);
+                break;
+            }
+            case 28: {
+                // Ranked fuzzy matches, tolerant of case and typos
+                string name = getValidStringInput("Enter the name to look for: ");
+                rwanda.displaySimilarCities(name);
+                break;
+            }
+            case 29: {
+                // A road travelled only from the first city to the second
+                string city1 = getCityNameInput(rwanda, "Enter the city the road leaves from: ");
+                string city2 = getCityNameInput(rwanda, "Enter the city the road leads to: ");
+                
+                bool parallel = false;
+                if (!rwanda.roadIdsBetween(city1, city2).empty()) {
+                    rwanda.displayRoadsBetween(city1, city2);
+                    parallel = getValidIntInput("Add another road between them? (1 = yes, 0 = no): ") == 1;
+                    if (!parallel) {
+                        break;
+                    }
+                }
+                
+                if (rwanda.addRoad(city1, city2, parallel, true)) {
+                    rwanda.saveToFiles();
+                }
+                break;
+            }
+            case 30: {
+                // Bidirectional search over the directed roads
+                string from = getCityNameInput(rwanda, "Enter the starting city: ");
+                string to = getCityNameInput(rwanda, "Enter the destination city: ");
+                rwanda.displayCheapestRoute(from, to);
+                break;
+            }
+            case 31: {
+                // Vectorized scans of the budget matrix rows
+                Budget threshold = getValidBudgetInput("Count connections with a budget of at least: ");
+                rwanda.displayBudgetSummary(threshold);
+                break;
+            }
+            case 32: {
+                // Permute the storage rows, keeping city indices
+                int mode = getValidIntInput("Order rows by (1) reverse Cuthill-McKee or (2) insertion: ");
+                if (mode < 1 || mode > 2) {
+                    cout << "Invalid selection." << endl;
+                    break;
+                }
+                rwanda.reorderRoadStorage(mode == 1 ? CityOrder::ReverseCuthillMcKee : CityOrder::Insertion);
+                break;
+            }
+            case 33:
+                // Page through a block of the matrices
+                if (!rwanda.hasCities()) {
+                    cout << "No cities exist yet. Add cities first." << endl;
+                    break;
+                }
+                browseMatrixWindow(rwanda);
+                break;
             default:
-                cout << "Invalid choice. Please enter a number between 1 and 9.\n";
+                cout << "Invalid choice. Please enter a number between 1 and 33.\n";
         }
     } while (choice != 9);
     
+    if (tracePath != nullptr && *tracePath != '\0') {
+        stopTracing();
+        writeChromeTrace(tracePath);
+    }
+    
     return 0;
 }
\ No newline at end of file
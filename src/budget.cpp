@@ -0,0 +1,67 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - budget amounts
+ *
+ * Implements the exact decimal conversions.
+ *****************************************************************/
+
+#include "budget.h"
+
+#include <limits>
+
+using namespace std;
+
+bool parseBudget(const string& text, Budget& budget) {
+    size_t first = text.find_first_not_of(" \t\r\n");
+    size_t last = text.find_last_not_of(" \t\r\n");
+    if (first == string::npos) {
+        return false;
+    }
+
+    const Budget limit = numeric_limits<Budget>::max();
+    Budget billions = 0;
+    Budget fraction = 0;
+    int wholeDigits = 0;
+    int decimals = 0;
+    size_t i = first;
+    for (; i <= last && text[i] >= '0' && text[i] <= '9'; ++i) {
+        int digit = text[i] - '0';
+        if (billions > (limit - digit) / 10) {
+            return false;
+        }
+        billions = billions * 10 + digit;
+        wholeDigits++;
+    }
+    if (i <= last && text[i] == '.') {
+        for (++i; i <= last && text[i] >= '0' && text[i] <= '9'; ++i) {
+            if (++decimals > BUDGET_DECIMALS) {
+                return false;
+            }
+            fraction = fraction * 10 + (text[i] - '0');
+        }
+    }
+    if (i <= last || wholeDigits + decimals == 0) {
+        return false;
+    }
+    for (int d = decimals; d < BUDGET_DECIMALS; ++d) {
+        fraction *= 10;
+    }
+    if (billions > (limit - fraction) / BUDGET_PER_BILLION) {
+        return false;
+    }
+    budget = billions * BUDGET_PER_BILLION + fraction;
+    return true;
+}
+
+string formatBudget(Budget budget) {
+    // Work with the magnitude as unsigned so the most negative value
+    // does not overflow
+    uint64_t magnitude = budget < 0 ? 0 - static_cast<uint64_t>(budget) : static_cast<uint64_t>(budget);
+    string text = budget < 0 ? "-" : "";
+    text += to_string(magnitude / BUDGET_PER_BILLION);
+    string decimals = to_string(magnitude % BUDGET_PER_BILLION);
+    decimals.insert(0, BUDGET_DECIMALS - decimals.size(), '0');
+    size_t kept = decimals.find_last_not_of('0');
+    text += '.';
+    text += kept == string::npos ? "0" : decimals.substr(0, kept + 1);
+    return text;
+}
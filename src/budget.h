@@ -0,0 +1,51 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - budget amounts
+ *
+ * Road budgets are fixed-point integers counting thousands of RWF,
+ * so 28.6 billion RWF is stored as 28600000. Amounts are typed,
+ * saved and shown in billions with up to six decimals; the text is
+ * converted digit by digit and never passes through a double, so
+ * the stored amount is exactly the one entered or read from a file
+ * and any sum of budgets is exact. Sums and other reductions over
+ * many budgets are in budget_kernels.h.
+ *****************************************************************/
+
+#ifndef RWANDA_BUDGET_H
+#define RWANDA_BUDGET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * A budget in thousands of RWF
+ */
+using Budget = int64_t;
+
+constexpr Budget BUDGET_PER_BILLION = 1000000;     // Thousands of RWF in a billion
+constexpr int BUDGET_DECIMALS = 6;                  // Decimals of a billion that are kept
+
+/**
+ * The budget nearest to an amount in billions, for amounts that are
+ * computed (seed tables, generated networks) rather than typed
+ */
+constexpr Budget budgetFromBillions(double billions) {
+    return billions < 0 ? -static_cast<Budget>(-billions * BUDGET_PER_BILLION + 0.5)
+                        : static_cast<Budget>(billions * BUDGET_PER_BILLION + 0.5);
+}
+
+/**
+ * Parses a non-negative amount in billions, such as "28.6" or
+ * "117", with at most BUDGET_DECIMALS decimals
+ * Surrounding blanks are ignored
+ * @return False if the text is not such an amount or is too large
+ */
+bool parseBudget(const std::string& text, Budget& budget);
+
+/**
+ * The amount in billions with every significant decimal and at
+ * least one, such as "28.6", "70.84" or "0.0"
+ */
+std::string formatBudget(Budget budget);
+
+#endif // RWANDA_BUDGET_H
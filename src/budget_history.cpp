@@ -0,0 +1,312 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - budget history
+ *
+ * Implements the delta-encoded year columns and the running-sum
+ * kernels over them.
+ *****************************************************************/
+
+#include "budget_history.h"
+#include "budget_kernels.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+using DeltaColumn = BudgetTimeSeries::DeltaColumn;
+
+/**
+ * Narrowest width, in bytes, that holds a change
+ */
+int widthFor(Budget delta) {
+    if (delta >= numeric_limits<int8_t>::min() && delta <= numeric_limits<int8_t>::max()) {
+        return 1;
+    }
+    if (delta >= numeric_limits<int16_t>::min() && delta <= numeric_limits<int16_t>::max()) {
+        return 2;
+    }
+    if (delta >= numeric_limits<int32_t>::min() && delta <= numeric_limits<int32_t>::max()) {
+        return 4;
+    }
+    return 8;
+}
+
+Budget readDelta(const DeltaColumn& column, size_t road) {
+    const uint8_t* at = column.bytes.data() + road * column.width;
+    switch (column.width) {
+        case 1: { int8_t v; memcpy(&v, at, 1); return v; }
+        case 2: { int16_t v; memcpy(&v, at, 2); return v; }
+        case 4: { int32_t v; memcpy(&v, at, 4); return v; }
+        default: { int64_t v; memcpy(&v, at, 8); return v; }
+    }
+}
+
+void writeDelta(DeltaColumn& column, size_t road, Budget delta) {
+    uint8_t* at = column.bytes.data() + road * column.width;
+    switch (column.width) {
+        case 1: { int8_t v = static_cast<int8_t>(delta); memcpy(at, &v, 1); break; }
+        case 2: { int16_t v = static_cast<int16_t>(delta); memcpy(at, &v, 2); break; }
+        case 4: { int32_t v = static_cast<int32_t>(delta); memcpy(at, &v, 4); break; }
+        default: { int64_t v = delta; memcpy(at, &v, 8); break; }
+    }
+}
+
+/**
+ * Encodes changes with the narrowest width that fits all of them
+ */
+DeltaColumn encodeColumn(const vector<Budget>& deltas) {
+    DeltaColumn column;
+    for (Budget delta : deltas) {
+        column.width = max(column.width, widthFor(delta));
+    }
+    column.bytes.resize(deltas.size() * column.width);
+    for (size_t road = 0; road < deltas.size(); ++road) {
+        writeDelta(column, road, deltas[road]);
+    }
+    return column;
+}
+
+//--------------------------------------------------------------------
+// Kernels
+//--------------------------------------------------------------------
+
+#if defined(__SSE2__)
+/**
+ * values[0..3] += the four 32-bit lanes of d, sign-extended
+ */
+inline void addLanes(__m128i d, Budget* values) {
+    __m128i sign = _mm_srai_epi32(d, 31);
+    __m128i* v = reinterpret_cast<__m128i*>(values);
+    _mm_storeu_si128(v, _mm_add_epi64(_mm_loadu_si128(v), _mm_unpacklo_epi32(d, sign)));
+    _mm_storeu_si128(v + 1, _mm_add_epi64(_mm_loadu_si128(v + 1), _mm_unpackhi_epi32(d, sign)));
+}
+#endif
+
+/**
+ * values[i] += column[i] for every road
+ */
+void accumulateColumn(const DeltaColumn& column, Budget* values, size_t n) {
+    const uint8_t* bytes = column.bytes.data();
+    size_t i = 0;
+#if defined(__SSE2__)
+    if (column.width == 8) {
+        for (; i + 2 <= n; i += 2) {
+            __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + 8 * i));
+            __m128i* v = reinterpret_cast<__m128i*>(values + i);
+            _mm_storeu_si128(v, _mm_add_epi64(_mm_loadu_si128(v), d));
+        }
+    } else if (column.width == 4) {
+        for (; i + 4 <= n; i += 4) {
+            addLanes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + 4 * i)), values + i);
+        }
+    } else if (column.width == 2) {
+        for (; i + 8 <= n; i += 8) {
+            __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + 2 * i));
+            // Sign-extend by placing each 16-bit change in the top half of a lane
+            addLanes(_mm_srai_epi32(_mm_unpacklo_epi16(d, d), 16), values + i);
+            addLanes(_mm_srai_epi32(_mm_unpackhi_epi16(d, d), 16), values + i + 4);
+        }
+    } else {
+        for (; i + 16 <= n; i += 16) {
+            __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+            __m128i w0 = _mm_srai_epi16(_mm_unpacklo_epi8(d, d), 8);
+            __m128i w1 = _mm_srai_epi16(_mm_unpackhi_epi8(d, d), 8);
+            addLanes(_mm_srai_epi32(_mm_unpacklo_epi16(w0, w0), 16), values + i);
+            addLanes(_mm_srai_epi32(_mm_unpackhi_epi16(w0, w0), 16), values + i + 4);
+            addLanes(_mm_srai_epi32(_mm_unpacklo_epi16(w1, w1), 16), values + i + 8);
+            addLanes(_mm_srai_epi32(_mm_unpackhi_epi16(w1, w1), 16), values + i + 12);
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        values[i] += readDelta(column, i);
+    }
+}
+
+/**
+ * totals[i] += values[i] for every road
+ */
+void addToTotals(const Budget* values, Budget* totals, size_t n) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 2 <= n; i += 2) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+        __m128i* t = reinterpret_cast<__m128i*>(totals + i);
+        _mm_storeu_si128(t, _mm_add_epi64(_mm_loadu_si128(t), v));
+    }
+#endif
+    for (; i < n; ++i) {
+        totals[i] += values[i];
+    }
+}
+
+} // namespace
+
+//====================================================================
+// BUDGET TIME SERIES
+//====================================================================
+
+BudgetTimeSeries::BudgetTimeSeries() : startYear(0), roads(0) {}
+
+Budget BudgetTimeSeries::deltaAt(int column, size_t road) const {
+    return readDelta(columns[column], road);
+}
+
+void BudgetTimeSeries::setDeltaAt(int column, size_t road, Budget delta) {
+    DeltaColumn& target = columns[column];
+    if (widthFor(delta) > target.width) {
+        // Re-encode the whole column at the wider width
+        vector<Budget> deltas(roads);
+        for (size_t r = 0; r < roads; ++r) {
+            deltas[r] = readDelta(target, r);
+        }
+        deltas[road] = delta;
+        target = encodeColumn(deltas);
+        return;
+    }
+    writeDelta(target, road, delta);
+}
+
+vector<Budget> BudgetTimeSeries::decodeValues(int column) const {
+    vector<Budget> values(roads, 0);
+    for (int c = 0; c <= column; ++c) {
+        accumulateColumn(columns[c], values.data(), roads);
+    }
+    return values;
+}
+
+void BudgetTimeSeries::coverYear(int year) {
+    DeltaColumn zeros;
+    zeros.bytes.assign(roads, 0);
+
+    if (columns.empty()) {
+        startYear = year;
+        columns.push_back(zeros);
+        return;
+    }
+    if (year < startYear) {
+        // The old first column holds absolute budgets, which are also
+        // their change from the new, empty years before it
+        columns.insert(columns.begin(), startYear - year, zeros);
+        startYear = year;
+        return;
+    }
+    if (year > lastYear()) {
+        // The first new year drops every budget back to zero
+        vector<Budget> drop = decodeValues(yearCount() - 1);
+        for (Budget& value : drop) {
+            value = -value;
+        }
+        int added = year - lastYear();
+        columns.push_back(encodeColumn(drop));
+        columns.insert(columns.end(), added - 1, zeros);
+    }
+}
+
+void BudgetTimeSeries::resize(size_t roadCount) {
+    for (DeltaColumn& column : columns) {
+        column.bytes.resize(roadCount * column.width, 0);
+    }
+    roads = roadCount;
+}
+
+bool BudgetTimeSeries::setBudget(size_t road, int year, Budget budget) {
+    if (year < MIN_YEAR || year > MAX_YEAR || budget < 0) {
+        return false;
+    }
+    if (road >= roads) {
+        resize(road + 1);
+    }
+    coverYear(year);
+
+    // Both budgets are non-negative, so their difference cannot overflow
+    int column = year - startYear;
+    Budget previous = 0;
+    for (int c = 0; c <= column; ++c) {
+        previous += deltaAt(c, road);
+    }
+    Budget change = budget - previous;
+    setDeltaAt(column, road, deltaAt(column, road) + change);
+    if (column + 1 < yearCount()) {
+        setDeltaAt(column + 1, road, deltaAt(column + 1, road) - change);
+    }
+    return true;
+}
+
+Budget BudgetTimeSeries::budget(size_t road, int year) const {
+    if (road >= roads || !hasYear(year)) {
+        return 0;
+    }
+    Budget value = 0;
+    for (int c = 0; c <= year - startYear; ++c) {
+        value += deltaAt(c, road);
+    }
+    return value;
+}
+
+vector<Budget> BudgetTimeSeries::yearBudgets(int year) const {
+    if (!hasYear(year)) {
+        return vector<Budget>(roads, 0);
+    }
+    return decodeValues(year - startYear);
+}
+
+vector<Budget> BudgetTimeSeries::yearOverYear(int year) const {
+    vector<Budget> changes(roads, 0);
+    if (hasYear(year)) {
+        accumulateColumn(columns[year - startYear], changes.data(), roads);
+    } else if (!columns.empty() && year == lastYear() + 1) {
+        changes = decodeValues(yearCount() - 1);
+        for (Budget& change : changes) {
+            change = -change;
+        }
+    }
+    return changes;
+}
+
+vector<Budget> BudgetTimeSeries::cumulativeBudgets(int year) const {
+    vector<Budget> totals(roads, 0);
+    if (columns.empty() || year < startYear) {
+        return totals;
+    }
+    vector<Budget> values(roads, 0);
+    int last = min(year, lastYear()) - startYear;
+    for (int c = 0; c <= last; ++c) {
+        accumulateColumn(columns[c], values.data(), roads);
+        addToTotals(values.data(), totals.data(), roads);
+    }
+    return totals;
+}
+
+vector<Budget> BudgetTimeSeries::yearTotals() const {
+    vector<Budget> totals;
+    vector<Budget> values(roads, 0);
+    for (const DeltaColumn& column : columns) {
+        accumulateColumn(column, values.data(), roads);
+        totals.push_back(sumBudgets(values.data(), roads));
+    }
+    return totals;
+}
+
+size_t BudgetTimeSeries::usedBytes() const {
+    size_t bytes = columns.size() * sizeof(DeltaColumn);
+    for (const DeltaColumn& column : columns) {
+        bytes += column.bytes.size();
+    }
+    return bytes;
+}
+
+size_t BudgetTimeSeries::capacityBytes() const {
+    size_t bytes = columns.capacity() * sizeof(DeltaColumn);
+    for (const DeltaColumn& column : columns) {
+        bytes += column.bytes.capacity();
+    }
+    return bytes;
+}
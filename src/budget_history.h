@@ -0,0 +1,119 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - budget history
+ *
+ * Budgets per road and fiscal year. Values are Budgets (whole
+ * thousands of RWF, see budget.h) and are stored year-major: one
+ * column per year, each holding every road's change from the
+ * previous year. Changes are mostly small, so each column uses the
+ * narrowest integer width (1, 2, 4 or 8 bytes) that fits its values.
+ *
+ * Year-over-year changes are the stored columns themselves; a
+ * year's budgets and the cumulative budgets are running sums over
+ * the columns, computed with SSE2 when available and a scalar
+ * loop otherwise.
+ *****************************************************************/
+
+#ifndef RWANDA_BUDGET_HISTORY_H
+#define RWANDA_BUDGET_HISTORY_H
+
+#include "budget.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//====================================================================
+// BUDGET TIME SERIES
+//====================================================================
+
+class BudgetTimeSeries {
+public:
+    static constexpr int MIN_YEAR = 1900;
+    static constexpr int MAX_YEAR = 2200;
+
+    /**
+     * One year of changes, encoded with a single width
+     */
+    struct DeltaColumn {
+        int width = 1;                                      // Bytes per road: 1, 2, 4 or 8
+        std::vector<uint8_t> bytes;
+    };
+
+private:
+    int startYear;
+    size_t roads;
+    std::vector<DeltaColumn> columns;                       // columns[y] = budgets of year y minus year y - 1
+
+    Budget deltaAt(int column, size_t road) const;
+    void setDeltaAt(int column, size_t road, Budget delta);
+    std::vector<Budget> decodeValues(int column) const;
+    void coverYear(int year);
+
+public:
+    BudgetTimeSeries();
+
+    int firstYear() const {
+        return startYear;
+    }
+
+    int lastYear() const {
+        return startYear + yearCount() - 1;
+    }
+
+    int yearCount() const {
+        return columns.size();
+    }
+
+    size_t roadCount() const {
+        return roads;
+    }
+
+    bool hasYear(int year) const {
+        return !columns.empty() && year >= startYear && year <= lastYear();
+    }
+
+    /**
+     * Adds roads (with no budget in any year) up to the given count,
+     * or drops the roads from the given count on
+     */
+    void resize(size_t roadCount);
+
+    /**
+     * Sets a road's budget for one year, adding years as needed
+     * Years that were never set have a budget of zero
+     * @return False if the year is out of range or the budget is
+     *         negative
+     */
+    bool setBudget(size_t road, int year, Budget budget);
+
+    /**
+     * Budget of one road in one year (0 if never set)
+     */
+    Budget budget(size_t road, int year) const;
+
+    /**
+     * Every road's budget in a year
+     */
+    std::vector<Budget> yearBudgets(int year) const;
+
+    /**
+     * Every road's change from the previous year
+     */
+    std::vector<Budget> yearOverYear(int year) const;
+
+    /**
+     * Every road's budgets summed from the first year through the
+     * given year
+     */
+    std::vector<Budget> cumulativeBudgets(int year) const;
+
+    /**
+     * Total budget of all roads in each year
+     */
+    std::vector<Budget> yearTotals() const;
+
+    size_t usedBytes() const;
+    size_t capacityBytes() const;
+};
+
+#endif // RWANDA_BUDGET_HISTORY_H
@@ -0,0 +1,423 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - budget kernels
+ *
+ * Implements the baseline, AVX2 and AVX-512 reductions and the
+ * table that dispatches between them. The vector loops handle
+ * whole registers and leave the last few budgets to the baseline.
+ *****************************************************************/
+
+#include "budget_kernels.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define RWANDA_X86_KERNELS 1
+#include <immintrin.h>
+#define RWANDA_TARGET_AVX2 __attribute__((target("avx2")))
+#define RWANDA_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+
+using namespace std;
+
+namespace {
+
+//--------------------------------------------------------------------
+// Baseline
+//--------------------------------------------------------------------
+
+Budget sumBaseline(const Budget* values, size_t count) {
+    Budget total = 0;
+    size_t i = 0;
+#if defined(__SSE2__)
+    // Four independent accumulators of two lanes hide the add latency
+    __m128i sums[4] = {_mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128()};
+    for (; i + 8 <= count; i += 8) {
+        const __m128i* block = reinterpret_cast<const __m128i*>(values + i);
+        for (int k = 0; k < 4; ++k) {
+            sums[k] = _mm_add_epi64(sums[k], _mm_loadu_si128(block + k));
+        }
+    }
+    __m128i sum = _mm_add_epi64(_mm_add_epi64(sums[0], sums[1]), _mm_add_epi64(sums[2], sums[3]));
+    int64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), sum);
+    total = lanes[0] + lanes[1];
+#endif
+    for (; i < count; ++i) {
+        total += values[i];
+    }
+    return total;
+}
+
+/**
+ * The value maxima start from: the first budget, or 0 when there are
+ * none, so negative budgets still reduce correctly
+ */
+Budget firstBudget(const Budget* values, size_t count) {
+    return count > 0 ? values[0] : 0;
+}
+
+Budget maxBaseline(const Budget* values, size_t count) {
+    Budget largest = firstBudget(values, count);
+    for (size_t i = 1; i < count; ++i) {
+        largest = max(largest, values[i]);
+    }
+    return largest;
+}
+
+size_t fundedBaseline(const Budget* values, size_t count) {
+    size_t funded = 0;
+    for (size_t i = 0; i < count; ++i) {
+        funded += values[i] != 0;
+    }
+    return funded;
+}
+
+size_t atLeastBaseline(const Budget* values, size_t count, Budget threshold) {
+    size_t atLeast = 0;
+    for (size_t i = 0; i < count; ++i) {
+        atLeast += values[i] >= threshold;
+    }
+    return atLeast;
+}
+
+BudgetSummary summarizeBaseline(const Budget* values, size_t count, Budget threshold) {
+    BudgetSummary summary = {0, firstBudget(values, count), 0, 0};
+    for (size_t i = 0; i < count; ++i) {
+        Budget value = values[i];
+        summary.total += value;
+        summary.max = max(summary.max, value);
+        summary.funded += value != 0;
+        summary.atLeast += value >= threshold;
+    }
+    return summary;
+}
+
+/**
+ * The larger of a vector loop's maximum and the budgets it left over
+ */
+Budget maxWithTail(Budget largest, const Budget* tail, size_t count) {
+    return count > 0 ? max(largest, maxBaseline(tail, count)) : largest;
+}
+
+/**
+ * Adds the summary of the budgets a vector loop left over
+ */
+BudgetSummary withTail(BudgetSummary summary, const Budget* tail, size_t count, Budget threshold) {
+    BudgetSummary rest = summarizeBaseline(tail, count, threshold);
+    summary.total += rest.total;
+    summary.max = count > 0 ? max(summary.max, rest.max) : summary.max;
+    summary.funded += rest.funded;
+    summary.atLeast += rest.atLeast;
+    return summary;
+}
+
+#if defined(RWANDA_X86_KERNELS)
+
+//--------------------------------------------------------------------
+// AVX2
+//--------------------------------------------------------------------
+
+// Counts are kept per lane by subtracting comparison masks, whose
+// true lanes are -1
+
+RWANDA_TARGET_AVX2 int64_t laneSum(__m256i v) {
+    alignas(32) int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), v);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+RWANDA_TARGET_AVX2 int64_t laneMax(__m256i v) {
+    alignas(32) int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), v);
+    return max(max(lanes[0], lanes[1]), max(lanes[2], lanes[3]));
+}
+
+RWANDA_TARGET_AVX2 __m256i laneMaxOf(__m256i a, __m256i b) {
+    return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(b, a));
+}
+
+RWANDA_TARGET_AVX2 Budget sumAvx2(const Budget* values, size_t count) {
+    __m256i sums[4] = {_mm256_setzero_si256(), _mm256_setzero_si256(),
+                       _mm256_setzero_si256(), _mm256_setzero_si256()};
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m256i* block = reinterpret_cast<const __m256i*>(values + i);
+        for (int k = 0; k < 4; ++k) {
+            sums[k] = _mm256_add_epi64(sums[k], _mm256_loadu_si256(block + k));
+        }
+    }
+    __m256i sum = _mm256_add_epi64(_mm256_add_epi64(sums[0], sums[1]), _mm256_add_epi64(sums[2], sums[3]));
+    return laneSum(sum) + sumBaseline(values + i, count - i);
+}
+
+RWANDA_TARGET_AVX2 Budget maxAvx2(const Budget* values, size_t count) {
+    const __m256i first = _mm256_set1_epi64x(firstBudget(values, count));
+    __m256i largest[2] = {first, first};
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i* block = reinterpret_cast<const __m256i*>(values + i);
+        largest[0] = laneMaxOf(largest[0], _mm256_loadu_si256(block));
+        largest[1] = laneMaxOf(largest[1], _mm256_loadu_si256(block + 1));
+    }
+    return maxWithTail(laneMax(laneMaxOf(largest[0], largest[1])), values + i, count - i);
+}
+
+RWANDA_TARGET_AVX2 size_t fundedAvx2(const Budget* values, size_t count) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i unfunded = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        unfunded = _mm256_sub_epi64(unfunded, _mm256_cmpeq_epi64(v, zero));
+    }
+    return i - laneSum(unfunded) + fundedBaseline(values + i, count - i);
+}
+
+RWANDA_TARGET_AVX2 size_t atLeastAvx2(const Budget* values, size_t count, Budget threshold) {
+    const __m256i limit = _mm256_set1_epi64x(threshold);
+    __m256i below = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        below = _mm256_sub_epi64(below, _mm256_cmpgt_epi64(limit, v));
+    }
+    return i - laneSum(below) + atLeastBaseline(values + i, count - i, threshold);
+}
+
+RWANDA_TARGET_AVX2 BudgetSummary summarizeAvx2(const Budget* values, size_t count, Budget threshold) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i limit = _mm256_set1_epi64x(threshold);
+    __m256i total = zero;
+    __m256i largest = _mm256_set1_epi64x(firstBudget(values, count));
+    __m256i unfunded = zero;
+    __m256i below = zero;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        total = _mm256_add_epi64(total, v);
+        largest = laneMaxOf(largest, v);
+        unfunded = _mm256_sub_epi64(unfunded, _mm256_cmpeq_epi64(v, zero));
+        below = _mm256_sub_epi64(below, _mm256_cmpgt_epi64(limit, v));
+    }
+    BudgetSummary summary = {laneSum(total), laneMax(largest), static_cast<size_t>(i - laneSum(unfunded)),
+                             static_cast<size_t>(i - laneSum(below))};
+    return withTail(summary, values + i, count - i, threshold);
+}
+
+//--------------------------------------------------------------------
+// AVX-512
+//--------------------------------------------------------------------
+
+// GCC 12 builds _mm512_max_epi64 and _mm512_reduce_* on an undefined
+// register and warns, so maxima use the masked form with every lane
+// selected and lanes are reduced through memory
+
+RWANDA_TARGET_AVX512 int64_t laneSum(__m512i v) {
+    alignas(64) int64_t lanes[8];
+    _mm512_store_si512(lanes, v);
+    int64_t total = 0;
+    for (int k = 0; k < 8; ++k) {
+        total += lanes[k];
+    }
+    return total;
+}
+
+RWANDA_TARGET_AVX512 int64_t laneMax(__m512i v) {
+    alignas(64) int64_t lanes[8];
+    _mm512_store_si512(lanes, v);
+    return *max_element(lanes, lanes + 8);
+}
+
+RWANDA_TARGET_AVX512 __m512i laneMaxOf(__m512i a, __m512i b) {
+    return _mm512_mask_max_epi64(a, 0xFF, a, b);
+}
+
+RWANDA_TARGET_AVX512 Budget sumAvx512(const Budget* values, size_t count) {
+    __m512i sums[4] = {_mm512_setzero_si512(), _mm512_setzero_si512(),
+                       _mm512_setzero_si512(), _mm512_setzero_si512()};
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        for (int k = 0; k < 4; ++k) {
+            sums[k] = _mm512_add_epi64(sums[k], _mm512_loadu_si512(values + i + 8 * k));
+        }
+    }
+    __m512i sum = _mm512_add_epi64(_mm512_add_epi64(sums[0], sums[1]), _mm512_add_epi64(sums[2], sums[3]));
+    return laneSum(sum) + sumBaseline(values + i, count - i);
+}
+
+RWANDA_TARGET_AVX512 Budget maxAvx512(const Budget* values, size_t count) {
+    const __m512i first = _mm512_set1_epi64(firstBudget(values, count));
+    __m512i largest[2] = {first, first};
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        largest[0] = laneMaxOf(largest[0], _mm512_loadu_si512(values + i));
+        largest[1] = laneMaxOf(largest[1], _mm512_loadu_si512(values + i + 8));
+    }
+    return maxWithTail(laneMax(laneMaxOf(largest[0], largest[1])), values + i, count - i);
+}
+
+RWANDA_TARGET_AVX512 size_t fundedAvx512(const Budget* values, size_t count) {
+    const __m512i one = _mm512_set1_epi64(1);
+    __m512i funded = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m512i v = _mm512_loadu_si512(values + i);
+        funded = _mm512_mask_add_epi64(funded, _mm512_test_epi64_mask(v, v), funded, one);
+    }
+    return laneSum(funded) + fundedBaseline(values + i, count - i);
+}
+
+RWANDA_TARGET_AVX512 size_t atLeastAvx512(const Budget* values, size_t count, Budget threshold) {
+    const __m512i one = _mm512_set1_epi64(1);
+    const __m512i limit = _mm512_set1_epi64(threshold);
+    __m512i atLeast = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m512i v = _mm512_loadu_si512(values + i);
+        atLeast = _mm512_mask_add_epi64(atLeast, _mm512_cmpge_epi64_mask(v, limit), atLeast, one);
+    }
+    return laneSum(atLeast) + atLeastBaseline(values + i, count - i, threshold);
+}
+
+RWANDA_TARGET_AVX512 BudgetSummary summarizeAvx512(const Budget* values, size_t count, Budget threshold) {
+    const __m512i one = _mm512_set1_epi64(1);
+    const __m512i limit = _mm512_set1_epi64(threshold);
+    __m512i total = _mm512_setzero_si512();
+    __m512i largest = _mm512_set1_epi64(firstBudget(values, count));
+    __m512i funded = _mm512_setzero_si512();
+    __m512i atLeast = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m512i v = _mm512_loadu_si512(values + i);
+        total = _mm512_add_epi64(total, v);
+        largest = laneMaxOf(largest, v);
+        funded = _mm512_mask_add_epi64(funded, _mm512_test_epi64_mask(v, v), funded, one);
+        atLeast = _mm512_mask_add_epi64(atLeast, _mm512_cmpge_epi64_mask(v, limit), atLeast, one);
+    }
+    BudgetSummary summary = {laneSum(total), laneMax(largest),
+                             static_cast<size_t>(laneSum(funded)),
+                             static_cast<size_t>(laneSum(atLeast))};
+    return withTail(summary, values + i, count - i, threshold);
+}
+
+#endif // RWANDA_X86_KERNELS
+
+//--------------------------------------------------------------------
+// Dispatch
+//--------------------------------------------------------------------
+
+struct KernelTable {
+    BudgetKernelLevel level;
+    Budget (*sum)(const Budget*, size_t);
+    Budget (*max)(const Budget*, size_t);
+    size_t (*funded)(const Budget*, size_t);
+    size_t (*atLeast)(const Budget*, size_t, Budget);
+    BudgetSummary (*summarize)(const Budget*, size_t, Budget);
+};
+
+const KernelTable BASELINE_KERNELS = {BudgetKernelLevel::Baseline, sumBaseline, maxBaseline,
+                                      fundedBaseline, atLeastBaseline, summarizeBaseline};
+#if defined(RWANDA_X86_KERNELS)
+const KernelTable AVX2_KERNELS = {BudgetKernelLevel::Avx2, sumAvx2, maxAvx2,
+                                  fundedAvx2, atLeastAvx2, summarizeAvx2};
+const KernelTable AVX512_KERNELS = {BudgetKernelLevel::Avx512, sumAvx512, maxAvx512,
+                                    fundedAvx512, atLeastAvx512, summarizeAvx512};
+#endif
+
+bool isSupported(BudgetKernelLevel level) {
+#if defined(RWANDA_X86_KERNELS)
+    __builtin_cpu_init();
+    switch (level) {
+        case BudgetKernelLevel::Baseline: return true;
+        case BudgetKernelLevel::Avx2:     return __builtin_cpu_supports("avx2");
+        case BudgetKernelLevel::Avx512:   return __builtin_cpu_supports("avx512f");
+    }
+    return false;
+#else
+    return level == BudgetKernelLevel::Baseline;
+#endif
+}
+
+const KernelTable& tableFor(BudgetKernelLevel level) {
+#if defined(RWANDA_X86_KERNELS)
+    switch (level) {
+        case BudgetKernelLevel::Avx512: return AVX512_KERNELS;
+        case BudgetKernelLevel::Avx2:   return AVX2_KERNELS;
+        case BudgetKernelLevel::Baseline: break;
+    }
+#else
+    (void)level;
+#endif
+    return BASELINE_KERNELS;
+}
+
+const KernelTable*& activeKernels() {
+    static const KernelTable* active = &tableFor(bestBudgetKernelLevel());
+    return active;
+}
+
+} // namespace
+
+//====================================================================
+// KERNELS
+//====================================================================
+
+Budget sumBudgets(const Budget* values, size_t count) {
+    return activeKernels()->sum(values, count);
+}
+
+Budget maxBudget(const Budget* values, size_t count) {
+    return activeKernels()->max(values, count);
+}
+
+size_t countFunded(const Budget* values, size_t count) {
+    return activeKernels()->funded(values, count);
+}
+
+size_t countAtLeast(const Budget* values, size_t count, Budget threshold) {
+    return activeKernels()->atLeast(values, count, threshold);
+}
+
+BudgetSummary summarizeBudgets(const Budget* values, size_t count, Budget threshold) {
+    return activeKernels()->summarize(values, count, threshold);
+}
+
+//====================================================================
+// DISPATCH
+//====================================================================
+
+BudgetKernelLevel bestBudgetKernelLevel() {
+    static const BudgetKernelLevel best = isSupported(BudgetKernelLevel::Avx512) ? BudgetKernelLevel::Avx512
+                                        : isSupported(BudgetKernelLevel::Avx2)   ? BudgetKernelLevel::Avx2
+                                                                                 : BudgetKernelLevel::Baseline;
+    return best;
+}
+
+BudgetKernelLevel budgetKernelLevel() {
+    return activeKernels()->level;
+}
+
+BudgetKernelLevel setBudgetKernelLevel(BudgetKernelLevel level) {
+    while (!isSupported(level)) {
+        level = static_cast<BudgetKernelLevel>(static_cast<int>(level) - 1);
+    }
+    activeKernels() = &tableFor(level);
+    return level;
+}
+
+const char* budgetKernelName(BudgetKernelLevel level) {
+    switch (level) {
+        case BudgetKernelLevel::Avx512: return "AVX-512";
+        case BudgetKernelLevel::Avx2:   return "AVX2";
+        case BudgetKernelLevel::Baseline: break;
+    }
+#if defined(__SSE2__)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,95 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - budget kernels
+ *
+ * Reductions over consecutive budgets, such as a row of the dense
+ * budget matrix: the sum, the largest budget, the number of funded
+ * (non-zero) budgets and the number at or above a threshold. A
+ * fused summary computes all four in a single pass, so scans of
+ * the whole matrix read memory once.
+ *
+ * Every kernel has a baseline version (SSE2 where the compiler
+ * targets it, plain C++ otherwise) and, on x86-64 with GCC or
+ * Clang, AVX2 and AVX-512 versions compiled with target
+ * attributes, so the build needs no extra flags. The widest level
+ * the processor supports is chosen on first use;
+ * setBudgetKernelLevel() selects a lower one for comparisons.
+ *****************************************************************/
+
+#ifndef RWANDA_BUDGET_KERNELS_H
+#define RWANDA_BUDGET_KERNELS_H
+
+#include "budget.h"
+
+#include <cstddef>
+
+//====================================================================
+// STRUCTURES
+//====================================================================
+
+enum class BudgetKernelLevel {
+    Baseline,           // SSE2 or scalar
+    Avx2,               // 256-bit lanes
+    Avx512              // 512-bit lanes (AVX-512F)
+};
+
+/**
+ * Statistics of a run of budgets
+ * max is 0 when there are none
+ */
+struct BudgetSummary {
+    Budget total;
+    Budget max;
+    size_t funded;      // Budgets above zero
+    size_t atLeast;     // Budgets at or above the threshold
+};
+
+//====================================================================
+// KERNELS
+//====================================================================
+
+Budget sumBudgets(const Budget* values, size_t count);
+
+/**
+ * The largest budget, or 0 when there are none
+ */
+Budget maxBudget(const Budget* values, size_t count);
+
+/**
+ * Number of budgets above zero
+ */
+size_t countFunded(const Budget* values, size_t count);
+
+/**
+ * Number of budgets at or above threshold
+ */
+size_t countAtLeast(const Budget* values, size_t count, Budget threshold);
+
+/**
+ * All four statistics in one pass
+ */
+BudgetSummary summarizeBudgets(const Budget* values, size_t count, Budget threshold);
+
+//====================================================================
+// DISPATCH
+//====================================================================
+
+/**
+ * The widest level this processor supports
+ */
+BudgetKernelLevel bestBudgetKernelLevel();
+
+/**
+ * The level the kernels currently run at
+ */
+BudgetKernelLevel budgetKernelLevel();
+
+/**
+ * Runs the kernels at a level, or at the widest supported level
+ * below it
+ * @return The level now in use
+ */
+BudgetKernelLevel setBudgetKernelLevel(BudgetKernelLevel level);
+
+const char* budgetKernelName(BudgetKernelLevel level);
+
+#endif // RWANDA_BUDGET_KERNELS_H
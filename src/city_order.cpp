@@ -0,0 +1,125 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - city orderings
+ *
+ * Implements the reverse Cuthill-McKee order (with the George-Liu
+ * search for a peripheral start) and the band measurements.
+ *****************************************************************/
+
+#include "city_order.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+
+using namespace std;
+
+namespace {
+
+int degreeOf(const vector<int>& offsets, int slot) {
+    return offsets[slot + 1] - offsets[slot];
+}
+
+/**
+ * A city at the far end of seed's component: starting at seed,
+ * moves to the lowest-degree city of the last breadth-first level
+ * for as long as that makes the search deeper
+ * @param depth Scratch array of -1 per slot, left as it was found
+ */
+int peripheralCity(int seed, const vector<int>& offsets, const vector<int>& neighbors,
+                   vector<int>& depth, vector<int>& queue) {
+    int start = seed;
+    int eccentricity = -1;
+    while (true) {
+        queue.assign(1, start);
+        depth[start] = 0;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            int i = queue[head];
+            for (int k = offsets[i]; k < offsets[i + 1]; ++k) {
+                if (depth[neighbors[k]] < 0) {
+                    depth[neighbors[k]] = depth[i] + 1;
+                    queue.push_back(neighbors[k]);
+                }
+            }
+        }
+
+        int reached = depth[queue.back()];
+        int next = queue.back();
+        for (auto it = queue.rbegin(); it != queue.rend() && depth[*it] == reached; ++it) {
+            if (degreeOf(offsets, *it) < degreeOf(offsets, next)) {
+                next = *it;
+            }
+        }
+        for (int i : queue) {
+            depth[i] = -1;
+        }
+
+        if (reached <= eccentricity) {
+            return start;
+        }
+        eccentricity = reached;
+        start = next;
+    }
+}
+
+} // namespace
+
+vector<int> reverseCuthillMcKee(const vector<int>& offsets, const vector<int>& neighbors) {
+    int n = static_cast<int>(offsets.size()) - 1;
+    auto byDegree = [&offsets](int a, int b) {
+        int da = degreeOf(offsets, a);
+        int db = degreeOf(offsets, b);
+        return da != db ? da < db : a < b;
+    };
+
+    // Components are started from their lowest-degree city
+    vector<int> seeds(n);
+    iota(seeds.begin(), seeds.end(), 0);
+    stable_sort(seeds.begin(), seeds.end(), byDegree);
+
+    vector<int> order;
+    order.reserve(n);
+    vector<char> placed(n, 0);
+    vector<int> depth(n, -1);
+    vector<int> queue;
+    for (int seed : seeds) {
+        if (placed[seed]) {
+            continue;
+        }
+        int start = peripheralCity(seed, offsets, neighbors, depth, queue);
+        size_t head = order.size();
+        order.push_back(start);
+        placed[start] = 1;
+        for (; head < order.size(); ++head) {
+            int i = order[head];
+            size_t first = order.size();
+            for (int k = offsets[i]; k < offsets[i + 1]; ++k) {
+                if (!placed[neighbors[k]]) {
+                    placed[neighbors[k]] = 1;
+                    order.push_back(neighbors[k]);
+                }
+            }
+            sort(order.begin() + first, order.end(), byDegree);
+        }
+    }
+
+    // Isolated cities were seeded first; reversing moves them to the end
+    reverse(order.begin(), order.end());
+    return order;
+}
+
+OrderSpread measureSpread(const vector<int>& offsets, const vector<int>& neighbors, const vector<int>& row) {
+    OrderSpread spread = {0, 0.0};
+    long long totalSpan = 0;
+    int n = static_cast<int>(offsets.size()) - 1;
+    for (int i = 0; i < n; ++i) {
+        for (int k = offsets[i]; k < offsets[i + 1]; ++k) {
+            int span = row.empty() ? abs(i - neighbors[k]) : abs(row[i] - row[neighbors[k]]);
+            spread.bandwidth = max(spread.bandwidth, span);
+            totalSpan += span;
+        }
+    }
+    if (!neighbors.empty()) {
+        spread.averageSpan = static_cast<double>(totalSpan) / neighbors.size();
+    }
+    return spread;
+}
@@ -0,0 +1,62 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - city orderings
+ *
+ * Orders in which to lay out city slots in the road storage so
+ * that connected cities sit in nearby rows. Slots are handed out
+ * in insertion order, which scatters neighboring cities across the
+ * matrix; the reverse Cuthill-McKee order numbers each component
+ * breadth-first from a peripheral city, visiting low-degree
+ * neighbors first, and reverses the result. Every road then joins
+ * rows that are close together (a narrow band around the
+ * diagonal), so traversals touch few cache lines and pages.
+ *
+ * The graph is given as compressed sparse rows of distinct
+ * neighbors: the neighbors of slot i are
+ * neighbors[offsets[i] .. offsets[i + 1]).
+ *****************************************************************/
+
+#ifndef RWANDA_CITY_ORDER_H
+#define RWANDA_CITY_ORDER_H
+
+#include <vector>
+
+//====================================================================
+// STRUCTURES
+//====================================================================
+
+/**
+ * Layouts of the city slots in the road storage
+ */
+enum class CityOrder {
+    Insertion,          // Row i holds slot i
+    ReverseCuthillMcKee // Band-minimizing breadth-first order
+};
+
+/**
+ * How far apart an order places connected cities
+ */
+struct OrderSpread {
+    int bandwidth;          // Largest row distance of a road
+    double averageSpan;     // Mean row distance of a road
+};
+
+//====================================================================
+// FUNCTIONS
+//====================================================================
+
+/**
+ * Reverse Cuthill-McKee order of all slots
+ * Each component starts from a pseudo-peripheral city found from
+ * its lowest-degree city; isolated cities end up at the end.
+ * @return order[r] is the slot placed in row r
+ */
+std::vector<int> reverseCuthillMcKee(const std::vector<int>& offsets, const std::vector<int>& neighbors);
+
+/**
+ * Measures the spread of the roads when slot i is placed in
+ * row[i]; an empty row vector stands for insertion order
+ */
+OrderSpread measureSpread(const std::vector<int>& offsets, const std::vector<int>& neighbors,
+                          const std::vector<int>& row);
+
+#endif // RWANDA_CITY_ORDER_H
@@ -0,0 +1,180 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - directed routing
+ *
+ * Implements the counting-sort build of the out- and in-arc arrays
+ * and the one- and two-sided Dijkstra searches over them.
+ *****************************************************************/
+
+#include "directed_graph.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+using namespace std;
+
+namespace {
+
+using Entry = pair<double, int>;
+using Frontier = priority_queue<Entry, vector<Entry>, greater<Entry>>;
+
+} // namespace
+
+void DirectedRoadGraph::build(int cityCount, const vector<Road>& roads) {
+    RWANDA_TRACE_SCOPE("DirectedRoadGraph::build", "import");
+    outOffsets.assign(cityCount + 1, 0);
+    inOffsets.assign(cityCount + 1, 0);
+    for (const Road& road : roads) {
+        int from = road.city1 - 1;
+        int to = road.city2 - 1;
+        outOffsets[from + 1]++;
+        inOffsets[to + 1]++;
+        if (!road.oneWay) {
+            outOffsets[to + 1]++;
+            inOffsets[from + 1]++;
+        }
+    }
+    for (int i = 0; i < cityCount; ++i) {
+        outOffsets[i + 1] += outOffsets[i];
+        inOffsets[i + 1] += inOffsets[i];
+    }
+
+    // Roads are placed in id order, so each row lists its arcs by road id
+    outArcs.resize(outOffsets.back());
+    inArcs.resize(inOffsets.back());
+    vector<int> nextOut(outOffsets.begin(), outOffsets.end() - 1);
+    vector<int> nextIn(inOffsets.begin(), inOffsets.end() - 1);
+    for (size_t id = 0; id < roads.size(); ++id) {
+        const Road& road = roads[id];
+        int from = road.city1 - 1;
+        int to = road.city2 - 1;
+        outArcs[nextOut[from]++] = {to, static_cast<int>(id), static_cast<double>(road.budget)};
+        inArcs[nextIn[to]++] = {from, static_cast<int>(id), static_cast<double>(road.budget)};
+        if (!road.oneWay) {
+            outArcs[nextOut[to]++] = {from, static_cast<int>(id), static_cast<double>(road.budget)};
+            inArcs[nextIn[from]++] = {to, static_cast<int>(id), static_cast<double>(road.budget)};
+        }
+    }
+}
+
+void DirectedRoadGraph::clear() {
+    outOffsets.assign(1, 0);
+    inOffsets.assign(1, 0);
+    outArcs.clear();
+    inArcs.clear();
+}
+
+vector<double> DirectedRoadGraph::costsFrom(int start, bool forward) const {
+    const vector<int>& offsets = forward ? outOffsets : inOffsets;
+    const vector<Arc>& arcs = forward ? outArcs : inArcs;
+    vector<double> cost(cityCount(), numeric_limits<double>::infinity());
+    Frontier frontier;
+    cost[start] = 0.0;
+    frontier.push({0.0, start});
+    while (!frontier.empty()) {
+        auto [reached, i] = frontier.top();
+        frontier.pop();
+        if (reached > cost[i]) {
+            continue;
+        }
+        for (int k = offsets[i]; k < offsets[i + 1]; ++k) {
+            double candidate = reached + arcs[k].cost;
+            if (candidate < cost[arcs[k].city]) {
+                cost[arcs[k].city] = candidate;
+                frontier.push({candidate, arcs[k].city});
+            }
+        }
+    }
+    return cost;
+}
+
+vector<double> DirectedRoadGraph::cheapestFrom(int source) const {
+    RWANDA_TRACE_SCOPE("cheapestFrom", "analytics");
+    return costsFrom(source, true);
+}
+
+vector<double> DirectedRoadGraph::cheapestTo(int target) const {
+    RWANDA_TRACE_SCOPE("cheapestTo", "analytics");
+    return costsFrom(target, false);
+}
+
+Route DirectedRoadGraph::cheapestRoute(int source, int target) const {
+    RWANDA_TRACE_SCOPE("cheapestRoute", "analytics");
+    const double infinity = numeric_limits<double>::infinity();
+    Route route = {infinity, {}, {}};
+    if (source == target) {
+        route.cost = 0.0;
+        route.cities.push_back(source);
+        return route;
+    }
+
+    // Side 0 searches forward from source, side 1 backward from target
+    int n = cityCount();
+    vector<double> cost[2] = {vector<double>(n, infinity), vector<double>(n, infinity)};
+    vector<int> previous[2] = {vector<int>(n, -1), vector<int>(n, -1)};
+    vector<int> viaRoad[2] = {vector<int>(n, -1), vector<int>(n, -1)};
+    Frontier frontier[2];
+    const vector<int>* offsets[2] = {&outOffsets, &inOffsets};
+    const vector<Arc>* arcs[2] = {&outArcs, &inArcs};
+    cost[0][source] = 0.0;
+    cost[1][target] = 0.0;
+    frontier[0].push({0.0, source});
+    frontier[1].push({0.0, target});
+
+    double best = infinity;
+    int meet = -1;
+    while (!frontier[0].empty() && !frontier[1].empty() &&
+           frontier[0].top().first + frontier[1].top().first < best) {
+        int side = frontier[0].top().first <= frontier[1].top().first ? 0 : 1;
+        auto [reached, i] = frontier[side].top();
+        frontier[side].pop();
+        if (reached > cost[side][i]) {
+            continue;
+        }
+        for (int k = (*offsets[side])[i]; k < (*offsets[side])[i + 1]; ++k) {
+            const Arc& arc = (*arcs[side])[k];
+            double candidate = reached + arc.cost;
+            if (candidate < cost[side][arc.city]) {
+                cost[side][arc.city] = candidate;
+                previous[side][arc.city] = i;
+                viaRoad[side][arc.city] = arc.road;
+                frontier[side].push({candidate, arc.city});
+            }
+            double through = cost[side][arc.city] + cost[1 - side][arc.city];
+            if (through < best) {
+                best = through;
+                meet = arc.city;
+            }
+        }
+    }
+    if (meet == -1) {
+        return route;
+    }
+
+    // Walk back from the meeting city to source, then on to target
+    route.cost = best;
+    for (int i = meet; i != source; i = previous[0][i]) {
+        route.cities.push_back(i);
+        route.roads.push_back(viaRoad[0][i]);
+    }
+    route.cities.push_back(source);
+    reverse(route.cities.begin(), route.cities.end());
+    reverse(route.roads.begin(), route.roads.end());
+    for (int i = meet; i != target; i = previous[1][i]) {
+        route.roads.push_back(viaRoad[1][i]);
+        route.cities.push_back(previous[1][i]);
+    }
+    return route;
+}
+
+size_t DirectedRoadGraph::usedBytes() const {
+    return (outOffsets.size() + inOffsets.size()) * sizeof(int) + (outArcs.size() + inArcs.size()) * sizeof(Arc);
+}
+
+size_t DirectedRoadGraph::capacityBytes() const {
+    return (outOffsets.capacity() + inOffsets.capacity()) * sizeof(int) +
+           (outArcs.capacity() + inArcs.capacity()) * sizeof(Arc);
+}
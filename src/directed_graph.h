@@ -0,0 +1,125 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - directed routing
+ *
+ * The roads as travelled: a two-way road gives an arc each way and
+ * a one-way road a single arc from its first city to its second.
+ * The arcs are kept twice, grouped by the city they leave (out-arcs,
+ * compressed sparse rows) and by the city they enter (in-arcs,
+ * compressed sparse columns), so a search walking the roads forward
+ * and one walking them backward both read each city's arcs as one
+ * contiguous block. The arrays are rebuilt from the edge list in
+ * O(cities + roads) with a counting sort.
+ *****************************************************************/
+
+#ifndef RWANDA_DIRECTED_GRAPH_H
+#define RWANDA_DIRECTED_GRAPH_H
+
+#include "graph_engine.h"
+
+#include <cstddef>
+#include <vector>
+
+//====================================================================
+// STRUCTURES
+//====================================================================
+
+/**
+ * A cheapest route between two cities
+ */
+struct Route {
+    double cost;                // Sum of the road budgets in thousands of RWF, infinity if unreachable
+    std::vector<int> cities;    // Slots from the start to the end, empty if unreachable
+    std::vector<int> roads;     // Ids of the roads between consecutive cities
+};
+
+//====================================================================
+// DIRECTED ROAD GRAPH
+//====================================================================
+
+class DirectedRoadGraph {
+public:
+    /**
+     * One arc: the city at its other end, its road and that road's
+     * budget (whole thousands of RWF, so path sums stay exact)
+     */
+    struct Arc {
+        int city;
+        int road;
+        double cost;
+    };
+
+private:
+    std::vector<int> outOffsets = std::vector<int>(1, 0);  // Out-arcs of slot i: [outOffsets[i], outOffsets[i + 1])
+    std::vector<Arc> outArcs;
+    std::vector<int> inOffsets = std::vector<int>(1, 0);   // In-arcs of slot i, the same arcs transposed
+    std::vector<Arc> inArcs;
+
+    /**
+     * Dijkstra over the out-arcs (forward) or the in-arcs (backward)
+     */
+    std::vector<double> costsFrom(int start, bool forward) const;
+
+public:
+    /**
+     * Replaces the arcs with those of the given roads
+     * @param roads Roads referring to cities by 1-based index
+     */
+    void build(int cityCount, const std::vector<Road>& roads);
+
+    void clear();
+
+    int cityCount() const {
+        return outOffsets.size() - 1;
+    }
+
+    size_t arcCount() const {
+        return outArcs.size();
+    }
+
+    /**
+     * Calls f(arc) for every arc leaving a slot
+     */
+    template <typename F>
+    void forEachOut(int slot, F&& f) const {
+        for (int k = outOffsets[slot]; k < outOffsets[slot + 1]; ++k) {
+            f(outArcs[k]);
+        }
+    }
+
+    /**
+     * Calls f(arc) for every arc entering a slot; arc.city is the
+     * city it comes from
+     */
+    template <typename F>
+    void forEachIn(int slot, F&& f) const {
+        for (int k = inOffsets[slot]; k < inOffsets[slot + 1]; ++k) {
+            f(inArcs[k]);
+        }
+    }
+
+    /**
+     * Cheapest total budget to travel from source to every slot
+     * @return Cost per slot; unreachable slots get infinity
+     */
+    std::vector<double> cheapestFrom(int source) const;
+
+    /**
+     * Cheapest total budget to travel from every slot to target,
+     * found by searching the in-arcs backward from it
+     * @return Cost per slot; slots that cannot reach it get infinity
+     */
+    std::vector<double> cheapestTo(int target) const;
+
+    /**
+     * Cheapest route from source to target by bidirectional
+     * Dijkstra: a forward search from source and a backward search
+     * from target take turns until their frontiers together cannot
+     * improve on the best route joining them
+     */
+    Route cheapestRoute(int source, int target) const;
+
+    size_t usedBytes() const;
+    size_t capacityBytes() const;
+};
+
+#endif // RWANDA_DIRECTED_GRAPH_H
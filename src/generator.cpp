@@ -0,0 +1,405 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - network generator
+ *
+ * Implements the synthetic graph models and the budget sampling
+ * used for scale and load testing.
+ *****************************************************************/
+
+#include "generator.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <unordered_set>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+//====================================================================
+// HELPERS
+//====================================================================
+
+namespace {
+
+/**
+ * Collects undirected roads between 0-based city slots,
+ * ignoring self loops and pairs that are already connected
+ */
+class EdgeSet {
+private:
+    unordered_set<long long> keys;
+    long long cityCount;
+
+public:
+    vector<pair<int, int>> edges;
+
+    explicit EdgeSet(int count) : cityCount(count) {}
+
+    bool add(int a, int b) {
+        if (a == b) {
+            return false;
+        }
+        long long key = static_cast<long long>(min(a, b)) * cityCount + max(a, b);
+        if (!keys.insert(key).second) {
+            return false;
+        }
+        edges.emplace_back(a, b);
+        return true;
+    }
+};
+
+/**
+ * Disjoint set forest used to keep the road-like model connected
+ */
+class DisjointSet {
+private:
+    vector<int> parent;
+
+public:
+    explicit DisjointSet(int count) : parent(count) {
+        iota(parent.begin(), parent.end(), 0);
+    }
+
+    int find(int x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+    bool unite(int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) {
+            return false;
+        }
+        parent[a] = b;
+        return true;
+    }
+};
+
+/**
+ * Links every pair of cities closer than the radius that keeps
+ * the expected degree at averageDegree. Cities are bucketed in a
+ * grid of radius-sized cells so only nearby cells are compared.
+ */
+void randomGeometric(const GeneratorOptions& options, mt19937_64& rng,
+                     vector<Position>& positions, EdgeSet& edges) {
+    int n = options.cityCount;
+    uniform_real_distribution<double> coordinate(0.0, 1.0);
+    for (int i = 0; i < n; ++i) {
+        positions.push_back({coordinate(rng), coordinate(rng)});
+    }
+
+    const double pi = acos(-1.0);
+    double radius = sqrt(options.averageDegree / (pi * max(n, 1)));
+    int cellsPerSide = max(1, min(static_cast<int>(1.0 / radius), 4096));
+    vector<vector<int>> cells(static_cast<size_t>(cellsPerSide) * cellsPerSide);
+    auto cellOf = [cellsPerSide](double v) {
+        return min(static_cast<int>(v * cellsPerSide), cellsPerSide - 1);
+    };
+    for (int i = 0; i < n; ++i) {
+        cells[cellOf(positions[i].y) * cellsPerSide + cellOf(positions[i].x)].push_back(i);
+    }
+
+    double radiusSquared = radius * radius;
+    for (int i = 0; i < n; ++i) {
+        int cx = cellOf(positions[i].x);
+        int cy = cellOf(positions[i].y);
+        for (int y = max(cy - 1, 0); y <= min(cy + 1, cellsPerSide - 1); ++y) {
+            for (int x = max(cx - 1, 0); x <= min(cx + 1, cellsPerSide - 1); ++x) {
+                for (int j : cells[y * cellsPerSide + x]) {
+                    if (j <= i) {
+                        continue;
+                    }
+                    double dx = positions[i].x - positions[j].x;
+                    double dy = positions[i].y - positions[j].y;
+                    if (dx * dx + dy * dy <= radiusSquared) {
+                        edges.add(i, j);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Lays the cities out row by row and links horizontal and vertical
+ * neighbors
+ */
+void grid(const GeneratorOptions& options, vector<Position>& positions, EdgeSet& edges) {
+    int n = options.cityCount;
+    int cols = max(1, static_cast<int>(ceil(sqrt(n))));
+    int rows = (n + cols - 1) / cols;
+    for (int i = 0; i < n; ++i) {
+        positions.push_back({(i % cols + 0.5) / cols, (i / cols + 0.5) / max(rows, 1)});
+        if (i % cols + 1 < cols && i + 1 < n) {
+            edges.add(i, i + 1);
+        }
+        if (i + cols < n) {
+            edges.add(i, i + cols);
+        }
+    }
+}
+
+/**
+ * Barabasi-Albert model: each new city links to m existing cities
+ * picked with probability proportional to their degree, giving a
+ * power-law degree distribution with a few large hubs
+ */
+void scaleFree(const GeneratorOptions& options, mt19937_64& rng,
+               vector<Position>& positions, EdgeSet& edges) {
+    int n = options.cityCount;
+    int m = max(1, static_cast<int>(lround(options.averageDegree / 2.0)));
+    uniform_real_distribution<double> coordinate(0.0, 1.0);
+    for (int i = 0; i < n; ++i) {
+        positions.push_back({coordinate(rng), coordinate(rng)});
+    }
+
+    // Every road end is recorded once, so sampling this list
+    // picks cities proportionally to their degree
+    vector<int> roadEnds;
+    int seedSize = min(n, m + 1);
+    for (int i = 0; i < seedSize; ++i) {
+        for (int j = i + 1; j < seedSize; ++j) {
+            edges.add(i, j);
+            roadEnds.push_back(i);
+            roadEnds.push_back(j);
+        }
+    }
+
+    for (int i = seedSize; i < n; ++i) {
+        vector<int> targets;
+        while (static_cast<int>(targets.size()) < min(m, i)) {
+            int target = roadEnds.empty()
+                ? uniform_int_distribution<int>(0, i - 1)(rng)
+                : roadEnds[uniform_int_distribution<size_t>(0, roadEnds.size() - 1)(rng)];
+            if (find(targets.begin(), targets.end(), target) == targets.end()) {
+                targets.push_back(target);
+            }
+        }
+        for (int target : targets) {
+            edges.add(i, target);
+            roadEnds.push_back(i);
+            roadEnds.push_back(target);
+        }
+    }
+}
+
+/**
+ * Planar, connected network resembling a road map: a jittered grid
+ * where each grid road is kept with some probability and each cell
+ * may get one diagonal. Removed roads that are needed to keep the
+ * network connected are put back.
+ */
+void roadLike(const GeneratorOptions& options, mt19937_64& rng,
+              vector<Position>& positions, EdgeSet& edges) {
+    int n = options.cityCount;
+    int cols = max(1, static_cast<int>(ceil(sqrt(n))));
+    int rows = (n + cols - 1) / cols;
+
+    // A full grid gives degree 4 and each diagonal adds about 2
+    double keep = min(1.0, options.averageDegree / 4.0);
+    double diagonal = clamp((options.averageDegree - 4.0) / 2.0, 0.0, 1.0);
+
+    uniform_real_distribution<double> jitter(-0.35, 0.35);
+    uniform_real_distribution<double> chance(0.0, 1.0);
+    for (int i = 0; i < n; ++i) {
+        positions.push_back({(i % cols + 0.5 + jitter(rng)) / cols,
+                             (i / cols + 0.5 + jitter(rng)) / max(rows, 1)});
+    }
+
+    vector<pair<int, int>> dropped;
+    DisjointSet components(n);
+    auto consider = [&](int a, int b, double probability) {
+        if (chance(rng) < probability) {
+            edges.add(a, b);
+            components.unite(a, b);
+        } else {
+            dropped.emplace_back(a, b);
+        }
+    };
+
+    for (int i = 0; i < n; ++i) {
+        bool hasRight = i % cols + 1 < cols && i + 1 < n;
+        bool hasDown = i + cols < n;
+        if (hasRight) {
+            consider(i, i + 1, keep);
+        }
+        if (hasDown) {
+            consider(i, i + cols, keep);
+        }
+        if (hasRight && hasDown && i + cols + 1 < n && chance(rng) < diagonal) {
+            // Only one diagonal per cell, so roads never cross
+            if (chance(rng) < 0.5) {
+                edges.add(i, i + cols + 1);
+                components.unite(i, i + cols + 1);
+            } else {
+                edges.add(i + 1, i + cols);
+                components.unite(i + 1, i + cols);
+            }
+        }
+    }
+
+    for (const auto& road : dropped) {
+        if (components.unite(road.first, road.second)) {
+            edges.add(road.first, road.second);
+        }
+    }
+}
+
+/**
+ * Draws one budget, rounded to two decimals like entered budgets
+ */
+Budget sampleBudget(const GeneratorOptions& options, mt19937_64& rng) {
+    double budget = options.budgetMean;
+    switch (options.budgetDistribution) {
+        case BudgetDistribution::Uniform:
+            budget = uniform_real_distribution<double>(options.budgetMin, options.budgetMax)(rng);
+            break;
+        case BudgetDistribution::Normal:
+            budget = normal_distribution<double>(options.budgetMean, options.budgetStdDev)(rng);
+            break;
+        case BudgetDistribution::LogNormal: {
+            // Convert the requested mean and deviation to the log scale
+            double mean = max(options.budgetMean, 1e-9);
+            double variance = options.budgetStdDev * options.budgetStdDev;
+            double sigmaSquared = log(1.0 + variance / (mean * mean));
+            double mu = log(mean) - sigmaSquared / 2.0;
+            budget = lognormal_distribution<double>(mu, sqrt(sigmaSquared))(rng);
+            break;
+        }
+        case BudgetDistribution::Constant:
+            break;
+    }
+    return static_cast<Budget>(llround(max(budget, 0.0) * 100.0)) * (BUDGET_PER_BILLION / 100);
+}
+
+} // namespace
+
+//====================================================================
+// GENERATOR FUNCTIONS
+//====================================================================
+
+GeneratedNetwork generateNetwork(const GeneratorOptions& options) {
+    RWANDA_TRACE_SCOPE("generateNetwork", "import");
+    GeneratedNetwork network;
+    int n = max(options.cityCount, 0);
+    mt19937_64 rng(options.seed);
+
+    // Zero-padded names keep the cities sorted by index
+    int digits = to_string(max(n, 1)).size();
+    network.cityNames.reserve(n);
+    for (int i = 1; i <= n; ++i) {
+        string number = to_string(i);
+        network.cityNames.push_back(options.namePrefix + string(digits - number.size(), '0') + number);
+    }
+
+    EdgeSet edges(n);
+    {
+        RWANDA_TRACE_SCOPE("build graph", "import");
+        switch (options.model) {
+            case GraphModel::RandomGeometric:
+                randomGeometric(options, rng, network.positions, edges);
+                break;
+            case GraphModel::Grid:
+                grid(options, network.positions, edges);
+                break;
+            case GraphModel::ScaleFree:
+                scaleFree(options, rng, network.positions, edges);
+                break;
+            case GraphModel::RoadLike:
+                roadLike(options, rng, network.positions, edges);
+                break;
+        }
+    }
+
+    RWANDA_TRACE_SCOPE("sample budgets", "import");
+    network.roads.reserve(edges.edges.size());
+    for (const auto& edge : edges.edges) {
+        network.roads.push_back({edge.first + 1, edge.second + 1, sampleBudget(options, rng)});
+    }
+    return network;
+}
+
+void loadGeneratedNetwork(RwandaInfrastructure& infrastructure, const GeneratedNetwork& network) {
+    infrastructure.loadNetwork(network.cityNames, network.roads);
+}
+
+bool writeGeneratedNetwork(const GeneratedNetwork& network, const string& directory) {
+    RWANDA_TRACE_SCOPE("writeGeneratedNetwork", "save");
+    fs::path cityFilePath = fs::path(directory) / "cities.txt";
+    fs::path roadFilePath = fs::path(directory) / "roads.txt";
+
+    // Same layout as RwandaInfrastructure::saveToFiles, written from
+    // the edge list so no matrix has to be built
+    ofstream cityFile(cityFilePath);
+    if (!cityFile.is_open()) {
+        cerr << "Error: Could not open " << cityFilePath.string() << " for writing!" << endl;
+        return false;
+    }
+    writeCityHeader(cityFile);
+    for (size_t i = 0; i < network.cityNames.size(); ++i) {
+        writeCityRow(cityFile, i + 1, network.cityNames[i]);
+    }
+
+    ofstream roadFile(roadFilePath);
+    if (!roadFile.is_open()) {
+        cerr << "Error: Could not open " << roadFilePath.string() << " for writing!" << endl;
+        return false;
+    }
+
+    vector<Road> sorted = network.roads;
+    for (auto& road : sorted) {
+        if (road.city1 > road.city2) {
+            swap(road.city1, road.city2);
+        }
+    }
+    sort(sorted.begin(), sorted.end(), [](const Road& a, const Road& b) {
+        return a.city1 != b.city1 ? a.city1 < b.city1 : a.city2 < b.city2;
+    });
+
+    writeRoadHeader(roadFile);
+    int counter = 1;
+    for (const auto& road : sorted) {
+        string roadName = network.cityNames[road.city1 - 1] + "-" + network.cityNames[road.city2 - 1];
+        writeRoadRow(roadFile, counter++, roadName, road.budget);
+    }
+    return true;
+}
+
+bool parseGraphModel(const string& name, GraphModel& model) {
+    if (name == "geometric") {
+        model = GraphModel::RandomGeometric;
+    } else if (name == "grid") {
+        model = GraphModel::Grid;
+    } else if (name == "scalefree") {
+        model = GraphModel::ScaleFree;
+    } else if (name == "road") {
+        model = GraphModel::RoadLike;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parseBudgetDistribution(const string& name, BudgetDistribution& distribution) {
+    if (name == "uniform") {
+        distribution = BudgetDistribution::Uniform;
+    } else if (name == "normal") {
+        distribution = BudgetDistribution::Normal;
+    } else if (name == "lognormal") {
+        distribution = BudgetDistribution::LogNormal;
+    } else if (name == "constant") {
+        distribution = BudgetDistribution::Constant;
+    } else {
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,113 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - network generator
+ *
+ * Builds synthetic road networks for scale and load testing.
+ * Every network is fully determined by its options, including
+ * the seed, so runs can be reproduced exactly.
+ *****************************************************************/
+
+#ifndef RWANDA_GENERATOR_H
+#define RWANDA_GENERATOR_H
+
+#include "infrastructure.h"
+
+#include <string>
+#include <vector>
+
+//====================================================================
+// STRUCTURES
+//====================================================================
+
+/**
+ * Shape of the generated road graph
+ */
+enum class GraphModel {
+    RandomGeometric,    // Cities in the unit square, linked when close
+    Grid,               // Rectangular grid, each city linked to 4 neighbors
+    ScaleFree,          // Barabasi-Albert preferential attachment
+    RoadLike            // Planar jittered grid with diagonals, always connected
+};
+
+/**
+ * How road budgets are drawn
+ */
+enum class BudgetDistribution {
+    Uniform,            // Between budgetMin and budgetMax
+    Normal,             // budgetMean and budgetStdDev, clamped at zero
+    LogNormal,          // Skewed, with the given mean and standard deviation
+    Constant            // Always budgetMean
+};
+
+/**
+ * Parameters of a generated network
+ * averageDegree sets the expected number of roads per city; the
+ * grid model ignores it since every inner city has four roads
+ */
+struct GeneratorOptions {
+    GraphModel model = GraphModel::RoadLike;
+    int cityCount = 100;
+    double averageDegree = 4.0;
+    BudgetDistribution budgetDistribution = BudgetDistribution::Uniform;
+    double budgetMin = 1.0;
+    double budgetMax = 150.0;
+    double budgetMean = 50.0;
+    double budgetStdDev = 20.0;
+    unsigned seed = 42;
+    std::string namePrefix = "City";
+};
+
+/**
+ * A point in the unit square
+ */
+struct Position {
+    double x;
+    double y;
+};
+
+/**
+ * A generated network, ready to be loaded or written out
+ * Roads refer to cities by 1-based index, as in RwandaInfrastructure
+ */
+struct GeneratedNetwork {
+    std::vector<std::string> cityNames;
+    std::vector<Position> positions;
+    std::vector<Road> roads;
+};
+
+//====================================================================
+// GENERATOR FUNCTIONS
+//====================================================================
+
+/**
+ * Generates a network according to the options
+ * @param options Model, size, degree, budget distribution and seed
+ * @return The cities, their positions and the roads with budgets
+ */
+GeneratedNetwork generateNetwork(const GeneratorOptions& options);
+
+/**
+ * Loads a generated network into an infrastructure system,
+ * replacing its current contents
+ */
+void loadGeneratedNetwork(RwandaInfrastructure& infrastructure, const GeneratedNetwork& network);
+
+/**
+ * Writes a generated network as cities.txt and roads.txt
+ * @param directory Directory that receives the two files
+ * @return False if the files could not be written
+ */
+bool writeGeneratedNetwork(const GeneratedNetwork& network, const std::string& directory);
+
+/**
+ * Parses a model name (geometric, grid, scalefree, road)
+ * @return False if the name is unknown
+ */
+bool parseGraphModel(const std::string& name, GraphModel& model);
+
+/**
+ * Parses a budget distribution name (uniform, normal, lognormal, constant)
+ * @return False if the name is unknown
+ */
+bool parseBudgetDistribution(const std::string& name, BudgetDistribution& distribution);
+
+#endif // RWANDA_GENERATOR_H
@@ -0,0 +1,730 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - graph engine
+ *
+ * BasicInfrastructure holds the cities, the edge list and the road
+ * storage, and implements the graph algorithms once for every
+ * storage layout. The layout and the weight type are template
+ * parameters, so a deployment picks the fastest layout at compile
+ * time with no virtual calls in the inner loops:
+ *
+ *   BasicInfrastructure<DenseStorage, Budget>
+ *   BasicInfrastructure<CsrStorage, Budget>
+ *
+ * The storage rows can be laid out in a different order than the
+ * city slots (see city_order.h); the engine maps between the two,
+ * so slots and the indices shown to users never change.
+ *
+ * The engine never prints; RwandaInfrastructure builds the console
+ * application on top of it.
+ *****************************************************************/
+
+#ifndef RWANDA_GRAPH_ENGINE_H
+#define RWANDA_GRAPH_ENGINE_H
+
+#include "budget.h"
+#include "city_order.h"
+#include "graph_storage.h"
+#include "metrics.h"
+#include "name_key.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+//====================================================================
+// STRUCTURES
+//====================================================================
+
+/**
+ * Represents a city with an index and name
+ */
+struct City {
+    int index;
+    std::string name;
+    std::string key;        // normalizeName(name), used for lookups and duplicate checks
+    int district = -1;      // District id from regions.h, or -1 if unassigned
+};
+
+/**
+ * Represents a road connection between two cities with a budget
+ * Two cities may be joined by several roads, each with its own id
+ */
+struct Road {
+    int city1;
+    int city2;
+    Budget budget;          // Thousands of RWF, see budget.h
+    bool oneWay = false;    // Only travelled from city1 to city2
+};
+
+/**
+ * One entry of a city's adjacency list: a road and the city at its
+ * other end
+ */
+struct RoadLink {
+    int neighbor;
+    int road;
+};
+
+/**
+ * The roads between two cities, a contiguous run of one city's
+ * adjacency list in id order
+ */
+struct ParallelRoads {
+    const RoadLink* first;
+    const RoadLink* last;
+
+    const RoadLink* begin() const {
+        return first;
+    }
+
+    const RoadLink* end() const {
+        return last;
+    }
+
+    size_t size() const {
+        return last - first;
+    }
+
+    bool empty() const {
+        return first == last;
+    }
+};
+
+//====================================================================
+// BASIC INFRASTRUCTURE TEMPLATE
+//====================================================================
+
+/**
+ * Cities and roads stored with a compile-time layout
+ * City indices are 1-based as shown to users; slots passed to the
+ * storage and the algorithms are 0-based (slot = index - 1)
+ * Parallel roads each have their own entry in the edge list and
+ * the adjacency lists; the storage holds one entry per connected
+ * pair, weighted with the combined budget of the pair's roads
+ * The storage is indexed by row, which is the slot unless the rows
+ * have been reordered; the algorithms run over rows and return
+ * their results by slot
+ */
+template <template <typename> class StoragePolicy, typename WeightType>
+class BasicInfrastructure {
+public:
+    using Weight = WeightType;
+    using Storage = StoragePolicy<WeightType>;
+
+protected:
+    std::vector<City> cities;
+    Storage storage;
+    std::vector<Road> roads;                    // Edge list, one entry per road
+    std::vector<std::vector<RoadLink>> adjacency;   // Roads touching each slot, by neighbor then id
+    CityKeyTable keyIndex;                      // City slots by normalized name
+    size_t revision = 0;                        // Changes with every city, road or budget edit
+    std::vector<int> slotRows;                  // Storage row of each slot, empty in insertion order
+    std::vector<int> rowSlots;                  // Slot held by each storage row, the inverse
+
+    int rowOf(int slot) const {
+        return slotRows.empty() ? slot : slotRows[slot];
+    }
+
+    /**
+     * Moves a per-row result to slot order
+     */
+    template <typename T>
+    std::vector<T> bySlot(std::vector<T> byRow) const {
+        if (slotRows.empty()) {
+            return byRow;
+        }
+        std::vector<T> result(byRow.size());
+        for (size_t slot = 0; slot < result.size(); ++slot) {
+            result[slot] = byRow[slotRows[slot]];
+        }
+        return result;
+    }
+
+    /**
+     * The distinct neighbors of every slot as compressed sparse rows
+     */
+    void neighborRows(std::vector<int>& offsets, std::vector<int>& neighbors) const {
+        offsets.assign(1, 0);
+        neighbors.clear();
+        for (const auto& list : adjacency) {
+            for (size_t k = 0; k < list.size(); ++k) {
+                if (k == 0 || list[k].neighbor != list[k - 1].neighbor) {
+                    neighbors.push_back(list[k].neighbor);
+                }
+            }
+            offsets.push_back(neighbors.size());
+        }
+    }
+
+    /**
+     * Refills the storage with slot order[r] in row r
+     */
+    void loadStorageRows(const std::vector<int>& order) {
+        RWANDA_TRACE_SCOPE("loadStorageRows", "matrix growth");
+        int size = cities.size();
+        rowSlots = order;
+        slotRows.assign(size, 0);
+        for (int row = 0; row < size; ++row) {
+            slotRows[order[row]] = row;
+        }
+
+        std::vector<std::pair<int, int>> pairs;
+        std::vector<Weight> pairWeights;
+        for (int i = 0; i < size; ++i) {
+            for (const RoadLink& link : adjacency[i]) {
+                if (link.neighbor < i) {
+                    continue;
+                }
+                Weight w = static_cast<Weight>(roads[link.road].budget);
+                if (!pairs.empty() && pairs.back() == std::make_pair(slotRows[i], slotRows[link.neighbor])) {
+                    pairWeights.back() += w;
+                } else {
+                    pairs.emplace_back(slotRows[i], slotRows[link.neighbor]);
+                    pairWeights.push_back(w);
+                }
+            }
+        }
+        bulkLoadStorage(storage, size, pairs, pairWeights);
+
+        bool identity = true;
+        for (int row = 0; row < size && identity; ++row) {
+            identity = order[row] == row;
+        }
+        if (identity) {
+            slotRows.clear();
+            rowSlots.clear();
+        }
+    }
+
+    auto keyOf() const {
+        return [this](int slot) -> const std::string& { return cities[slot].key; };
+    }
+
+    /**
+     * Appends a city without checking its name
+     * @return The new city's index
+     */
+    int appendCity(const std::string& name) {
+        int newIndex = cities.empty() ? 1 : cities.back().index + 1;
+        cities.push_back({newIndex, name, normalizeName(name)});
+        keyIndex.insert(cities.size() - 1, keyOf());
+        revision++;
+        storage.resize(cities.size());
+        adjacency.resize(cities.size());
+        if (!slotRows.empty()) {
+            slotRows.push_back(cities.size() - 1);
+            rowSlots.push_back(cities.size() - 1);
+        }
+        return newIndex;
+    }
+
+    /**
+     * Links a road into a slot's adjacency list after the roads it
+     * already has to the same neighbor, which all have smaller ids
+     */
+    void linkRoad(int slot, int neighbor, int roadId) {
+        std::vector<RoadLink>& list = adjacency[slot];
+        auto at = std::upper_bound(list.begin(), list.end(), neighbor,
+                                   [](int n, const RoadLink& link) { return n < link.neighbor; });
+        list.insert(at, {neighbor, roadId});
+    }
+
+    void unlinkRoad(int slot, int neighbor, int roadId) {
+        std::vector<RoadLink>& list = adjacency[slot];
+        auto at = std::lower_bound(list.begin(), list.end(), RoadLink{neighbor, roadId},
+                                   [](const RoadLink& a, const RoadLink& b) {
+                                       return a.neighbor != b.neighbor ? a.neighbor < b.neighbor : a.road < b.road;
+                                   });
+        list.erase(at);
+    }
+
+    /**
+     * Stores the combined budget of the roads between two slots
+     */
+    void refreshPairWeight(int i, int j) {
+        Weight total = Weight();
+        for (const RoadLink& link : roadsBetween(i, j)) {
+            total += static_cast<Weight>(roads[link.road].budget);
+        }
+        storage.setWeight(rowOf(i), rowOf(j), total);
+    }
+
+    /**
+     * Connects two different slots, alongside any roads they
+     * already share
+     * @param oneWay Whether the road only leads from i to j
+     * @return The new road's id
+     */
+    int connectSlots(int i, int j, bool oneWay = false) {
+        if (!storage.hasRoad(rowOf(i), rowOf(j))) {
+            storage.addRoad(rowOf(i), rowOf(j));
+        }
+        int roadId = roads.size();
+        roads.push_back({i + 1, j + 1, 0, oneWay});
+        revision++;
+        linkRoad(i, j, roadId);
+        linkRoad(j, i, roadId);
+        return roadId;
+    }
+
+    /**
+     * Removes the most recently added city, which must have no roads
+     */
+    void removeLastCity() {
+        int slot = cities.size() - 1;
+        if (rowOf(slot) != slot) {
+            // Swap the city's empty row with the last row so the storage
+            // can drop it; only the last row's pairs move, O(its degree)
+            int row = rowOf(slot);
+            int last = slot;
+            int moved = rowSlots[last];
+            std::vector<int> neighbors;
+            for (const RoadLink& link : adjacency[moved]) {
+                if (neighbors.empty() || neighbors.back() != link.neighbor) {
+                    neighbors.push_back(link.neighbor);
+                    storage.removeRoad(last, rowOf(link.neighbor));
+                }
+            }
+            slotRows[moved] = row;
+            rowSlots[row] = moved;
+            slotRows[slot] = last;
+            rowSlots[last] = slot;
+            for (int neighbor : neighbors) {
+                storage.addRoad(row, rowOf(neighbor));
+                refreshPairWeight(moved, neighbor);
+            }
+        }
+        keyIndex.erase(slot, keyOf());
+        cities.pop_back();
+        revision++;
+        adjacency.pop_back();
+        storage.resize(cities.size());
+        if (!slotRows.empty()) {
+            slotRows.pop_back();
+            rowSlots.pop_back();
+        }
+    }
+
+    /**
+     * Renames a city slot without checking the new name
+     */
+    void renameSlot(int slot, const std::string& newName) {
+        keyIndex.erase(slot, keyOf());
+        cities[slot].name = newName;
+        cities[slot].key = normalizeName(newName);
+        keyIndex.insert(slot, keyOf());
+    }
+
+    /**
+     * Removes the most recently added road
+     */
+    void removeLastRoad() {
+        int roadId = roads.size() - 1;
+        int i = roads.back().city1 - 1;
+        int j = roads.back().city2 - 1;
+        unlinkRoad(i, j, roadId);
+        unlinkRoad(j, i, roadId);
+        roads.pop_back();
+        revision++;
+        if (roadsBetween(i, j).empty()) {
+            storage.removeRoad(rowOf(i), rowOf(j));
+        } else {
+            refreshPairWeight(i, j);
+        }
+    }
+
+    /**
+     * Sets the budget of an existing road in the edge list and storage
+     */
+    void setRoadBudget(int roadId, Budget budget) {
+        Road& road = roads[roadId];
+        road.budget = budget;
+        revision++;
+        refreshPairWeight(road.city1 - 1, road.city2 - 1);
+    }
+
+    /**
+     * The roads between two slots, found by binary search in the
+     * shorter of the two adjacency lists
+     */
+    ParallelRoads roadsBetween(int i, int j) const {
+        int from = adjacency[i].size() <= adjacency[j].size() ? i : j;
+        int to = from == i ? j : i;
+        const std::vector<RoadLink>& list = adjacency[from];
+        auto range = std::equal_range(list.begin(), list.end(), RoadLink{to, 0},
+                                      [](const RoadLink& a, const RoadLink& b) { return a.neighbor < b.neighbor; });
+        return {list.data() + (range.first - list.begin()), list.data() + (range.second - list.begin())};
+    }
+
+    /**
+     * Finds the id of the first road between two slots
+     * @return The road id, or -1 if the cities are not connected
+     */
+    int findRoadId(int i, int j) const {
+        ParallelRoads between = roadsBetween(i, j);
+        return between.empty() ? -1 : between.begin()->road;
+    }
+
+public:
+    /**
+     * Looks up a city by name, ignoring case, accents and extra blanks
+     * @return The city index, or -1 if no city has that name
+     */
+    int findCityIndex(const std::string& name) const {
+        RWANDA_TIME_OPERATION(Operation::FindCityIndex);
+
+        int slot = keyIndex.find(normalizeName(name), keyOf());
+        return slot < 0 ? -1 : cities[slot].index;
+    }
+
+    bool hasCities() const {
+        return !cities.empty();
+    }
+
+    int cityCount() const {
+        return cities.size();
+    }
+
+    int roadCount() const {
+        return roads.size();
+    }
+
+    /**
+     * Number of connected pairs of cities, which the storage holds one
+     * entry each for; parallel roads count once
+     */
+    int pairCount() const {
+        int pairs = 0;
+        for (size_t slot = 0; slot < adjacency.size(); ++slot) {
+            const std::vector<RoadLink>& links = adjacency[slot];
+            for (size_t k = 0; k < links.size(); ++k) {
+                // Each pair is counted from its lower slot
+                if (links[k].neighbor > static_cast<int>(slot) &&
+                    (k == 0 || links[k].neighbor != links[k - 1].neighbor)) {
+                    pairs++;
+                }
+            }
+        }
+        return pairs;
+    }
+
+    /**
+     * The road storage, indexed by storage row (see storageRow)
+     */
+    const Storage& roadStorage() const {
+        return storage;
+    }
+
+    /**
+     * The storage row holding a city slot
+     */
+    int storageRow(int slot) const {
+        return rowOf(slot);
+    }
+
+    bool slotsConnected(int i, int j) const {
+        return storage.hasRoad(rowOf(i), rowOf(j));
+    }
+
+    /**
+     * Combined budget of the roads between two slots
+     */
+    Weight pairWeight(int i, int j) const {
+        return storage.weight(rowOf(i), rowOf(j));
+    }
+
+    CityOrder storageOrder() const {
+        return slotRows.empty() ? CityOrder::Insertion : CityOrder::ReverseCuthillMcKee;
+    }
+
+    /**
+     * Lays the storage rows out in an order, keeping every slot and
+     * index; cities added later are appended after the reordered rows
+     * Costs one bulk load of the storage, plus O(n + m log d) to
+     * compute a reverse Cuthill-McKee order
+     */
+    void reorderStorage(CityOrder order) {
+        RWANDA_TRACE_SCOPE("reorderStorage", "matrix growth");
+        std::vector<int> rows;
+        if (order == CityOrder::ReverseCuthillMcKee) {
+            std::vector<int> offsets;
+            std::vector<int> neighbors;
+            neighborRows(offsets, neighbors);
+            rows = reverseCuthillMcKee(offsets, neighbors);
+        } else {
+            rows.resize(cities.size());
+            for (size_t slot = 0; slot < rows.size(); ++slot) {
+                rows[slot] = slot;
+            }
+        }
+        loadStorageRows(rows);
+    }
+
+    /**
+     * How far apart the storage rows of connected cities are
+     */
+    OrderSpread storageSpread() const {
+        std::vector<int> offsets;
+        std::vector<int> neighbors;
+        neighborRows(offsets, neighbors);
+        return measureSpread(offsets, neighbors, slotRows);
+    }
+
+    /**
+     * Bytes of the slot-to-row mapping
+     */
+    size_t storageOrderBytes() const {
+        return (slotRows.capacity() + rowSlots.capacity()) * sizeof(int);
+    }
+
+    /**
+     * A number that changes whenever a city or road is added or
+     * removed or a budget is set, so derived structures know when to
+     * rebuild
+     */
+    size_t roadsRevision() const {
+        return revision;
+    }
+
+    /**
+     * Replaces the whole network with the given cities and roads
+     * The storage is sized once and no lookups or console messages
+     * are made per city or road, so large networks load quickly
+     * @param cityNames Names of the cities, indexed from 1 in order
+     * @param newRoads Roads referring to cities by 1-based index;
+     *                 invalid roads are skipped, and roads repeating
+     *                 a pair become parallel roads
+     * @return False if two city names have the same normalized key
+     *         (nothing is loaded)
+     */
+    bool loadNetwork(const std::vector<std::string>& cityNames, const std::vector<Road>& newRoads) {
+        RWANDA_TRACE_SCOPE("loadNetwork", "import");
+
+        std::vector<std::string> keys;
+        {
+            RWANDA_TRACE_SCOPE("check names", "import");
+            keys.reserve(cityNames.size());
+            std::unordered_set<std::string> seen;
+            seen.reserve(cityNames.size());
+            for (const auto& name : cityNames) {
+                keys.push_back(normalizeName(name));
+                if (!seen.insert(keys.back()).second) {
+                    std::cerr << "Error: City " << name << " appears more than once." << std::endl;
+                    return false;
+                }
+            }
+        }
+
+        int size = cityNames.size();
+        {
+            RWANDA_TRACE_SCOPE("build cities", "import");
+            cities.clear();
+            cities.reserve(size);
+            keyIndex.clear();
+            slotRows.clear();
+            rowSlots.clear();
+            for (int i = 0; i < size; ++i) {
+                cities.push_back({i + 1, cityNames[i], std::move(keys[i])});
+                keyIndex.insert(i, keyOf());
+            }
+        }
+
+        std::vector<std::pair<int, int>> pairs;
+        std::vector<Weight> pairWeights;
+        revision++;
+        {
+            RWANDA_TRACE_SCOPE("build edge list", "import");
+            roads.clear();
+            roads.reserve(newRoads.size());
+            adjacency.assign(size, {});
+            std::unordered_map<uint64_t, int> pairIds;
+            pairIds.reserve(newRoads.size());
+            for (const auto& road : newRoads) {
+                int i = road.city1 - 1;
+                int j = road.city2 - 1;
+                if (i < 0 || j < 0 || i >= size || j >= size || i == j || road.budget < 0) {
+                    continue;
+                }
+                int roadId = roads.size();
+                roads.push_back(road);
+                adjacency[i].push_back({j, roadId});
+                adjacency[j].push_back({i, roadId});
+
+                // The storage gets one entry per pair with the combined budget
+                uint64_t key = (static_cast<uint64_t>(std::min(i, j)) << 32) | std::max(i, j);
+                auto [found, added] = pairIds.emplace(key, pairs.size());
+                if (added) {
+                    pairs.emplace_back(i, j);
+                    pairWeights.push_back(static_cast<Weight>(road.budget));
+                } else {
+                    pairWeights[found->second] += static_cast<Weight>(road.budget);
+                }
+            }
+        }
+
+        {
+            // Ids were appended in order, so a stable sort by neighbor
+            // leaves each pair's roads contiguous and in id order
+            RWANDA_TRACE_SCOPE("group parallel roads", "import");
+            for (auto& list : adjacency) {
+                std::stable_sort(list.begin(), list.end(),
+                                 [](const RoadLink& a, const RoadLink& b) { return a.neighbor < b.neighbor; });
+            }
+        }
+
+        RWANDA_TRACE_SCOPE("fill storage", "matrix growth");
+        bulkLoadStorage(storage, size, pairs, pairWeights);
+        return true;
+    }
+
+    //----------------------------------------------------------------
+    // Algorithms, written once for every storage layout
+    //----------------------------------------------------------------
+
+    /**
+     * Number of roads touching a city slot, parallel roads counted
+     * separately
+     */
+    int degree(int slot) const {
+        return adjacency[slot].size();
+    }
+
+    /**
+     * Sum of the budgets of the roads touching a city slot
+     */
+    Weight budgetTotal(int slot) const {
+        return storage.rowTotal(rowOf(slot));
+    }
+
+    /**
+     * Sum of the budgets of all roads
+     */
+    Weight networkBudgetTotal() const {
+        RWANDA_TRACE_SCOPE("networkBudgetTotal", "analytics");
+        return storage.totalWeight();
+    }
+
+    /**
+     * Total and largest budget of the connections of a city slot,
+     * how many are funded and how many have at least threshold
+     * Parallel roads count as one connection with their combined budget.
+     */
+    WeightSummary<Weight> citySummary(int slot, Weight threshold) const {
+        return storage.rowSummary(rowOf(slot), threshold);
+    }
+
+    /**
+     * The same statistics over every connected pair of cities
+     */
+    WeightSummary<Weight> networkSummary(Weight threshold) const {
+        RWANDA_TRACE_SCOPE("networkSummary", "analytics");
+        return storage.summary(threshold);
+    }
+
+    /**
+     * Visits the cities reachable from a slot in breadth-first order
+     * @return The slots in visiting order, starting with source
+     */
+    std::vector<int> breadthFirstOrder(int source) const {
+        RWANDA_TRACE_SCOPE("breadthFirstOrder", "analytics");
+        std::vector<int> order;
+        std::vector<char> visited(cityCount(), 0);
+        order.push_back(rowOf(source));
+        visited[order[0]] = 1;
+        for (size_t head = 0; head < order.size(); ++head) {
+            storage.forEachNeighbor(order[head], [&](int j, Weight) {
+                if (!visited[j]) {
+                    visited[j] = 1;
+                    order.push_back(j);
+                }
+            });
+        }
+        if (!rowSlots.empty()) {
+            for (int& row : order) {
+                row = rowSlots[row];
+            }
+        }
+        return order;
+    }
+
+    /**
+     * Labels every slot with the id of its connected component
+     * Components are numbered from 0 in order of their lowest slot
+     */
+    std::vector<int> componentLabels() const {
+        RWANDA_TRACE_SCOPE("componentLabels", "analytics");
+        std::vector<int> labels(cityCount(), -1);
+        std::vector<int> queue;
+        int next = 0;
+        for (int slot = 0; slot < cityCount(); ++slot) {
+            int start = rowOf(slot);
+            if (labels[start] != -1) {
+                continue;
+            }
+            queue.assign(1, start);
+            labels[start] = next;
+            for (size_t head = 0; head < queue.size(); ++head) {
+                storage.forEachNeighbor(queue[head], [&](int j, Weight) {
+                    if (labels[j] == -1) {
+                        labels[j] = next;
+                        queue.push_back(j);
+                    }
+                });
+            }
+            next++;
+        }
+        return bySlot(std::move(labels));
+    }
+
+    /**
+     * Number of connected components
+     */
+    int componentCount() const {
+        std::vector<int> labels = componentLabels();
+        return labels.empty() ? 0 : *std::max_element(labels.begin(), labels.end()) + 1;
+    }
+
+    /**
+     * Cheapest total budget to reach every slot from source, using
+     * road budgets as costs (Dijkstra); of several parallel roads the
+     * cheapest is taken, and one-way roads are followed both ways
+     * (see directed_graph.h for routing that respects directions)
+     * The search walks the adjacency lists rather than the storage,
+     * whose pair weights are the combined budgets of parallel roads
+     * @return Cost per slot in weight units (whole budgets add up
+     *         exactly in a double below 2^53); unreachable slots
+     *         get infinity
+     */
+    std::vector<double> cheapestCosts(int source) const {
+        RWANDA_TRACE_SCOPE("cheapestCosts", "analytics");
+        const double infinity = std::numeric_limits<double>::infinity();
+        std::vector<double> cost(cityCount(), infinity);
+        using Entry = std::pair<double, int>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> frontier;
+        cost[source] = 0.0;
+        frontier.push({0.0, source});
+        while (!frontier.empty()) {
+            auto [reached, i] = frontier.top();
+            frontier.pop();
+            if (reached > cost[i]) {
+                continue;
+            }
+            for (const RoadLink& link : adjacency[i]) {
+                double candidate = reached + static_cast<double>(roads[link.road].budget);
+                if (candidate < cost[link.neighbor]) {
+                    cost[link.neighbor] = candidate;
+                    frontier.push({candidate, link.neighbor});
+                }
+            }
+        }
+        return cost;
+    }
+};
+
+#endif // RWANDA_GRAPH_ENGINE_H
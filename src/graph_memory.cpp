@@ -0,0 +1,241 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - graph memory
+ *
+ * Implements the mapped blocks with mmap, madvise and the mbind
+ * system call, so no NUMA library is needed.
+ *****************************************************************/
+
+#include "graph_memory.h"
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <unordered_map>
+
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+GraphMemoryOptions currentOptions;
+atomic<size_t> mappedBytes(0);
+atomic<size_t> explicitHugeBytes(0);
+atomic<size_t> fallbacks(0);
+mutex blocksMutex;
+unordered_map<void*, bool> mappedBlocks;    // Live mapped blocks, true if from the huge page pool
+
+size_t roundUp(size_t bytes, size_t unit) {
+    return (bytes + unit - 1) / unit * unit;
+}
+
+/**
+ * Bit i is set when node i is online; read once from sysfs as a
+ * list such as "0" or "0-1,3"
+ */
+uint64_t onlineNodes() {
+    static const uint64_t nodes = [] {
+        uint64_t mask = 0;
+        ifstream file("/sys/devices/system/node/online");
+        string list;
+        if (!(file >> list)) {
+            return uint64_t(1);
+        }
+        stringstream ranges(list);
+        string range;
+        while (getline(ranges, range, ',')) {
+            size_t dash = range.find('-');
+            int first = stoi(range.substr(0, dash));
+            int last = dash == string::npos ? first : stoi(range.substr(dash + 1));
+            for (int node = first; node <= last && node < 64; ++node) {
+                mask |= uint64_t(1) << node;
+            }
+        }
+        return mask == 0 ? uint64_t(1) : mask;
+    }();
+    return nodes;
+}
+
+#if defined(__linux__)
+
+void* mapBlock(size_t length, const GraphMemoryOptions& options) {
+    void* block = MAP_FAILED;
+    bool fromPool = false;
+    if (options.pages == PageMode::Explicit) {
+        block = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        fromPool = block != MAP_FAILED;
+        if (fromPool) {
+            explicitHugeBytes += length;
+        } else {
+            fallbacks++;
+        }
+    }
+    if (block == MAP_FAILED) {
+        // Map a huge page more than needed and trim both ends, so the
+        // block starts on a boundary the kernel can back with huge pages
+        size_t padded = length + HUGE_PAGE_BYTES;
+        void* raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            throw bad_alloc();
+        }
+        uintptr_t address = reinterpret_cast<uintptr_t>(raw);
+        uintptr_t start = roundUp(address, HUGE_PAGE_BYTES);
+        size_t head = start - address;
+        size_t tail = padded - head - length;
+        if (head > 0) {
+            munmap(raw, head);
+        }
+        if (tail > 0) {
+            munmap(reinterpret_cast<char*>(start) + length, tail);
+        }
+        block = reinterpret_cast<void*>(start);
+        if (options.pages != PageMode::Standard) {
+            madvise(block, length, MADV_HUGEPAGE);
+        }
+    }
+
+    // The policy must be set before the pages are first touched
+    if (options.placement == NodePlacement::Interleave && numaNodeCount() > 1) {
+        unsigned long nodes = onlineNodes();
+        syscall(SYS_mbind, block, length, MPOL_INTERLEAVE, &nodes, 64 + 1, 0);
+    }
+    mappedBytes += length;
+    lock_guard<mutex> lock(blocksMutex);
+    mappedBlocks.emplace(block, fromPool);
+    return block;
+}
+
+/**
+ * Unmaps a block if it was mapped
+ * @return False if it came from operator new
+ */
+bool unmapBlock(void* block, size_t length) {
+    {
+        lock_guard<mutex> lock(blocksMutex);
+        auto found = mappedBlocks.find(block);
+        if (found == mappedBlocks.end()) {
+            return false;
+        }
+        if (found->second) {
+            explicitHugeBytes -= length;
+        }
+        mappedBlocks.erase(found);
+    }
+    munmap(block, length);
+    mappedBytes -= length;
+    return true;
+}
+
+#endif // __linux__
+
+} // namespace
+
+//====================================================================
+// OPTIONS
+//====================================================================
+
+void setGraphMemoryOptions(const GraphMemoryOptions& options) {
+    currentOptions = options;
+}
+
+GraphMemoryOptions graphMemoryOptions() {
+    return currentOptions;
+}
+
+bool parsePageMode(const string& text, PageMode& mode) {
+    if (text == "standard") {
+        mode = PageMode::Standard;
+    } else if (text == "thp") {
+        mode = PageMode::Transparent;
+    } else if (text == "explicit") {
+        mode = PageMode::Explicit;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parseNodePlacement(const string& text, NodePlacement& placement) {
+    if (text == "first-touch") {
+        placement = NodePlacement::FirstTouch;
+    } else if (text == "interleave") {
+        placement = NodePlacement::Interleave;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* pageModeName(PageMode mode) {
+    switch (mode) {
+        case PageMode::Standard:    return "standard";
+        case PageMode::Transparent: return "thp";
+        case PageMode::Explicit:    return "explicit";
+    }
+    return "";
+}
+
+const char* nodePlacementName(NodePlacement placement) {
+    return placement == NodePlacement::Interleave ? "interleave" : "first-touch";
+}
+
+//====================================================================
+// STATISTICS
+//====================================================================
+
+int numaNodeCount() {
+    return __builtin_popcountll(onlineNodes());
+}
+
+GraphMemoryStats graphMemoryStats() {
+    return {mappedBytes.load(), explicitHugeBytes.load(), fallbacks.load()};
+}
+
+size_t transparentHugeBytes() {
+    ifstream file("/proc/self/smaps_rollup");
+    string label;
+    while (file >> label) {
+        if (label == "AnonHugePages:") {
+            size_t kilobytes = 0;
+            file >> kilobytes;
+            return kilobytes * 1024;
+        }
+        file.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+    return 0;
+}
+
+//====================================================================
+// ALLOCATION
+//====================================================================
+
+void* allocateGraphBlock(size_t bytes) {
+#if defined(__linux__)
+    // Standard pages come from the heap, which reuses freed blocks
+    // without faulting their pages in again
+    GraphMemoryOptions options = currentOptions;
+    bool placed = options.pages != PageMode::Standard || options.placement != NodePlacement::FirstTouch;
+    if (bytes >= MAPPED_BLOCK_BYTES && placed) {
+        return mapBlock(roundUp(bytes, HUGE_PAGE_BYTES), options);
+    }
+#endif
+    return ::operator new(bytes, align_val_t(CACHE_LINE_BYTES));
+}
+
+void releaseGraphBlock(void* block, size_t bytes) {
+#if defined(__linux__)
+    if (bytes >= MAPPED_BLOCK_BYTES && unmapBlock(block, roundUp(bytes, HUGE_PAGE_BYTES))) {
+        return;
+    }
+#endif
+    ::operator delete(block, align_val_t(CACHE_LINE_BYTES));
+}
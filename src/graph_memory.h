@@ -0,0 +1,161 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - graph memory
+ *
+ * Allocation of the large arrays of the storage policies. At
+ * national scale the dense matrix alone spans gigabytes, and with
+ * 4 KiB pages every row of it needs its own TLB entry. Unless both
+ * options below are left at their defaults, blocks of at least
+ * MAPPED_BLOCK_BYTES are mapped directly and can be backed by 2 MiB
+ * pages:
+ *
+ *   PageMode::Standard     Regular pages
+ *   PageMode::Transparent  madvise(MADV_HUGEPAGE), for the kernel's
+ *                          transparent huge pages
+ *   PageMode::Explicit     MAP_HUGETLB from the reserved huge page
+ *                          pool, falling back to Transparent when
+ *                          the pool is empty
+ *
+ * and spread over the NUMA nodes:
+ *
+ *   NodePlacement::FirstTouch  Each page goes to the node of the
+ *                              thread that first writes it
+ *   NodePlacement::Interleave  Pages alternate over all nodes, so
+ *                              scans draw on every memory controller
+ *
+ * Mapped blocks start on a 2 MiB boundary; other blocks come from
+ * operator new and start on a cache line. The options apply to
+ * blocks allocated after they are set, and a block is released the
+ * way it was allocated. Off Linux every block comes from operator new.
+ *****************************************************************/
+
+#ifndef RWANDA_GRAPH_MEMORY_H
+#define RWANDA_GRAPH_MEMORY_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+//====================================================================
+// STRUCTURES
+//====================================================================
+
+constexpr size_t CACHE_LINE_BYTES = 64;
+constexpr size_t HUGE_PAGE_BYTES = size_t(2) << 20;
+constexpr size_t MAPPED_BLOCK_BYTES = HUGE_PAGE_BYTES;     // Smallest block that can be mapped
+
+enum class PageMode {
+    Standard,
+    Transparent,
+    Explicit
+};
+
+enum class NodePlacement {
+    FirstTouch,
+    Interleave
+};
+
+struct GraphMemoryOptions {
+    PageMode pages = PageMode::Standard;
+    NodePlacement placement = NodePlacement::FirstTouch;
+};
+
+/**
+ * Totals over the blocks mapped so far that are still alive
+ */
+struct GraphMemoryStats {
+    size_t mappedBytes;         // All mapped blocks
+    size_t explicitHugeBytes;   // Blocks from the huge page pool
+    size_t fallbacks;           // Explicit requests served by Transparent
+};
+
+//====================================================================
+// FUNCTIONS
+//====================================================================
+
+void setGraphMemoryOptions(const GraphMemoryOptions& options);
+
+GraphMemoryOptions graphMemoryOptions();
+
+/**
+ * Parses "standard", "thp" or "explicit"
+ * @return False if the text is none of them
+ */
+bool parsePageMode(const std::string& text, PageMode& mode);
+
+/**
+ * Parses "first-touch" or "interleave"
+ * @return False if the text is neither
+ */
+bool parseNodePlacement(const std::string& text, NodePlacement& placement);
+
+const char* pageModeName(PageMode mode);
+
+const char* nodePlacementName(NodePlacement placement);
+
+/**
+ * Number of NUMA nodes online (1 where this cannot be read)
+ */
+int numaNodeCount();
+
+GraphMemoryStats graphMemoryStats();
+
+/**
+ * Bytes of this process backed by transparent huge pages, as
+ * reported by the kernel (0 where this cannot be read)
+ */
+size_t transparentHugeBytes();
+
+/**
+ * Allocates a block as described above
+ * @throws std::bad_alloc If no memory is available
+ */
+void* allocateGraphBlock(size_t bytes);
+
+/**
+ * Releases a block from allocateGraphBlock with the same size
+ */
+void releaseGraphBlock(void* block, size_t bytes);
+
+//====================================================================
+// ALLOCATOR
+//====================================================================
+
+/**
+ * Standard allocator drawing on allocateGraphBlock
+ */
+template <typename T>
+class GraphAllocator {
+public:
+    using value_type = T;
+
+    GraphAllocator() = default;
+
+    template <typename U>
+    GraphAllocator(const GraphAllocator<U>&) {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(allocateGraphBlock(count * sizeof(T)));
+    }
+
+    void deallocate(T* block, size_t count) {
+        releaseGraphBlock(block, count * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const GraphAllocator<U>&) const {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const GraphAllocator<U>&) const {
+        return false;
+    }
+};
+
+/**
+ * The vector type of the large storage arrays
+ */
+template <typename T>
+using GraphVector = std::vector<T, GraphAllocator<T>>;
+
+#endif // RWANDA_GRAPH_MEMORY_H
@@ -0,0 +1,711 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - storage policies
+ *
+ * Compile-time storage layouts for the road flags and weights of
+ * BasicInfrastructure. Every policy stores an undirected road
+ * between two 0-based city slots together with one weight, and
+ * offers the same interface:
+ *
+ *   resize(n)              Grow to n cities, keeping existing roads
+ *                          (or shrink, if the dropped cities have no roads)
+ *   reset(n)               Drop all roads and size for n cities
+ *   hasRoad(i, j)          Whether slots i and j are connected
+ *   addRoad(i, j)          Connect two different, unconnected slots
+ *   removeRoad(i, j)       Disconnect two connected slots
+ *   weight(i, j)           Weight of a road (zero if none)
+ *   setWeight(i, j, w)     Set the weight of an existing road
+ *   forEachNeighbor(i, f)  Call f(j, weight) for every road of i
+ *   rowTotal(i)            Sum of the weights of the roads of i
+ *   totalWeight()          Sum of the weights of all roads
+ *   rowSummary(i, t)       Total, largest weight and funded roads of i,
+ *                          and how many weigh at least t
+ *   summary(t)             The same over all roads
+ *   usedBytes()            Bytes holding live data
+ *   capacityBytes()        Bytes allocated
+ *
+ * Algorithms are templates over the policy, so every call is
+ * resolved and inlined at compile time. The arrays that grow with
+ * the network are GraphVectors, so large ones can use huge pages
+ * and NUMA placement (see graph_memory.h).
+ *****************************************************************/
+
+#ifndef RWANDA_GRAPH_STORAGE_H
+#define RWANDA_GRAPH_STORAGE_H
+
+#include "budget_kernels.h"
+#include "graph_memory.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//====================================================================
+// STRUCTURES
+//====================================================================
+
+/**
+ * Available storage layouts
+ */
+enum class StorageBackend {
+    Dense,              // One flat n x n array of flags and weights
+    Triangular,         // Only the pairs below the diagonal
+    Bitset,             // One bit per pair, weights kept per road
+    Csr,                // Compressed sparse rows, both directions of each road
+    Count               // Number of backends, not a backend
+};
+
+constexpr int STORAGE_BACKEND_COUNT = static_cast<int>(StorageBackend::Count);
+
+/**
+ * Sum of count consecutive weights
+ */
+template <typename W>
+W sumWeights(const W* values, size_t count) {
+    W total = W();
+    for (size_t k = 0; k < count; ++k) {
+        total += values[k];
+    }
+    return total;
+}
+
+/**
+ * Budgets are summed exactly with the SIMD kernel
+ */
+inline Budget sumWeights(const Budget* values, size_t count) {
+    return sumBudgets(values, count);
+}
+
+/**
+ * Statistics of the roads of a city or of the whole network
+ * A road is funded when its weight is not zero; atLeast counts the
+ * funded roads weighing at least the threshold.
+ */
+template <typename W>
+struct WeightSummary {
+    W total;
+    W max;
+    size_t funded;
+    size_t atLeast;
+
+    void add(W w, W threshold) {
+        total += w;
+        max = std::max(max, w);
+        funded += w != W();
+        atLeast += w != W() && w >= threshold;
+    }
+};
+
+template <typename W>
+WeightSummary<W> summarizeWeights(const W* values, size_t count, W threshold) {
+    WeightSummary<W> summary = {W(), W(), 0, 0};
+    for (size_t k = 0; k < count; ++k) {
+        summary.add(values[k], threshold);
+    }
+    return summary;
+}
+
+/**
+ * Budgets are summarized in one pass of the SIMD kernel; a threshold
+ * of at least one keeps unfunded cells out of atLeast
+ */
+inline WeightSummary<Budget> summarizeWeights(const Budget* values, size_t count, Budget threshold) {
+    BudgetSummary summary = summarizeBudgets(values, count, std::max<Budget>(threshold, 1));
+    return {summary.total, summary.max, summary.funded, summary.atLeast};
+}
+
+/**
+ * A summary over storage that holds every road twice
+ */
+template <typename W>
+WeightSummary<W> halveSummary(const WeightSummary<W>& both) {
+    return {both.total / 2, both.max, both.funded / 2, both.atLeast / 2};
+}
+
+//====================================================================
+// DENSE STORAGE
+//====================================================================
+
+/**
+ * Row-major n x n arrays of flags and weights
+ * Rows are padded to a capacity that doubles when exceeded, so
+ * adding cities one at a time costs amortized O(n) each. The
+ * capacity is a multiple of eight but not of a page, and the weights
+ * are cache-line aligned, so every row of 64-bit weights starts on a
+ * cache line.
+ * Lookups are O(1), neighbor scans are O(n).
+ */
+template <typename W>
+class DenseStorage {
+private:
+    int size = 0;
+    int stride = 0;
+    GraphVector<uint8_t> flags;
+    GraphVector<W> weights;
+
+    void grow(int capacity) {
+        RWANDA_TRACE_SCOPE("DenseStorage::grow", "matrix growth");
+        GraphVector<uint8_t> newFlags(static_cast<size_t>(capacity) * capacity, 0);
+        GraphVector<W> newWeights(static_cast<size_t>(capacity) * capacity, W());
+        for (int i = 0; i < size; ++i) {
+            std::copy_n(flags.begin() + static_cast<size_t>(i) * stride, size,
+                        newFlags.begin() + static_cast<size_t>(i) * capacity);
+            std::copy_n(weights.begin() + static_cast<size_t>(i) * stride, size,
+                        newWeights.begin() + static_cast<size_t>(i) * capacity);
+        }
+        flags.swap(newFlags);
+        weights.swap(newWeights);
+        stride = capacity;
+    }
+
+    size_t cell(int i, int j) const {
+        return static_cast<size_t>(i) * stride + j;
+    }
+
+public:
+    static constexpr StorageBackend backend = StorageBackend::Dense;
+
+    /**
+     * Row capacity allocated for a number of cities
+     */
+    static int padded(int cityCount) {
+        int capacity = (cityCount + 7) / 8 * 8;
+        // Rows a whole number of pages apart put a column's cells in
+        // the same cache sets (with huge pages, in every cache level),
+        // so such rows get one more block of eight cells
+        if (capacity > 0 && capacity * sizeof(W) % 4096 == 0) {
+            capacity += 8;
+        }
+        return capacity;
+    }
+
+    void resize(int cityCount) {
+        if (cityCount > stride) {
+            grow(padded(std::max(cityCount, stride * 2)));
+        }
+        size = cityCount;
+    }
+
+    void reset(int cityCount) {
+        size = cityCount;
+        stride = padded(cityCount);
+        flags.assign(static_cast<size_t>(stride) * stride, 0);
+        weights.assign(static_cast<size_t>(stride) * stride, W());
+    }
+
+    bool hasRoad(int i, int j) const {
+        return flags[cell(i, j)] != 0;
+    }
+
+    void addRoad(int i, int j) {
+        flags[cell(i, j)] = 1;
+        flags[cell(j, i)] = 1;
+    }
+
+    void removeRoad(int i, int j) {
+        flags[cell(i, j)] = 0;
+        flags[cell(j, i)] = 0;
+        weights[cell(i, j)] = W();
+        weights[cell(j, i)] = W();
+    }
+
+    W weight(int i, int j) const {
+        return weights[cell(i, j)];
+    }
+
+    void setWeight(int i, int j, W w) {
+        weights[cell(i, j)] = w;
+        weights[cell(j, i)] = w;
+    }
+
+    template <typename F>
+    void forEachNeighbor(int i, F&& f) const {
+        const uint8_t* flagRow = flags.data() + cell(i, 0);
+        const W* weightRow = weights.data() + cell(i, 0);
+        for (int j = 0; j < size; ++j) {
+            if (flagRow[j]) {
+                f(j, weightRow[j]);
+            }
+        }
+    }
+
+    // Cells without a road hold zero, so whole rows are summed
+    W rowTotal(int i) const {
+        return sumWeights(weights.data() + cell(i, 0), size);
+    }
+
+    W totalWeight() const {
+        return sumWeights(weights.data(), weights.size()) / 2;
+    }
+
+    WeightSummary<W> rowSummary(int i, W threshold) const {
+        return summarizeWeights(weights.data() + cell(i, 0), size, threshold);
+    }
+
+    WeightSummary<W> summary(W threshold) const {
+        return halveSummary(summarizeWeights(weights.data(), weights.size(), threshold));
+    }
+
+    size_t usedBytes() const {
+        return static_cast<size_t>(size) * size * (sizeof(uint8_t) + sizeof(W));
+    }
+
+    size_t capacityBytes() const {
+        return flags.capacity() * sizeof(uint8_t) + weights.capacity() * sizeof(W);
+    }
+};
+
+//====================================================================
+// TRIANGULAR STORAGE
+//====================================================================
+
+/**
+ * Packed lower triangle: the pair (i, j) with i > j lives at
+ * i * (i - 1) / 2 + j. Rows never move when cities are added, so
+ * growth only appends, and half the dense memory is needed.
+ */
+template <typename W>
+class TriangularStorage {
+private:
+    int size = 0;
+    GraphVector<uint8_t> flags;
+    GraphVector<W> weights;
+
+    static size_t cell(int i, int j) {
+        if (i < j) {
+            std::swap(i, j);
+        }
+        return static_cast<size_t>(i) * (i - 1) / 2 + j;
+    }
+
+public:
+    static constexpr StorageBackend backend = StorageBackend::Triangular;
+
+    void resize(int cityCount) {
+        size = cityCount;
+        flags.resize(static_cast<size_t>(cityCount) * (cityCount - 1) / 2, 0);
+        weights.resize(flags.size(), W());
+    }
+
+    void reset(int cityCount) {
+        flags.clear();
+        weights.clear();
+        resize(cityCount);
+    }
+
+    bool hasRoad(int i, int j) const {
+        return flags[cell(i, j)] != 0;
+    }
+
+    void addRoad(int i, int j) {
+        flags[cell(i, j)] = 1;
+    }
+
+    void removeRoad(int i, int j) {
+        flags[cell(i, j)] = 0;
+        weights[cell(i, j)] = W();
+    }
+
+    W weight(int i, int j) const {
+        return weights[cell(i, j)];
+    }
+
+    void setWeight(int i, int j, W w) {
+        weights[cell(i, j)] = w;
+    }
+
+    template <typename F>
+    void forEachNeighbor(int i, F&& f) const {
+        // Row i holds the pairs with smaller slots contiguously
+        size_t rowStart = static_cast<size_t>(i) * (i - 1) / 2;
+        for (int j = 0; j < i; ++j) {
+            if (flags[rowStart + j]) {
+                f(j, weights[rowStart + j]);
+            }
+        }
+        // Larger slots are found one row further down each time
+        for (int j = i + 1; j < size; ++j) {
+            size_t c = static_cast<size_t>(j) * (j - 1) / 2 + i;
+            if (flags[c]) {
+                f(j, weights[c]);
+            }
+        }
+    }
+
+    W rowTotal(int i) const {
+        W total = W();
+        forEachNeighbor(i, [&total](int, W w) { total += w; });
+        return total;
+    }
+
+    // Each pair is stored once and cells without a road hold zero
+    W totalWeight() const {
+        return sumWeights(weights.data(), weights.size());
+    }
+
+    WeightSummary<W> rowSummary(int i, W threshold) const {
+        WeightSummary<W> summary = {W(), W(), 0, 0};
+        forEachNeighbor(i, [&summary, threshold](int, W w) { summary.add(w, threshold); });
+        return summary;
+    }
+
+    WeightSummary<W> summary(W threshold) const {
+        return summarizeWeights(weights.data(), weights.size(), threshold);
+    }
+
+    size_t usedBytes() const {
+        return flags.size() * (sizeof(uint8_t) + sizeof(W));
+    }
+
+    size_t capacityBytes() const {
+        return flags.capacity() * sizeof(uint8_t) + weights.capacity() * sizeof(W);
+    }
+};
+
+//====================================================================
+// BITSET STORAGE
+//====================================================================
+
+/**
+ * One bit per pair in rows of 64-bit words, with the weights of
+ * existing roads in a hash map. Neighbor scans skip 64 empty pairs
+ * per word, and memory is dominated by n^2 / 8 bytes.
+ */
+template <typename W>
+class BitsetStorage {
+private:
+    int size = 0;
+    int wordsPerRow = 0;
+    GraphVector<uint64_t> bits;
+    std::unordered_map<uint64_t, W> weights;
+
+    static uint64_t key(int i, int j) {
+        return (static_cast<uint64_t>(std::min(i, j)) << 32) | static_cast<uint32_t>(std::max(i, j));
+    }
+
+    void grow(int words) {
+        RWANDA_TRACE_SCOPE("BitsetStorage::grow", "matrix growth");
+        GraphVector<uint64_t> newBits(static_cast<size_t>(words) * 64 * words, 0);
+        for (int i = 0; i < size; ++i) {
+            std::copy_n(bits.begin() + static_cast<size_t>(i) * wordsPerRow, wordsPerRow,
+                        newBits.begin() + static_cast<size_t>(i) * words);
+        }
+        bits.swap(newBits);
+        wordsPerRow = words;
+    }
+
+    void setBit(int i, int j) {
+        bits[static_cast<size_t>(i) * wordsPerRow + j / 64] |= uint64_t(1) << (j % 64);
+    }
+
+    void clearBit(int i, int j) {
+        bits[static_cast<size_t>(i) * wordsPerRow + j / 64] &= ~(uint64_t(1) << (j % 64));
+    }
+
+    template <typename U>
+    friend void bulkLoadStorage(BitsetStorage<U>& storage, int cityCount,
+                                const std::vector<std::pair<int, int>>& pairs,
+                                const std::vector<U>& pairWeights);
+
+public:
+    static constexpr StorageBackend backend = StorageBackend::Bitset;
+
+    // A weight map node holds the next pointer, the key and the
+    // weight; malloc adds a size word and rounds to 16 bytes
+    static constexpr size_t NODE_BYTES =
+        (sizeof(void*) + sizeof(uint64_t) + sizeof(W) + sizeof(size_t) + 15) / 16 * 16;
+
+    void resize(int cityCount) {
+        int words = (cityCount + 63) / 64;
+        if (words > wordsPerRow) {
+            grow(std::max(words, wordsPerRow * 2));
+        }
+        size = cityCount;
+    }
+
+    void reset(int cityCount) {
+        size = 0;
+        wordsPerRow = 0;
+        bits.clear();
+        weights.clear();
+        resize(cityCount);
+    }
+
+    bool hasRoad(int i, int j) const {
+        return (bits[static_cast<size_t>(i) * wordsPerRow + j / 64] >> (j % 64)) & 1;
+    }
+
+    void addRoad(int i, int j) {
+        setBit(i, j);
+        setBit(j, i);
+        weights.emplace(key(i, j), W());
+    }
+
+    void removeRoad(int i, int j) {
+        clearBit(i, j);
+        clearBit(j, i);
+        weights.erase(key(i, j));
+    }
+
+    W weight(int i, int j) const {
+        auto it = weights.find(key(i, j));
+        return it == weights.end() ? W() : it->second;
+    }
+
+    void setWeight(int i, int j, W w) {
+        weights[key(i, j)] = w;
+    }
+
+    template <typename F>
+    void forEachNeighbor(int i, F&& f) const {
+        const uint64_t* row = bits.data() + static_cast<size_t>(i) * wordsPerRow;
+        for (int word = 0; word < wordsPerRow; ++word) {
+            uint64_t remaining = row[word];
+            while (remaining) {
+                int j = word * 64 + __builtin_ctzll(remaining);
+                f(j, weight(i, j));
+                remaining &= remaining - 1;
+            }
+        }
+    }
+
+    W rowTotal(int i) const {
+        W total = W();
+        forEachNeighbor(i, [&total](int, W w) { total += w; });
+        return total;
+    }
+
+    W totalWeight() const {
+        W total = W();
+        for (const auto& entry : weights) {
+            total += entry.second;
+        }
+        return total;
+    }
+
+    WeightSummary<W> rowSummary(int i, W threshold) const {
+        WeightSummary<W> summary = {W(), W(), 0, 0};
+        forEachNeighbor(i, [&summary, threshold](int, W w) { summary.add(w, threshold); });
+        return summary;
+    }
+
+    WeightSummary<W> summary(W threshold) const {
+        WeightSummary<W> summary = {W(), W(), 0, 0};
+        for (const auto& entry : weights) {
+            summary.add(entry.second, threshold);
+        }
+        return summary;
+    }
+
+    size_t usedBytes() const {
+        return static_cast<size_t>(size) * wordsPerRow * sizeof(uint64_t)
+             + weights.size() * (sizeof(uint64_t) + sizeof(W));
+    }
+
+    size_t capacityBytes() const {
+        return bits.capacity() * sizeof(uint64_t)
+             + weights.bucket_count() * sizeof(void*)
+             + weights.size() * NODE_BYTES;
+    }
+};
+
+//====================================================================
+// CSR STORAGE
+//====================================================================
+
+/**
+ * Compressed sparse rows: the neighbors of slot i are
+ * neighbors[offsets[i] .. offsets[i + 1]), sorted, with their
+ * weights alongside. Memory and neighbor scans are proportional
+ * to the number of roads. Adding a single road shifts the arrays,
+ * so this layout suits bulk-loaded, read-mostly networks.
+ */
+template <typename W>
+class CsrStorage {
+private:
+    GraphVector<int> offsets = GraphVector<int>(1, 0);
+    GraphVector<int> neighbors;
+    GraphVector<W> weights;
+
+    /**
+     * Position of j in the row of i, or of where it would go
+     */
+    size_t find(int i, int j) const {
+        auto first = neighbors.begin() + offsets[i];
+        auto last = neighbors.begin() + offsets[i + 1];
+        return std::lower_bound(first, last, j) - neighbors.begin();
+    }
+
+    void insert(int i, int j) {
+        size_t position = find(i, j);
+        neighbors.insert(neighbors.begin() + position, j);
+        weights.insert(weights.begin() + position, W());
+        for (size_t r = i + 1; r < offsets.size(); ++r) {
+            offsets[r]++;
+        }
+    }
+
+    void erase(int i, int j) {
+        size_t position = find(i, j);
+        neighbors.erase(neighbors.begin() + position);
+        weights.erase(weights.begin() + position);
+        for (size_t r = i + 1; r < offsets.size(); ++r) {
+            offsets[r]--;
+        }
+    }
+
+    template <typename U>
+    friend void bulkLoadStorage(CsrStorage<U>& storage, int cityCount,
+                                const std::vector<std::pair<int, int>>& pairs,
+                                const std::vector<U>& pairWeights);
+
+public:
+    static constexpr StorageBackend backend = StorageBackend::Csr;
+
+    void resize(int cityCount) {
+        offsets.resize(cityCount + 1, offsets.back());
+    }
+
+    void reset(int cityCount) {
+        offsets.assign(cityCount + 1, 0);
+        neighbors.clear();
+        weights.clear();
+    }
+
+    bool hasRoad(int i, int j) const {
+        size_t position = find(i, j);
+        return position < static_cast<size_t>(offsets[i + 1]) && neighbors[position] == j;
+    }
+
+    void addRoad(int i, int j) {
+        insert(i, j);
+        insert(j, i);
+    }
+
+    void removeRoad(int i, int j) {
+        erase(i, j);
+        erase(j, i);
+    }
+
+    W weight(int i, int j) const {
+        size_t position = find(i, j);
+        bool found = position < static_cast<size_t>(offsets[i + 1]) && neighbors[position] == j;
+        return found ? weights[position] : W();
+    }
+
+    void setWeight(int i, int j, W w) {
+        weights[find(i, j)] = w;
+        weights[find(j, i)] = w;
+    }
+
+    template <typename F>
+    void forEachNeighbor(int i, F&& f) const {
+        for (int k = offsets[i]; k < offsets[i + 1]; ++k) {
+            f(neighbors[k], weights[k]);
+        }
+    }
+
+    W rowTotal(int i) const {
+        return sumWeights(weights.data() + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+
+    // Every road appears in the rows of both its cities
+    W totalWeight() const {
+        return sumWeights(weights.data(), weights.size()) / 2;
+    }
+
+    WeightSummary<W> rowSummary(int i, W threshold) const {
+        return summarizeWeights(weights.data() + offsets[i], offsets[i + 1] - offsets[i], threshold);
+    }
+
+    WeightSummary<W> summary(W threshold) const {
+        return halveSummary(summarizeWeights(weights.data(), weights.size(), threshold));
+    }
+
+    size_t usedBytes() const {
+        return offsets.size() * sizeof(int) + neighbors.size() * (sizeof(int) + sizeof(W));
+    }
+
+    size_t capacityBytes() const {
+        return offsets.capacity() * sizeof(int) + neighbors.capacity() * sizeof(int)
+             + weights.capacity() * sizeof(W);
+    }
+};
+
+//====================================================================
+// BULK LOADING
+//====================================================================
+
+/**
+ * Replaces the contents of a storage with the given roads
+ * Pairs must be distinct and connect different slots
+ */
+template <typename Storage, typename W>
+void bulkLoadStorage(Storage& storage, int cityCount,
+                     const std::vector<std::pair<int, int>>& pairs,
+                     const std::vector<W>& pairWeights) {
+    storage.reset(cityCount);
+    for (size_t k = 0; k < pairs.size(); ++k) {
+        storage.addRoad(pairs[k].first, pairs[k].second);
+        storage.setWeight(pairs[k].first, pairs[k].second, pairWeights[k]);
+    }
+}
+
+/**
+ * Bitset version: sizes the weight map for every pair up front, so
+ * loading never rehashes and the bucket array holds about one
+ * pointer per pair
+ */
+template <typename W>
+void bulkLoadStorage(BitsetStorage<W>& storage, int cityCount,
+                     const std::vector<std::pair<int, int>>& pairs,
+                     const std::vector<W>& pairWeights) {
+    storage.reset(cityCount);
+    storage.weights.reserve(pairs.size());
+    for (size_t k = 0; k < pairs.size(); ++k) {
+        storage.setBit(pairs[k].first, pairs[k].second);
+        storage.setBit(pairs[k].second, pairs[k].first);
+        storage.weights[BitsetStorage<W>::key(pairs[k].first, pairs[k].second)] = pairWeights[k];
+    }
+}
+
+/**
+ * CSR version: counts the roads per row, then fills each row and
+ * sorts it, in O(n + m log d) instead of shifting arrays per road
+ */
+template <typename W>
+void bulkLoadStorage(CsrStorage<W>& storage, int cityCount,
+                     const std::vector<std::pair<int, int>>& pairs,
+                     const std::vector<W>& pairWeights) {
+    storage.offsets.assign(cityCount + 1, 0);
+    for (const auto& pair : pairs) {
+        storage.offsets[pair.first + 1]++;
+        storage.offsets[pair.second + 1]++;
+    }
+    for (int i = 0; i < cityCount; ++i) {
+        storage.offsets[i + 1] += storage.offsets[i];
+    }
+
+    std::vector<std::pair<int, W>> entries(storage.offsets.back());
+    std::vector<int> next(storage.offsets.begin(), storage.offsets.end() - 1);
+    for (size_t k = 0; k < pairs.size(); ++k) {
+        entries[next[pairs[k].first]++] = {pairs[k].second, pairWeights[k]};
+        entries[next[pairs[k].second]++] = {pairs[k].first, pairWeights[k]};
+    }
+    for (int i = 0; i < cityCount; ++i) {
+        std::sort(entries.begin() + storage.offsets[i], entries.begin() + storage.offsets[i + 1],
+                  [](const std::pair<int, W>& a, const std::pair<int, W>& b) { return a.first < b.first; });
+    }
+
+    storage.neighbors.resize(entries.size());
+    storage.weights.resize(entries.size());
+    for (size_t k = 0; k < entries.size(); ++k) {
+        storage.neighbors[k] = entries[k].first;
+        storage.weights[k] = entries[k].second;
+    }
+}
+
+#endif // RWANDA_GRAPH_STORAGE_H
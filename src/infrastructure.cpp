@@ -0,0 +1,1269 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - core library
+ * 
+ * Implements city, road and budget management together with the
+ * console views and the text file persistence.
+ * 
+ * Data is persisted in real-time to text files:
+ * - cities.txt: Contains information about all cities
+ * - roads.txt: Contains information about roads and their budgets
+ *****************************************************************/
+
+#include "infrastructure.h"
+#include "metrics.h"
+#include "regions.h"
+#include "seed_data.h"
+#include "trace.h"
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <filesystem>
+#include <utility>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+//====================================================================
+// UTILITY FUNCTIONS
+//====================================================================
+
+string getAbsolutePath(const string& filename) {
+    fs::path currentPath = fs::current_path();
+    fs::path filePath = currentPath / filename;
+    return filePath.string();
+}
+
+//====================================================================
+// RWANDA INFRASTRUCTURE CLASS
+//====================================================================
+
+bool RwandaInfrastructure::matchesFilter(const Road& road, const RoadFilter& filter) const {
+    if (road.budget < filter.minBudget) {
+        return false;
+    }
+    if (filter.cityPrefix.empty()) {
+        return true;
+    }
+    const string& key1 = cities[road.city1 - 1].key;
+    const string& key2 = cities[road.city2 - 1].key;
+    return key1.compare(0, filter.cityPrefix.size(), filter.cityPrefix) == 0 ||
+           key2.compare(0, filter.cityPrefix.size(), filter.cityPrefix) == 0;
+}
+
+vector<size_t> RwandaInfrastructure::rangeSlots(int start, int count) const {
+    vector<size_t> slots;
+    // start + count can pass INT_MAX, so the end is clamped in 64 bits
+    int first = max(start, 1);
+    int64_t end = static_cast<int64_t>(start) + count - 1;
+    int last = static_cast<int>(min<int64_t>(end, cities.size()));
+    for (int idx = first; idx <= last; ++idx) {
+        slots.push_back(idx - 1);
+    }
+    return slots;
+}
+
+vector<size_t> RwandaInfrastructure::subsetSlots(const vector<int>& indices) const {
+    vector<size_t> slots;
+    for (int idx : indices) {
+        if (idx < 1 || idx > static_cast<int>(cities.size())) {
+            cout << "City with index " << idx << " not found, skipping." << endl;
+            continue;
+        }
+        slots.push_back(idx - 1);
+    }
+    return slots;
+}
+
+template <typename Cell>
+void RwandaInfrastructure::renderMatrixBlock(Cell cell,
+                                             const vector<size_t>& rows,
+                                             const vector<size_t>& cols,
+                                             int width) const {
+    cout << "    ";
+    for (size_t j : cols) {
+        cout << setw(width) << cities[j].index;
+    }
+    cout << endl;
+    
+    for (size_t i : rows) {
+        cout << setw(4) << cities[i].index;
+        for (size_t j : cols) {
+            cout << setw(width) << cell(i, j);
+        }
+        cout << endl;
+    }
+}
+
+RwandaInfrastructure::RwandaInfrastructure() {
+    // Initialize with empty matrices
+}
+
+void RwandaInfrastructure::reportMissingCity(const string& name) const {
+    cout << "City " << name << " not found.";
+    vector<NameMatch> matches = nameIndex.search(name, 3);
+    for (size_t i = 0; i < matches.size(); ++i) {
+        cout << (i == 0 ? " Did you mean " : (i + 1 == matches.size() ? " or " : ", "))
+             << cities[matches[i].city].name;
+    }
+    cout << (matches.empty() ? "" : "?") << endl;
+}
+
+void RwandaInfrastructure::indexName(int slot, const string& name) {
+    nameIndex.add(slot, name);
+    prefixes.add(slot, name);
+}
+
+void RwandaInfrastructure::unindexName(int slot, const string& name) {
+    nameIndex.remove(slot);
+    prefixes.remove(slot, name);
+}
+
+void RwandaInfrastructure::reportMissingCities(const string& city1, int idx1, const string& city2, int idx2) const {
+    if (idx1 == -1) {
+        reportMissingCity(city1);
+    }
+    if (idx2 == -1 && normalizeName(city2) != normalizeName(city1)) {
+        reportMissingCity(city2);
+    }
+}
+
+string RwandaInfrastructure::roadLabel(int roadId) const {
+    const Road& road = roads[roadId];
+    if (road.oneWay) {
+        return cities[road.city1 - 1].name + "->" + cities[road.city2 - 1].name;
+    }
+    int first = min(road.city1, road.city2);
+    int second = max(road.city1, road.city2);
+    return cities[first - 1].name + "-" + cities[second - 1].name;
+}
+
+int RwandaInfrastructure::resolveRoad(const string& city1, const string& city2, int roadNumber) const {
+    int idx1 = findCityIndex(city1);
+    int idx2 = findCityIndex(city2);
+    if (idx1 == -1 || idx2 == -1) {
+        reportMissingCities(city1, idx1, city2, idx2);
+        return -1;
+    }
+    
+    ParallelRoads between = roadsBetween(idx1 - 1, idx2 - 1);
+    if (between.empty()) {
+        cout << "No road exists between " << city1 << " and " << city2 << "." << endl;
+        return -1;
+    }
+    if (roadNumber == 0) {
+        if (between.size() > 1) {
+            cout << between.size() << " roads connect " << city1 << " and " << city2
+                 << "; choose one by its road number." << endl;
+            return -1;
+        }
+        return between.begin()->road;
+    }
+    for (const RoadLink& link : between) {
+        if (link.road + 1 == roadNumber) {
+            return link.road;
+        }
+    }
+    cout << "Road " << roadNumber << " does not connect " << city1 << " and " << city2 << "." << endl;
+    return -1;
+}
+
+bool RwandaInfrastructure::addCity(const string& name) {
+    RWANDA_TIME_OPERATION(Operation::AddCity);
+    
+    if (normalizeName(name).empty()) {
+        cout << "City name cannot be blank." << endl;
+        return false;
+    }
+    
+    // Check if city already exists
+    if (findCityIndex(name) != -1) {
+        cout << "City " << name << " already exists." << endl;
+        return false;
+    }
+    
+    // Grows the road storage along with the city list
+    int newIndex = appendCity(name);
+    locations.resize(cities.size());
+    indexName(newIndex - 1, name);
+    journal.record({MutationKind::AddCity, newIndex - 1, -1, -1, 0, 0, "", name});
+    
+    cout << "City " << name << " added with index " << newIndex << endl;
+    return true;
+}
+
+bool RwandaInfrastructure::addRoad(const string& city1, const string& city2, bool parallel, bool oneWay) {
+    RWANDA_TIME_OPERATION(Operation::AddRoad);
+    
+    int idx1 = findCityIndex(city1);
+    int idx2 = findCityIndex(city2);
+    
+    if (idx1 == -1 || idx2 == -1) {
+        reportMissingCities(city1, idx1, city2, idx2);
+        return false;
+    }
+    
+    if (idx1 == idx2) {
+        cout << "Cannot add a road between the same city." << endl;
+        return false;
+    }
+    
+    // Adjust for 0-based index in matrix
+    int i = idx1 - 1;
+    int j = idx2 - 1;
+    
+    if (slotsConnected(i, j) && !parallel) {
+        cout << "A road already exists between " << city1 << " and " << city2 << endl;
+        return false;
+    }
+    
+    int roadId = connectSlots(i, j, oneWay);
+    journal.record({MutationKind::AddRoad, i, j, roadId, 0, 0, "", "", oneWay});
+    
+    if (oneWay) {
+        cout << "One-way road " << roadId + 1 << " added from " << city1 << " to " << city2;
+    } else {
+        cout << "Road " << roadId + 1 << " added between " << city1 << " and " << city2;
+    }
+    size_t count = roadsBetween(i, j).size();
+    if (count > 1) {
+        cout << " (" << count << " roads between them)";
+    }
+    cout << endl;
+    return true;
+}
+
+bool RwandaInfrastructure::addBudget(const string& city1, const string& city2, Budget budget, int roadNumber) {
+    RWANDA_TIME_OPERATION(Operation::AddBudget);
+    
+    if (budget < 0) {
+        cout << "Budget cannot be negative." << endl;
+        return false;
+    }
+    
+    int roadId = resolveRoad(city1, city2, roadNumber);
+    if (roadId == -1) {
+        return false;
+    }
+    
+    // Adjust for 0-based index in matrix
+    int i = roads[roadId].city1 - 1;
+    int j = roads[roadId].city2 - 1;
+    journal.record({MutationKind::SetBudget, i, j, roadId, roads[roadId].budget, budget, "", ""});
+    setRoadBudget(roadId, budget);
+    
+    cout << "Budget of " << formatBudget(budget) << " billion RWF added for road between " 
+         << city1 << " and " << city2 << endl;
+    return true;
+}
+
+bool RwandaInfrastructure::editCity(const string& oldName, const string& newName) {
+    int idx = findCityIndex(oldName);
+    if (idx == -1) {
+        reportMissingCity(oldName);
+        return false;
+    }
+    
+    if (cities[idx - 1].name == newName) {
+        cout << "New name is the same as the old name." << endl;
+        return false;
+    }
+    
+    if (normalizeName(newName).empty()) {
+        cout << "City name cannot be blank." << endl;
+        return false;
+    }
+    
+    // Check if new name already exists; a city may take a name that
+    // differs from its own only in case, accents or blanks
+    int existing = findCityIndex(newName);
+    if (existing != -1 && existing != idx) {
+        cout << "City " << newName << " already exists." << endl;
+        return false;
+    }
+    
+    int slot = idx - 1;
+    string previous = cities[slot].name;
+    unindexName(slot, previous);
+    renameSlot(slot, newName);
+    indexName(slot, newName);
+    journal.record({MutationKind::RenameCity, slot, -1, -1, 0, 0, previous, newName});
+    cout << "City renamed from " << previous << " to " << newName << endl;
+    return true;
+}
+
+vector<int> RwandaInfrastructure::roadIdsBetween(const string& city1, const string& city2) const {
+    vector<int> ids;
+    int idx1 = findCityIndex(city1);
+    int idx2 = findCityIndex(city2);
+    if (idx1 == -1 || idx2 == -1) {
+        return ids;
+    }
+    for (const RoadLink& link : roadsBetween(idx1 - 1, idx2 - 1)) {
+        ids.push_back(link.road);
+    }
+    return ids;
+}
+
+void RwandaInfrastructure::displayRoadsBetween(const string& city1, const string& city2) {
+    vector<int> ids = roadIdsBetween(city1, city2);
+    if (ids.empty()) {
+        cout << "No road exists between " << city1 << " and " << city2 << "." << endl;
+        return;
+    }
+    
+    cout << "\nRoads between " << city1 << " and " << city2 << " (budgets in billion RWF):\n";
+    for (int id : ids) {
+        cout << "    Road " << left << setw(8) << id + 1 << right << setw(8) << formatBudget(roads[id].budget) << endl;
+    }
+}
+
+void RwandaInfrastructure::searchCityByIndex(int idx) {
+    for (const auto& city : cities) {
+        if (city.index == idx) {
+            cout << "City found: " << city.index << ": " << city.name << endl;
+            return;
+        }
+    }
+    cout << "City with index " << idx << " not found." << endl;
+}
+
+bool RwandaInfrastructure::undo() {
+    if (!journal.canUndo()) {
+        cout << "Nothing to undo." << endl;
+        return false;
+    }
+    
+    const Mutation& mutation = journal.undo();
+    switch (mutation.kind) {
+        case MutationKind::AddCity: {
+            RemovedDetails removed;
+            removed.district = cities[mutation.city].district;
+            removed.located = locations.hasLocation(mutation.city);
+            if (removed.located) {
+                removed.location = locations.location(mutation.city);
+            }
+            removeLastCity();
+            locations.resize(cities.size());
+            unindexName(mutation.city, mutation.newName);
+            cout << "Undid adding city " << mutation.newName << endl;
+            journal.keepRemoved(move(removed));
+            break;
+        }
+        case MutationKind::AddRoad: {
+            // Per-road data beyond the remaining roads belongs to this one
+            RemovedDetails removed;
+            if (attributes.size() > static_cast<size_t>(mutation.road)) {
+                removed.hasAttributes = true;
+                removed.attributes = attributes.get(mutation.road);
+            }
+            if (budgetHistory.roadCount() > static_cast<size_t>(mutation.road)) {
+                for (int year = budgetHistory.firstYear(); year <= budgetHistory.lastYear(); ++year) {
+                    Budget budget = budgetHistory.budget(mutation.road, year);
+                    if (budget != 0) {
+                        removed.yearBudgets.push_back({year, budget});
+                    }
+                }
+            }
+            removeLastRoad();
+            if (attributes.size() > roads.size()) {
+                attributes.resize(roads.size());
+                attributesRevision++;
+            }
+            budgetHistory.resize(roads.size());
+            cout << "Undid adding the road between " << cities[mutation.city].name
+                 << " and " << cities[mutation.otherCity].name << endl;
+            journal.keepRemoved(move(removed));
+            break;
+        }
+        case MutationKind::SetBudget:
+            setRoadBudget(mutation.road, mutation.oldBudget);
+            cout << "Budget of the road between " << cities[mutation.city].name << " and "
+                 << cities[mutation.otherCity].name << " restored to " << formatBudget(mutation.oldBudget) << " billion RWF" << endl;
+            break;
+        case MutationKind::RenameCity:
+            renameSlot(mutation.city, mutation.oldName);
+            unindexName(mutation.city, mutation.newName);
+            indexName(mutation.city, mutation.oldName);
+            cout << "City " << mutation.newName << " renamed back to " << mutation.oldName << endl;
+            break;
+    }
+    return true;
+}
+
+bool RwandaInfrastructure::redo() {
+    if (!journal.canRedo()) {
+        cout << "Nothing to redo." << endl;
+        return false;
+    }
+    
+    const Mutation& mutation = journal.redo();
+    switch (mutation.kind) {
+        case MutationKind::AddCity:
+            appendCity(mutation.newName);
+            locations.resize(cities.size());
+            indexName(mutation.city, mutation.newName);
+            if (mutation.removed) {
+                cities[mutation.city].district = mutation.removed->district;
+                districtsRevision++;
+                if (mutation.removed->located) {
+                    locations.setLocation(mutation.city, mutation.removed->location);
+                }
+            }
+            cout << "Redid adding city " << mutation.newName << endl;
+            break;
+        case MutationKind::AddRoad:
+            connectSlots(mutation.city, mutation.otherCity, mutation.oneWay);
+            if (mutation.removed) {
+                if (mutation.removed->hasAttributes) {
+                    attributes.resize(roads.size());
+                    attributes.set(mutation.road, mutation.removed->attributes);
+                    attributesRevision++;
+                }
+                budgetHistory.resize(roads.size());
+                for (const auto& [year, budget] : mutation.removed->yearBudgets) {
+                    budgetHistory.setBudget(mutation.road, year, budget);
+                }
+            }
+            cout << "Redid adding the road between " << cities[mutation.city].name
+                 << " and " << cities[mutation.otherCity].name << endl;
+            break;
+        case MutationKind::SetBudget:
+            setRoadBudget(mutation.road, mutation.newBudget);
+            cout << "Budget of the road between " << cities[mutation.city].name << " and "
+                 << cities[mutation.otherCity].name << " set again to " << formatBudget(mutation.newBudget) << " billion RWF" << endl;
+            break;
+        case MutationKind::RenameCity:
+            renameSlot(mutation.city, mutation.newName);
+            unindexName(mutation.city, mutation.oldName);
+            indexName(mutation.city, mutation.newName);
+            cout << "City " << mutation.oldName << " renamed again to " << mutation.newName << endl;
+            break;
+    }
+    return true;
+}
+
+void RwandaInfrastructure::setUndoLimit(size_t bytes) {
+    journal.setLimit(bytes);
+}
+
+bool RwandaInfrastructure::loadNetwork(const vector<string>& cityNames, const vector<Road>& newRoads) {
+    if (!BasicInfrastructure::loadNetwork(cityNames, newRoads)) {
+        return false;
+    }
+    journal.clear();
+    attributes.resize(0);
+    attributesRevision++;
+    budgetHistory = BudgetTimeSeries();
+    locations.clear();
+    locations.resize(cities.size());
+    nameIndex.clear();
+    for (const auto& city : cities) {
+        nameIndex.add(city.index - 1, city.name);
+    }
+    prefixes.build(cityNames);
+    return true;
+}
+
+bool RwandaInfrastructure::assignDistrict(const string& cityName, const string& districtName) {
+    int idx = findCityIndex(cityName);
+    if (idx == -1) {
+        reportMissingCity(cityName);
+        return false;
+    }
+    
+    int district = findDistrict(districtName);
+    if (district == -1) {
+        cout << "District " << districtName << " not found." << endl;
+        return false;
+    }
+    
+    cities[idx - 1].district = district;
+    districtsRevision++;
+    cout << cityName << " assigned to " << RWANDA_DISTRICTS[district].name << " district ("
+         << RWANDA_PROVINCES[RWANDA_DISTRICTS[district].province] << " province)" << endl;
+    return true;
+}
+
+vector<NameMatch> RwandaInfrastructure::findSimilarCities(const string& name, size_t limit) const {
+    return nameIndex.search(name, limit);
+}
+
+vector<string> RwandaInfrastructure::completeCityName(const string& prefix, size_t limit) const {
+    vector<string> completions;
+    for (int slot : prefixes.complete(prefix, limit)) {
+        completions.push_back(cities[slot].name);
+    }
+    return completions;
+}
+
+void RwandaInfrastructure::displaySimilarCities(const string& name) {
+    vector<NameMatch> matches = nameIndex.search(name, 10);
+    if (matches.empty()) {
+        cout << "No city names resemble " << name << "." << endl;
+        return;
+    }
+    
+    cout << "\n" << left << setw(8) << "Index" << setw(20) << "City" << right << setw(12) << "Similarity"
+         << setw(8) << "Edits" << endl;
+    cout << fixed << setprecision(2);
+    for (const auto& match : matches) {
+        cout << left << setw(8) << match.city + 1 << setw(20) << cities[match.city].name
+             << right << setw(12) << match.similarity << setw(8) << match.editDistance << endl;
+    }
+}
+
+bool RwandaInfrastructure::setCityLocation(const string& cityName, GeoPoint point) {
+    int idx = findCityIndex(cityName);
+    if (idx == -1) {
+        reportMissingCity(cityName);
+        return false;
+    }
+    
+    if (!locations.setLocation(idx - 1, point)) {
+        cout << "Latitude must be between -90 and 90 and longitude between -180 and 180." << endl;
+        return false;
+    }
+    cout << fixed << setprecision(4);
+    cout << cityName << " located at " << point.latitude << ", " << point.longitude << endl;
+    return true;
+}
+
+void RwandaInfrastructure::displayNearestCities(GeoPoint point, int count) {
+    if (count <= 0) {
+        cout << "Number of cities must be positive." << endl;
+        return;
+    }
+    vector<SpatialIndex::Neighbor> nearest = locations.nearest(point, count);
+    if (nearest.empty()) {
+        cout << "No cities have a location yet." << endl;
+        return;
+    }
+    
+    cout << "\n" << left << setw(8) << "Index" << setw(20) << "City" << right << setw(12) << "Distance" << endl;
+    cout << fixed << setprecision(1);
+    for (const auto& neighbor : nearest) {
+        cout << left << setw(8) << neighbor.city + 1 << setw(20) << cities[neighbor.city].name
+             << right << setw(9) << neighbor.distanceKm << " km" << endl;
+    }
+}
+
+void RwandaInfrastructure::displayCitiesInArea(const GeoBox& area) {
+    if (area.south > area.north || area.west > area.east) {
+        cout << "The south edge must not be north of the north edge, nor the west edge east of the east edge." << endl;
+        return;
+    }
+    vector<int> inside = locations.within(area);
+    if (inside.empty()) {
+        cout << "No cities in that area." << endl;
+        return;
+    }
+    
+    cout << "\n" << inside.size() << " cities in the area:\n";
+    cout << left << setw(8) << "Index" << setw(20) << "City" << right << setw(12) << "Latitude"
+         << setw(12) << "Longitude" << endl;
+    cout << fixed << setprecision(4);
+    for (int city : inside) {
+        GeoPoint point = locations.location(city);
+        cout << left << setw(8) << city + 1 << setw(20) << cities[city].name
+             << right << setw(12) << point.latitude << setw(12) << point.longitude << endl;
+    }
+}
+
+const RegionPartition& RwandaInfrastructure::regionPartition() {
+    // Both counters only grow, so their sum changes with either
+    size_t current = roadsRevision() + districtsRevision;
+    if (regionsRevision != current) {
+        regions = buildRegionPartition(cities, roads);
+        regionsRevision = current;
+    }
+    return regions;
+}
+
+const DirectedRoadGraph& RwandaInfrastructure::routeGraph() {
+    if (routesRevision != roadsRevision()) {
+        routes.build(cities.size(), roads);
+        routesRevision = roadsRevision();
+    }
+    return routes;
+}
+
+void RwandaInfrastructure::displayCheapestRoute(const string& from, const string& to) {
+    int idx1 = findCityIndex(from);
+    int idx2 = findCityIndex(to);
+    if (idx1 == -1 || idx2 == -1) {
+        reportMissingCities(from, idx1, to, idx2);
+        return;
+    }
+    
+    Route route = routeGraph().cheapestRoute(idx1 - 1, idx2 - 1);
+    if (route.cities.empty()) {
+        cout << "No route leads from " << from << " to " << to << "." << endl;
+        return;
+    }
+    
+    cout << "\nCheapest route from " << cities[idx1 - 1].name << " to " << cities[idx2 - 1].name << ": "
+         << formatBudget(static_cast<Budget>(route.cost)) << " billion RWF over " << route.roads.size()
+         << (route.roads.size() == 1 ? " road\n" : " roads\n");
+    for (size_t k = 0; k < route.roads.size(); ++k) {
+        cout << "    " << left << setw(20) << cities[route.cities[k]].name << "-> " << setw(20)
+             << cities[route.cities[k + 1]].name << "Road " << setw(6) << route.roads[k] + 1
+             << right << setw(8) << formatBudget(roads[route.roads[k]].budget) << endl;
+    }
+}
+
+bool RwandaInfrastructure::addYearBudget(const string& city1, const string& city2, int year, Budget budget,
+                                         int roadNumber) {
+    int roadId = resolveRoad(city1, city2, roadNumber);
+    if (roadId == -1) {
+        return false;
+    }
+    
+    budgetHistory.resize(roads.size());
+    if (!budgetHistory.setBudget(roadId, year, budget)) {
+        cout << "Invalid year or budget: years run from " << BudgetTimeSeries::MIN_YEAR << " to "
+             << BudgetTimeSeries::MAX_YEAR << " and budgets cannot be negative." << endl;
+        return false;
+    }
+    cout << "Budget for " << year << " recorded for the road between " << city1 << " and " << city2 << endl;
+    return true;
+}
+
+void RwandaInfrastructure::displayBudgetHistory() {
+    if (budgetHistory.yearCount() == 0) {
+        cout << "No yearly budgets recorded yet." << endl;
+        return;
+    }
+    
+    vector<Budget> totals = budgetHistory.yearTotals();
+    
+    cout << "\nBudget history (" << budgetHistory.firstYear() << "-" << budgetHistory.lastYear() << "):\n";
+    cout << left << setw(8) << "Year" << right << setw(14) << "Total"
+         << setw(14) << "Change" << setw(16) << "Cumulative" << endl;
+    Budget cumulative = 0;
+    for (int y = 0; y < budgetHistory.yearCount(); ++y) {
+        Budget change = totals[y] - (y > 0 ? totals[y - 1] : 0);
+        cumulative += totals[y];
+        cout << left << setw(8) << budgetHistory.firstYear() + y << right
+             << setw(14) << formatBudget(totals[y])
+             << setw(14) << formatBudget(change)
+             << setw(16) << formatBudget(cumulative) << endl;
+    }
+}
+
+void RwandaInfrastructure::displayYearOverYear(int year) {
+    if (!budgetHistory.hasYear(year)) {
+        cout << "No budgets recorded for " << year << "." << endl;
+        return;
+    }
+    
+    vector<Budget> changes = budgetHistory.yearOverYear(year);
+    vector<Budget> current = budgetHistory.yearBudgets(year);
+    
+    cout << "\nBudget changes from " << year - 1 << " to " << year << ":\n";
+    cout << left << setw(30) << "Road" << right << setw(14) << "Budget" << setw(14) << "Change" << endl;
+    int listed = 0;
+    for (size_t id = 0; id < changes.size(); ++id) {
+        if (changes[id] == 0) {
+            continue;
+        }
+        cout << left << setw(30) << roadLabel(id)
+             << right << setw(14) << formatBudget(current[id]) << setw(14) << formatBudget(changes[id]) << endl;
+        listed++;
+    }
+    if (listed == 0) {
+        cout << "No road budget changed." << endl;
+    }
+}
+
+bool RwandaInfrastructure::setRoadAttributes(const string& city1, const string& city2,
+                                             const RoadAttributes& values, int roadNumber) {
+    int roadId = resolveRoad(city1, city2, roadNumber);
+    if (roadId == -1) {
+        return false;
+    }
+    
+    attributes.resize(roads.size());
+    if (!attributes.set(roadId, values)) {
+        cout << "Invalid road attributes: lanes must be 0-255 and condition 0-"
+             << RoadAttributeStore::MAX_CONDITION << "." << endl;
+        return false;
+    }
+    attributesRevision++;
+    cout << "Attributes recorded for the road between " << city1 << " and " << city2 << endl;
+    return true;
+}
+
+void RwandaInfrastructure::displayRoadsBySurface(const string& surface, int conditionBelow) {
+    int code = attributes.surfaceCode(surface);
+    if (code == -1) {
+        cout << "No roads with surface " << surface << "." << endl;
+        return;
+    }
+    
+    attributes.resize(roads.size());
+    vector<int> selected = attributes.roadsWithSurface(code);
+    if (conditionBelow > 0) {
+        selected = attributes.ratedBelow(selected, conditionBelow);
+    }
+    if (selected.empty()) {
+        cout << "No matching roads." << endl;
+        return;
+    }
+    
+    cout << "\n" << attributes.surfaceName(code) << " roads";
+    if (conditionBelow > 0) {
+        cout << " rated below " << conditionBelow;
+    }
+    cout << " (" << selected.size() << "):\n";
+    cout << left << setw(30) << "Road" << right << setw(10) << "Km" << setw(8) << "Lanes"
+         << setw(11) << "Condition" << setw(12) << "Budget" << endl;
+    cout << fixed << setprecision(1);
+    for (int id : selected) {
+        const Road& road = roads[id];
+        RoadAttributes values = attributes.get(id);
+        cout << left << setw(30) << roadLabel(id)
+             << right << setw(10) << values.lengthKm << setw(8) << values.lanes << setw(11);
+        if (values.condition == RoadAttributeStore::NOT_RATED) {
+            cout << "-";
+        } else {
+            cout << values.condition;
+        }
+        cout << setw(12) << formatBudget(road.budget) << endl;
+    }
+}
+
+void RwandaInfrastructure::displayCities() {
+    if (cities.empty()) {
+        cout << "No cities recorded yet." << endl;
+        return;
+    }
+    
+    cout << "\nCities:\n";
+    for (const auto& city : cities) {
+        cout << city.index << ": " << city.name;
+        if (city.district >= 0) {
+            cout << " (" << RWANDA_DISTRICTS[city.district].name << ")";
+        }
+        cout << endl;
+    }
+}
+
+void RwandaInfrastructure::displayRoads() {
+    if (cities.empty()) {
+        cout << "No cities recorded yet." << endl;
+        return;
+    }
+    
+    int size = cities.size();
+    if (size > MAX_FULL_MATRIX_CITIES) {
+        cout << "\nNetwork has " << size << " cities, showing the first "
+             << MAX_FULL_MATRIX_CITIES << ". Use the matrix window view to page through it." << endl;
+        size = MAX_FULL_MATRIX_CITIES;
+    }
+    displayRoadsWindow({1, size, 1, size});
+}
+
+void RwandaInfrastructure::displayBudgets() {
+    if (cities.empty()) {
+        cout << "No cities recorded yet." << endl;
+        return;
+    }
+    
+    int size = cities.size();
+    if (size > MAX_FULL_MATRIX_CITIES) {
+        cout << "\nNetwork has " << size << " cities, showing the first "
+             << MAX_FULL_MATRIX_CITIES << ". Use the matrix window view to page through it." << endl;
+        size = MAX_FULL_MATRIX_CITIES;
+    }
+    displayBudgetsWindow({1, size, 1, size});
+}
+
+void RwandaInfrastructure::displayRoadsWindow(const MatrixWindow& window) {
+    vector<size_t> rows = rangeSlots(window.rowStart, window.rowCount);
+    vector<size_t> cols = rangeSlots(window.colStart, window.colCount);
+    if (rows.empty() || cols.empty()) {
+        cout << "Window is outside the matrix." << endl;
+        return;
+    }
+    
+    cout << "\nRoads Adjacency Matrix (rows " << cities[rows.front()].index << "-" << cities[rows.back()].index
+         << ", columns " << cities[cols.front()].index << "-" << cities[cols.back()].index << "):\n";
+    renderMatrixBlock([this](size_t i, size_t j) { return slotsConnected(i, j) ? roadsBetween(i, j).size() : 0; },
+                      rows, cols, 4);
+}
+
+void RwandaInfrastructure::displayBudgetsWindow(const MatrixWindow& window) {
+    vector<size_t> rows = rangeSlots(window.rowStart, window.rowCount);
+    vector<size_t> cols = rangeSlots(window.colStart, window.colCount);
+    if (rows.empty() || cols.empty()) {
+        cout << "Window is outside the matrix." << endl;
+        return;
+    }
+    
+    cout << "\nBudgets Adjacency Matrix (in billion RWF, rows " << cities[rows.front()].index << "-"
+         << cities[rows.back()].index << ", columns " << cities[cols.front()].index << "-"
+         << cities[cols.back()].index << "):\n";
+    renderMatrixBlock([this](size_t i, size_t j) { return formatBudget(pairWeight(i, j)); },
+                      rows, cols, 12);
+}
+
+void RwandaInfrastructure::displayRoadsSubset(const vector<int>& indices) {
+    vector<size_t> slots = subsetSlots(indices);
+    if (slots.empty()) {
+        cout << "No valid cities selected." << endl;
+        return;
+    }
+    
+    cout << "\nRoads Adjacency Matrix (selected cities):\n";
+    renderMatrixBlock([this](size_t i, size_t j) { return slotsConnected(i, j) ? roadsBetween(i, j).size() : 0; },
+                      slots, slots, 4);
+}
+
+void RwandaInfrastructure::displayBudgetsSubset(const vector<int>& indices) {
+    vector<size_t> slots = subsetSlots(indices);
+    if (slots.empty()) {
+        cout << "No valid cities selected." << endl;
+        return;
+    }
+    
+    cout << "\nBudgets Adjacency Matrix (in billion RWF, selected cities):\n";
+    renderMatrixBlock([this](size_t i, size_t j) { return formatBudget(pairWeight(i, j)); },
+                      slots, slots, 12);
+}
+
+void RwandaInfrastructure::displayNeighbors(const RoadFilter& filter) {
+    RWANDA_TRACE_SCOPE("displayNeighbors", "analytics");
+    
+    if (cities.empty()) {
+        cout << "No cities recorded yet." << endl;
+        return;
+    }
+    
+    RoadFilter keyed = {filter.minBudget, normalizeName(filter.cityPrefix)};
+    cout << "\nNeighbors (budgets in billion RWF):\n";
+    int listed = 0;
+    for (size_t i = 0; i < cities.size(); ++i) {
+        bool headerPrinted = false;
+        for (const RoadLink& link : adjacency[i]) {
+            const Road& road = roads[link.road];
+            if (!matchesFilter(road, keyed)) {
+                continue;
+            }
+            if (!headerPrinted) {
+                cout << cities[i].index << ": " << cities[i].name << endl;
+                headerPrinted = true;
+                listed++;
+            }
+            // One-way roads into the city are marked <-
+            bool inbound = road.oneWay && road.city2 - 1 == static_cast<int>(i);
+            cout << (inbound ? "    <- " : "    -> ") << left << setw(20) << cities[link.neighbor].name << right
+                 << setw(8) << formatBudget(road.budget) << endl;
+        }
+    }
+    if (listed == 0) {
+        cout << "No roads match the filter." << endl;
+    }
+}
+
+void RwandaInfrastructure::displayEdgeList(const RoadFilter& filter, bool byBudget) {
+    RWANDA_TRACE_SCOPE("displayEdgeList", "analytics");
+    
+    RoadFilter keyed = {filter.minBudget, normalizeName(filter.cityPrefix)};
+    vector<int> selected;
+    {
+        RWANDA_TRACE_SCOPE("filter roads", "analytics");
+        for (size_t id = 0; id < roads.size(); ++id) {
+            if (matchesFilter(roads[id], keyed)) {
+                selected.push_back(id);
+            }
+        }
+    }
+    if (selected.empty()) {
+        cout << "No roads match the filter." << endl;
+        return;
+    }
+    
+    {
+        RWANDA_TRACE_SCOPE("sort roads", "analytics");
+        if (byBudget) {
+            stable_sort(selected.begin(), selected.end(), [this](int a, int b) {
+                return roads[a].budget > roads[b].budget;
+            });
+        } else {
+            sort(selected.begin(), selected.end(), [this](int a, int b) {
+                int a1 = min(roads[a].city1, roads[a].city2), a2 = max(roads[a].city1, roads[a].city2);
+                int b1 = min(roads[b].city1, roads[b].city2), b2 = max(roads[b].city1, roads[b].city2);
+                return a1 != b1 ? a1 < b1 : a2 < b2;
+            });
+        }
+    }
+    
+    RWANDA_TRACE_SCOPE("print roads", "analytics");
+    cout << "\nRoads (" << selected.size() << " of " << roads.size() << ", budgets in billion RWF):\n";
+    for (int id : selected) {
+        cout << left << setw(30) << roadLabel(id) << right << setw(8) << formatBudget(roads[id].budget) << endl;
+    }
+}
+
+NetworkSnapshot RwandaInfrastructure::snapshot() const {
+    NetworkSnapshot copy;
+    copy.cityNames.reserve(cities.size());
+    for (const auto& city : cities) {
+        copy.cityNames.push_back(city.name);
+    }
+    copy.roads = roads;
+    return copy;
+}
+
+RoadTable RwandaInfrastructure::roadTable() const {
+    RWANDA_TRACE_SCOPE("roadTable", "analytics");
+    RoadTable table;
+    size_t count = roads.size();
+    table.city1.resize(count);
+    table.city2.resize(count);
+    table.budget.resize(count);
+    table.district1.resize(count);
+    table.district2.resize(count);
+    for (size_t id = 0; id < count; ++id) {
+        const Road& road = roads[id];
+        table.city1[id] = road.city1 - 1;
+        table.city2[id] = road.city2 - 1;
+        table.budget[id] = road.budget;
+        table.district1[id] = cities[road.city1 - 1].district;
+        table.district2[id] = cities[road.city2 - 1].district;
+    }
+    
+    // Roads without recorded attributes get the store's defaults
+    size_t recorded = min(count, attributes.size());
+    table.length.assign(attributes.lengthColumn().begin(), attributes.lengthColumn().begin() + recorded);
+    table.surface.assign(attributes.surfaceColumn().begin(), attributes.surfaceColumn().begin() + recorded);
+    table.lanes.assign(attributes.laneColumn().begin(), attributes.laneColumn().begin() + recorded);
+    table.condition.assign(attributes.conditionColumn().begin(), attributes.conditionColumn().begin() + recorded);
+    table.length.resize(count, 0.0f);
+    table.surface.resize(count, 0);
+    table.lanes.resize(count, 0);
+    table.condition.resize(count, RoadAttributeStore::NOT_RATED);
+    return table;
+}
+
+const RoadTable& RwandaInfrastructure::cachedRoadTable() {
+    // The counters only grow, so their sum changes with any of them
+    size_t current = roadsRevision() + districtsRevision + attributesRevision;
+    if (queryTableRevision != current) {
+        queryTable = roadTable();
+        queryTableRevision = current;
+    }
+    return queryTable;
+}
+
+QueryResult RwandaInfrastructure::queryRoads(RoadQuery query) {
+    for (QueryPredicate& predicate : query.predicates) {
+        string kind;
+        switch (predicate.field) {
+            case QueryField::City: {
+                int idx = findCityIndex(predicate.text);
+                predicate.code = idx == -1 ? -1 : idx - 1;
+                kind = "City";
+                break;
+            }
+            case QueryField::District:
+                predicate.code = findDistrict(predicate.text);
+                kind = "District";
+                break;
+            case QueryField::Province:
+                predicate.code = findProvince(predicate.text);
+                kind = "Province";
+                break;
+            case QueryField::Surface:
+                predicate.code = attributes.surfaceCode(predicate.text);
+                kind = "Surface";
+                break;
+            default:
+                continue;
+        }
+        if (predicate.code == -1) {
+            QueryResult failed;
+            failed.error = kind + " " + predicate.text + " not found.";
+            return failed;
+        }
+    }
+    return executeRoadQuery(cachedRoadTable(), query);
+}
+
+void RwandaInfrastructure::runRoadQuery(const string& text) {
+    RoadQuery query;
+    string error;
+    if (!parseRoadQuery(text, query, error)) {
+        cout << "Invalid query: " << error << "." << endl;
+        return;
+    }
+    
+    QueryResult result = queryRoads(query);
+    if (!result.error.empty()) {
+        cout << result.error << endl;
+        return;
+    }
+    
+    if (query.aggregate == QueryAggregate::List) {
+        if (result.roadIds.empty()) {
+            cout << "No roads match the query." << endl;
+            return;
+        }
+        cout << "\nRoads (" << result.roadIds.size() << " of " << roads.size() << ", budgets in billion RWF):\n";
+        for (int id : result.roadIds) {
+            cout << left << setw(30) << roadLabel(id) << right << setw(8) << formatBudget(roads[id].budget) << endl;
+        }
+        return;
+    }
+    
+    const char* heading[] = {"", "Count", "Sum", "Average", "Min", "Max"};
+    cout << "\n" << left << setw(20) << (query.grouping == QueryGrouping::None ? "" : "Group")
+         << right << setw(12) << heading[static_cast<int>(query.aggregate)] << endl;
+    for (const QueryGroup& group : result.groups) {
+        string label;
+        if (query.grouping == QueryGrouping::BudgetBucket) {
+            label = formatBudget(group.key * query.bucketWidth) + "-" + formatBudget((group.key + 1) * query.bucketWidth);
+        } else if (query.grouping == QueryGrouping::Surface) {
+            label = attributes.surfaceName(group.key);
+        } else {
+            label = "All matching roads";
+        }
+        cout << left << setw(20) << label << right << setw(12);
+        switch (query.aggregate) {
+            case QueryAggregate::Count:   cout << group.count; break;
+            case QueryAggregate::Sum:     cout << formatBudget(group.sum); break;
+            case QueryAggregate::Average:
+                // Rounded to the nearest thousand RWF
+                cout << formatBudget(group.count ? (group.sum + static_cast<Budget>(group.count) / 2) /
+                                                   static_cast<Budget>(group.count) : 0);
+                break;
+            case QueryAggregate::Min:     cout << formatBudget(group.min); break;
+            case QueryAggregate::Max:     cout << formatBudget(group.max); break;
+            case QueryAggregate::List:    break;
+        }
+        cout << endl;
+    }
+}
+
+vector<MemoryUsage> RwandaInfrastructure::memoryUsage() const {
+    RWANDA_TRACE_SCOPE("memoryUsage", "analytics");
+    vector<MemoryUsage> usage;
+    
+    usage.push_back({"cities", cities.size() * sizeof(City), cities.capacity() * sizeof(City)});
+    
+    // Only names and keys longer than the small string buffer allocate
+    size_t inlineCapacity = string().capacity();
+    MemoryUsage names = {"city names", 0, 0};
+    for (const auto& city : cities) {
+        for (const string* text : {&city.name, &city.key}) {
+            if (text->capacity() > inlineCapacity) {
+                names.usedBytes += text->size() + 1;
+                names.capacityBytes += text->capacity() + 1;
+            }
+        }
+    }
+    usage.push_back(names);
+    
+    usage.push_back({"city keys", keyIndex.usedBytes(), keyIndex.capacityBytes()});
+    
+    usage.push_back({"road storage", storage.usedBytes(), storage.capacityBytes()});
+    
+    usage.push_back({"storage order", (slotRows.size() + rowSlots.size()) * sizeof(int), storageOrderBytes()});
+    
+    usage.push_back({"roads", roads.size() * sizeof(Road), roads.capacity() * sizeof(Road)});
+    
+    MemoryUsage lists = {"adjacency", adjacency.size() * sizeof(vector<RoadLink>),
+                         adjacency.capacity() * sizeof(vector<RoadLink>)};
+    for (const auto& list : adjacency) {
+        lists.usedBytes += list.size() * sizeof(RoadLink);
+        lists.capacityBytes += list.capacity() * sizeof(RoadLink);
+    }
+    usage.push_back(lists);
+    
+    usage.push_back({"road attributes", attributes.usedBytes(), attributes.capacityBytes()});
+    
+    usage.push_back({"budget history", budgetHistory.usedBytes(), budgetHistory.capacityBytes()});
+    
+    usage.push_back({"undo journal", journal.usedBytes(), journal.usedBytes()});
+    
+    usage.push_back({"spatial index", locations.usedBytes(), locations.capacityBytes()});
+    
+    usage.push_back({"name index", nameIndex.usedBytes(), nameIndex.capacityBytes()});
+    
+    usage.push_back({"prefix index", prefixes.usedBytes(), prefixes.capacityBytes()});
+    
+    usage.push_back({"route arcs", routes.usedBytes(), routes.capacityBytes()});
+    
+    usage.push_back({"region partition", regions.usedBytes(), regions.capacityBytes()});
+    usage.push_back({"query table", queryTable.usedBytes(), queryTable.capacityBytes()});
+    
+    return usage;
+}
+
+void RwandaInfrastructure::displayRegionReport() {
+    if (cities.empty()) {
+        cout << "No cities recorded yet." << endl;
+        return;
+    }
+    
+    const RegionPartition& partition = regionPartition();
+    
+    cout << "\nRegional report (" << cities.size() << " cities, " << roads.size() << " roads):\n";
+    cout << left << setw(22) << "Region" << right << setw(8) << "Cities"
+         << setw(8) << "Roads" << setw(12) << "Budget" << endl;
+    for (int p = 0; p < PROVINCE_COUNT; ++p) {
+        cout << left << setw(22) << RWANDA_PROVINCES[p] << right
+             << setw(8) << partition.provinceCityCount(p)
+             << setw(8) << partition.provinceRoadCount(p)
+             << setw(12) << formatBudget(partition.provinceBudget(p)) << endl;
+        for (int d = provinceFirstDistrict(p); d < provinceFirstDistrict(p + 1); ++d) {
+            if (partition.districtCityCount(d) == 0) {
+                continue;
+            }
+            cout << left << setw(22) << string("  ") + RWANDA_DISTRICTS[d].name << right
+                 << setw(8) << partition.districtCityCount(d)
+                 << setw(8) << partition.districtEdgeOffsets[d + 1] - partition.districtEdgeOffsets[d]
+                 << setw(12) << formatBudget(partition.districtBudget(d)) << endl;
+        }
+    }
+    cout << left << setw(22) << "Between provinces" << right << setw(8) << ""
+         << setw(8) << partition.crossEdges.size()
+         << setw(12) << formatBudget(partition.crossBudget()) << endl;
+    if (partition.districtCityCount(UNASSIGNED_DISTRICT) > 0) {
+        // Roads with at least one end outside every district
+        cout << left << setw(22) << "No district" << right
+             << setw(8) << partition.districtCityCount(UNASSIGNED_DISTRICT)
+             << setw(8) << partition.unassignedEdges.size()
+             << setw(12) << formatBudget(partition.unassignedBudget()) << endl;
+    }
+}
+
+void RwandaInfrastructure::displayBudgetSummary(Budget threshold) {
+    if (cities.empty()) {
+        cout << "No cities recorded yet." << endl;
+        return;
+    }
+    
+    int size = cities.size();
+    if (size > MAX_FULL_MATRIX_CITIES) {
+        cout << "\nNetwork has " << size << " cities, showing the first "
+             << MAX_FULL_MATRIX_CITIES << "." << endl;
+        size = MAX_FULL_MATRIX_CITIES;
+    }
+    
+    string atLeastLabel = ">= " + formatBudget(threshold);
+    cout << "\nBudget summary (in billion RWF):\n";
+    cout << left << setw(22) << "City" << right << setw(12) << "Total" << setw(12) << "Largest"
+         << setw(8) << "Funded" << setw(12) << atLeastLabel << endl;
+    for (int i = 0; i < size; ++i) {
+        WeightSummary<Budget> summary = citySummary(i, threshold);
+        cout << left << setw(22) << cities[i].name << right
+             << setw(12) << formatBudget(summary.total)
+             << setw(12) << formatBudget(summary.max)
+             << setw(8) << summary.funded
+             << setw(12) << summary.atLeast << endl;
+    }
+    
+    WeightSummary<Budget> network = networkSummary(threshold);
+    cout << left << setw(22) << "Network" << right
+         << setw(12) << formatBudget(network.total)
+         << setw(12) << formatBudget(network.max)
+         << setw(8) << network.funded
+         << setw(12) << network.atLeast << endl;
+    cout << "(" << budgetKernelName(budgetKernelLevel()) << " kernels)" << endl;
+}
+
+void RwandaInfrastructure::reorderRoadStorage(CityOrder order) {
+    if (cities.empty()) {
+        cout << "No cities recorded yet." << endl;
+        return;
+    }
+    
+    OrderSpread before = storageSpread();
+    reorderStorage(order);
+    OrderSpread after = storageSpread();
+    
+    cout << "\nRoad storage is now in "
+         << (order == CityOrder::ReverseCuthillMcKee ? "reverse Cuthill-McKee" : "insertion") << " order." << endl;
+    cout << fixed << setprecision(1);
+    cout << "Largest row distance of a road: " << before.bandwidth << " -> " << after.bandwidth << endl;
+    cout << "Average row distance of a road: " << before.averageSpan << " -> " << after.averageSpan << endl;
+    cout << "City indices are unchanged." << endl;
+}
+
+void RwandaInfrastructure::displayAllData() {
+    displayCities();
+    displayRoads();
+    displayBudgets();
+}
+
+void RwandaInfrastructure::saveToFiles() {
+    RWANDA_TIME_OPERATION(Operation::SaveToFiles);
+    
+    // Get absolute paths for files
+    string cityFilePath = getAbsolutePath("cities.txt");
+    string roadFilePath = getAbsolutePath("roads.txt");
+    
+    // Save cities to cities.txt
+    RWANDA_TRACE_SCOPE("saveToFiles", "save");
+    ofstream cityFile(cityFilePath);
+    if (!cityFile.is_open()) {
+        cerr << "Error: Could not open cities.txt for writing!" << endl;
+        return;
+    }
+    
+    // Write header and city data in the layout readSnapshot reads
+    writeCityHeader(cityFile);
+    for (const auto& city : cities) {
+        writeCityRow(cityFile, city.index, city.name);
+    }
+    cityFile.close();
+    
+    // Save roads to roads.txt
+    ofstream roadFile(roadFilePath);
+    if (!roadFile.is_open()) {
+        cerr << "Error: Could not open roads.txt for writing!" << endl;
+        return;
+    }
+    
+    writeRoadHeader(roadFile);
+    // One row per road, parallel roads in the order they were added;
+    // one-way roads are written "From->To"
+    int counter = 1;
+    for (int i = 0; i < cityCount(); ++i) {
+        for (const RoadLink& link : adjacency[i]) {
+            if (link.neighbor > i) {
+                writeRoadRow(roadFile, counter++, roadLabel(link.road), roads[link.road].budget);
+            }
+        }
+    }
+    roadFile.close();
+}
+
+void RwandaInfrastructure::loadInitialData() {
+    RWANDA_TRACE_SCOPE("loadInitialData", "load");
+    
+    // Build the seed network in one pass from the compile-time tables
+    vector<string> seedNames;
+    seedNames.reserve(SEED_CITY_COUNT);
+    for (const SeedCity& city : SEED_CITIES) {
+        seedNames.push_back(city.name);
+    }
+    vector<Road> seedRoads;
+    seedRoads.reserve(SEED_ROAD_COUNT);
+    for (const SeedRoad& road : SEED_ROADS) {
+        seedRoads.push_back({road.city1, road.city2, road.budget});
+    }
+    loadNetwork(seedNames, seedRoads);
+    for (int i = 0; i < SEED_CITY_COUNT; ++i) {
+        cities[i].district = SEED_CITIES[i].district;
+        locations.setLocation(i, {SEED_CITIES[i].latitude, SEED_CITIES[i].longitude});
+    }
+    
+    // Only write the seed files when they are missing
+    if (!fs::exists(getAbsolutePath("cities.txt")) || !fs::exists(getAbsolutePath("roads.txt"))) {
+        saveToFiles();
+    }
+}
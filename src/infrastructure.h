@@ -0,0 +1,486 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - core library
+ * 
+ * Declares the data structures and the RwandaInfrastructure class
+ * that holds the cities, the road network and the road budgets.
+ * The interactive menu and the benchmarks are built on top of it.
+ *****************************************************************/
+
+#ifndef RWANDA_INFRASTRUCTURE_H
+#define RWANDA_INFRASTRUCTURE_H
+
+#include "budget_history.h"
+#include "directed_graph.h"
+#include "graph_engine.h"
+#include "journal.h"
+#include "prefix_index.h"
+#include "regions.h"
+#include "road_attributes.h"
+#include "road_query.h"
+#include "snapshot.h"
+#include "spatial_index.h"
+#include "trigram_index.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Gets the absolute path of a file relative to the current directory
+ * @param filename The name of the file
+ * @return The absolute path as a string
+ */
+std::string getAbsolutePath(const std::string& filename);
+
+//====================================================================
+// STRUCTURES
+//====================================================================
+
+/**
+ * Describes a rectangular block of a matrix to display
+ * Rows and columns are given as 1-based city indices
+ */
+struct MatrixWindow {
+    int rowStart;
+    int rowCount;
+    int colStart;
+    int colCount;
+};
+
+/**
+ * Restricts which roads are listed by the sparse views
+ * A road matches when its budget is at least minBudget and one of
+ * its cities starts with cityPrefix (an empty prefix matches all);
+ * names are compared as normalized keys, so case, accents and extra
+ * blanks do not matter
+ */
+struct RoadFilter {
+    Budget minBudget;
+    std::string cityPrefix;
+};
+
+/**
+ * Memory held by one part of the graph state
+ * usedBytes counts live elements, capacityBytes what is allocated
+ * (allocator bookkeeping is not included, except in the bitset
+ * storage's map nodes, where it is most of the cost)
+ */
+struct MemoryUsage {
+    std::string structure;
+    size_t usedBytes;
+    size_t capacityBytes;
+};
+
+//====================================================================
+// RWANDA INFRASTRUCTURE CLASS
+//====================================================================
+
+/**
+ * Main class for managing Rwanda's infrastructure data
+ * Handles cities, roads, and budget allocations
+ * Roads and budgets are kept in flat dense storage; the console
+ * messages, views and file persistence are added on top of the
+ * graph engine
+ */
+class RwandaInfrastructure : public BasicInfrastructure<DenseStorage, Budget> {
+private:
+    RoadAttributeStore attributes;      // Length, surface, lanes and condition by road id
+    BudgetTimeSeries budgetHistory;     // Budgets per road and fiscal year
+    MutationJournal journal;            // Undo and redo of the edits below
+    SpatialIndex locations;             // Coordinates by city slot
+    TrigramIndex nameIndex;             // Trigrams of the city names, for suggestions
+    PrefixIndex prefixes;               // Sorted city names, for completion
+    DirectedRoadGraph routes;           // Out- and in-arcs of the roads, for routing
+    size_t routesRevision = SIZE_MAX;   // roadsRevision() the arcs were built from
+    RegionPartition regions;            // Cities and roads grouped by district, for the regional report
+    size_t districtsRevision = 0;       // Changes whenever a city is placed in a district
+    size_t regionsRevision = SIZE_MAX;  // roadsRevision() + districtsRevision the partition was built from
+    RoadTable queryTable;               // Columns of the roads, for queries
+    size_t attributesRevision = 0;      // Changes whenever road attributes are set or dropped
+    size_t queryTableRevision = SIZE_MAX;   // Sum of the three revisions the table was built from
+    
+    /**
+     * The road table for queries, rebuilt after any city, road,
+     * budget, district or attribute edit
+     */
+    const RoadTable& cachedRoadTable();
+    
+    /**
+     * Checks whether a road passes the given filter, whose
+     * cityPrefix has already been normalized with normalizeName()
+     */
+    bool matchesFilter(const Road& road, const RoadFilter& filter) const;
+    
+    /**
+     * Converts a range of city indices into matrix slots
+     * The range is clamped to the cities that currently exist
+     */
+    std::vector<std::size_t> rangeSlots(int start, int count) const;
+    
+    /**
+     * Converts a list of city indices into matrix slots
+     * Unknown indices are reported and skipped
+     */
+    std::vector<std::size_t> subsetSlots(const std::vector<int>& indices) const;
+    
+    /**
+     * Prints the given rows and columns of a matrix
+     * Only the selected cells are visited, so the cost depends on
+     * the size of the block and not on the number of cities
+     * @param cell Returns the value to print for slots (i, j)
+     */
+    template <typename Cell>
+    void renderMatrixBlock(Cell cell,
+                           const std::vector<std::size_t>& rows,
+                           const std::vector<std::size_t>& cols,
+                           int width) const;
+    
+    /**
+     * Adds a city name to the name indexes, or removes it
+     */
+    void indexName(int slot, const std::string& name);
+    void unindexName(int slot, const std::string& name);
+    
+    /**
+     * Reports an unknown city name with the closest known names
+     */
+    void reportMissingCity(const std::string& name) const;
+    
+    /**
+     * Reports whichever of two looked-up cities was not found
+     * (an index of -1)
+     */
+    void reportMissingCities(const std::string& city1, int idx1, const std::string& city2, int idx2) const;
+    
+    /**
+     * "Name1-Name2" with the lower index first, or "From->To" for a
+     * one-way road
+     */
+    std::string roadLabel(int roadId) const;
+    
+    /**
+     * Finds the road an edit refers to, reporting why there is none
+     * @param roadNumber Which of several parallel roads (id + 1), or
+     *                   0 when the cities share a single road
+     * @return The road id, or -1
+     */
+    int resolveRoad(const std::string& city1, const std::string& city2, int roadNumber) const;
+    
+public:
+    // Matrices larger than this are only displayed through a window
+    static constexpr int MAX_FULL_MATRIX_CITIES = 30;
+    
+    /**
+     * Constructor for the RwandaInfrastructure class
+     * Initializes with empty matrices
+     */
+    RwandaInfrastructure();
+    
+    bool addCity(const std::string& name);
+    
+    /**
+     * Adds a road between two cities
+     * @param parallel Whether to add it alongside existing roads
+     *                 between the cities instead of refusing
+     * @param oneWay Whether the road only leads from city1 to city2
+     */
+    bool addRoad(const std::string& city1, const std::string& city2, bool parallel = false, bool oneWay = false);
+    
+    /**
+     * Sets the budget of the road between two cities
+     * @param roadNumber Which of several parallel roads, as listed by
+     *                   displayRoadsBetween (0 if there is only one)
+     */
+    bool addBudget(const std::string& city1, const std::string& city2, Budget budget, int roadNumber = 0);
+    
+    bool editCity(const std::string& oldName, const std::string& newName);
+    
+    void searchCityByIndex(int idx);
+    
+    /**
+     * Ids of the roads between two cities, in the order they were
+     * added (empty if either city is unknown)
+     */
+    std::vector<int> roadIdsBetween(const std::string& city1, const std::string& city2) const;
+    
+    /**
+     * Lists the roads between two cities with their numbers and
+     * budgets, to pick one of several parallel roads
+     */
+    void displayRoadsBetween(const std::string& city1, const std::string& city2);
+    
+    /**
+     * Reverses the most recent city, road, budget or rename edit
+     * @return False if there is nothing to undo
+     */
+    bool undo();
+    
+    /**
+     * Applies the most recently undone edit again
+     * @return False if there is nothing to redo
+     */
+    bool redo();
+    
+    /**
+     * Caps the memory used by the undo journal
+     * The oldest edits are forgotten once the cap is reached
+     */
+    void setUndoLimit(size_t bytes);
+    
+    const MutationJournal& undoJournal() const {
+        return journal;
+    }
+    
+    /**
+     * Replaces the whole network, as BasicInfrastructure::loadNetwork
+     * Also forgets the undo journal, the road attributes, the budget
+     * history and the city locations, which refer to the old network
+     */
+    bool loadNetwork(const std::vector<std::string>& cityNames, const std::vector<Road>& newRoads);
+    
+    /**
+     * Places a city in one of Rwanda's districts
+     * @return False if the city or the district does not exist
+     */
+    bool assignDistrict(const std::string& cityName, const std::string& districtName);
+    
+    /**
+     * Cities whose names resemble the given one, best first, ranked
+     * by shared trigrams and then by edit distance
+     */
+    std::vector<NameMatch> findSimilarCities(const std::string& name, size_t limit) const;
+    
+    /**
+     * Names of the cities starting with a prefix, ignoring case, in
+     * alphabetical order
+     * @param limit Most names to return
+     */
+    std::vector<std::string> completeCityName(const std::string& prefix, size_t limit) const;
+    
+    /**
+     * Lists the cities whose names resemble the given one
+     */
+    void displaySimilarCities(const std::string& name);
+    
+    /**
+     * Sets or moves a city's GPS coordinates
+     * @return False if the city does not exist or a coordinate is
+     *         out of range
+     */
+    bool setCityLocation(const std::string& cityName, GeoPoint point);
+    
+    const SpatialIndex& spatialIndex() const {
+        return locations;
+    }
+    
+    /**
+     * Lists the cities closest to a point with their distance in km
+     */
+    void displayNearestCities(GeoPoint point, int count);
+    
+    /**
+     * Lists the cities inside a latitude/longitude rectangle
+     */
+    void displayCitiesInArea(const GeoBox& area);
+    
+    /**
+     * The roads as travelled, with one-way roads in one direction
+     * only; rebuilt here after any city, road or budget edit
+     */
+    const DirectedRoadGraph& routeGraph();
+    
+    /**
+     * Shows the cheapest route from one city to another, following
+     * one-way roads only in their direction and using road budgets
+     * as costs
+     */
+    void displayCheapestRoute(const std::string& from, const std::string& to);
+    
+    /**
+     * Records a road's budget for one fiscal year
+     * The current budget set by addBudget is not changed
+     * @return False if the road does not exist or the year or
+     *         budget is out of range
+     */
+    bool addYearBudget(const std::string& city1, const std::string& city2, int year, Budget budget,
+                       int roadNumber = 0);
+    
+    const BudgetTimeSeries& budgetTimeSeries() const {
+        return budgetHistory;
+    }
+    
+    /**
+     * Displays the total, year-over-year change and running total of
+     * the budgets for every recorded fiscal year
+     */
+    void displayBudgetHistory();
+    
+    /**
+     * Lists the roads whose budget changed from the previous year
+     */
+    void displayYearOverYear(int year);
+    
+    /**
+     * Records the length, surface, lane count and condition of a road
+     * @return False if the road does not exist or a value is invalid
+     */
+    bool setRoadAttributes(const std::string& city1, const std::string& city2,
+                           const RoadAttributes& values, int roadNumber = 0);
+    
+    const RoadAttributeStore& roadAttributes() const {
+        return attributes;
+    }
+    
+    /**
+     * Lists the roads with a given surface
+     * @param conditionBelow Only list roads rated below this score
+     *                       (0 lists every road with the surface)
+     */
+    void displayRoadsBySurface(const std::string& surface, int conditionBelow);
+    
+    /**
+     * Copies the edge list and the road attributes into one array
+     * per column, indexed by road id
+     */
+    RoadTable roadTable() const;
+    
+    /**
+     * Resolves the names in a query and runs it over the roads,
+     * reusing the road table until the network changes
+     * @return The result, or a result with error set if a city,
+     *         district, province or surface is unknown
+     */
+    QueryResult queryRoads(RoadQuery query);
+    
+    /**
+     * Parses, runs and prints a query written in the text syntax
+     * described by roadQueryHelp()
+     */
+    void runRoadQuery(const std::string& text);
+    
+    /**
+     * Copies the city names and the roads with their current budgets
+     */
+    NetworkSnapshot snapshot() const;
+    
+    /**
+     * Measures the memory held by each data structure
+     * @return One entry per structure, in declaration order
+     */
+    std::vector<MemoryUsage> memoryUsage() const;
+    
+    /**
+     * Displays all cities and their indices
+     */
+    void displayCities();
+    
+    /**
+     * Displays the road network as an adjacency matrix holding the
+     * number of roads between each pair of cities
+     * Large networks only show their first window
+     */
+    void displayRoads();
+    
+    /**
+     * Displays the budget allocations as a matrix
+     * Large networks only show their first window
+     */
+    void displayBudgets();
+    
+    /**
+     * Displays a block of the road adjacency matrix
+     * @param window Rows and columns to display
+     */
+    void displayRoadsWindow(const MatrixWindow& window);
+    
+    /**
+     * Displays a block of the budget matrix
+     * @param window Rows and columns to display
+     */
+    void displayBudgetsWindow(const MatrixWindow& window);
+    
+    /**
+     * Displays the road matrix restricted to a subset of cities
+     * @param indices City indices used for both rows and columns
+     */
+    void displayRoadsSubset(const std::vector<int>& indices);
+    
+    /**
+     * Displays the budget matrix restricted to a subset of cities
+     * @param indices City indices used for both rows and columns
+     */
+    void displayBudgetsSubset(const std::vector<int>& indices);
+    
+    /**
+     * Lists every city with its connected neighbors and road budgets
+     * Walks the adjacency lists, so the cost depends on the number of
+     * roads rather than on the size of the matrix
+     * @param filter Only roads passing the filter are listed
+     */
+    void displayNeighbors(const RoadFilter& filter);
+    
+    /**
+     * Lists roads as a sorted edge list
+     * @param filter Only roads passing the filter are listed
+     * @param byBudget Sort by descending budget instead of by city index
+     */
+    void displayEdgeList(const RoadFilter& filter, bool byBudget);
+    
+    /**
+     * The region partition of the current network, rebuilt here
+     * after any city, road, budget or district edit
+     */
+    const RegionPartition& regionPartition();
+    
+    /**
+     * Displays city, road and budget totals per province and district
+     * Reads the region partition, so each row only reads its own
+     * range of cities and roads; the partition is built on the first
+     * report after an edit, in O(cities + roads), and reused until
+     * the next one
+     * Roads between provinces and roads touching a city without a
+     * district are counted in separate rows
+     */
+    void displayRegionReport();
+    
+    /**
+     * Displays the total and largest budget of each city's connections,
+     * how many are funded and how many have at least a threshold
+     * Scans whole rows of the budget matrix with the vector kernels of
+     * budget_kernels.h; parallel roads count as one connection
+     * @param threshold Budget a connection needs to be counted
+     */
+    void displayBudgetSummary(Budget threshold);
+    
+    /**
+     * Lays out the road storage in a new order of cities and reports
+     * how far apart connected cities are before and after
+     * City indices, names and roads are unchanged; only the rows of
+     * the budget matrix move, so traversals read fewer cache lines
+     * @param order CityOrder::ReverseCuthillMcKee to group connected
+     *              cities, CityOrder::Insertion to undo that
+     */
+    void reorderRoadStorage(CityOrder order);
+    
+    /**
+     * Displays all data (cities, roads, and budgets)
+     */
+    void displayAllData();
+    
+    /**
+     * Saves all data to text files (cities.txt and roads.txt)
+     * Creates well-formatted tables with proper column alignment
+     * Only cities, roads and current budgets are written; road
+     * attributes, yearly budgets, coordinates and districts are not
+     */
+    void saveToFiles();
+    
+    /**
+     * Loads initial data for Rwanda's infrastructure
+     * Bulk-loads the seed cities and roads from seed_data.h and
+     * writes cities.txt and roads.txt only if either is missing
+     */
+    void loadInitialData();
+};
+
+#endif // RWANDA_INFRASTRUCTURE_H
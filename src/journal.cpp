@@ -0,0 +1,85 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - undo journal
+ *
+ * Implements the bounded undo and redo stacks.
+ *****************************************************************/
+
+#include "journal.h"
+
+#include <utility>
+
+using namespace std;
+
+MutationJournal::MutationJournal(size_t limit) : limitBytes(limit), journalBytes(0) {}
+
+size_t MutationJournal::mutationBytes(const Mutation& mutation) {
+    // Names within the small string buffer need no extra allocation
+    size_t inlineCapacity = string().capacity();
+    size_t bytes = sizeof(Mutation);
+    for (const string* name : {&mutation.oldName, &mutation.newName}) {
+        if (name->capacity() > inlineCapacity) {
+            bytes += name->capacity() + 1;
+        }
+    }
+    if (mutation.removed) {
+        const RemovedDetails& removed = *mutation.removed;
+        bytes += sizeof(RemovedDetails) + removed.yearBudgets.capacity() * sizeof(removed.yearBudgets[0]);
+        if (removed.attributes.surface.capacity() > inlineCapacity) {
+            bytes += removed.attributes.surface.capacity() + 1;
+        }
+    }
+    return bytes;
+}
+
+void MutationJournal::enforceLimit() {
+    while (journalBytes > limitBytes && !undoStack.empty()) {
+        journalBytes -= mutationBytes(undoStack.front());
+        undoStack.pop_front();
+    }
+    while (journalBytes > limitBytes && !redoStack.empty()) {
+        journalBytes -= mutationBytes(redoStack.front());
+        redoStack.pop_front();
+    }
+}
+
+void MutationJournal::record(Mutation mutation) {
+    for (const Mutation& dropped : redoStack) {
+        journalBytes -= mutationBytes(dropped);
+    }
+    redoStack.clear();
+
+    journalBytes += mutationBytes(mutation);
+    undoStack.push_back(move(mutation));
+    enforceLimit();
+}
+
+const Mutation& MutationJournal::undo() {
+    redoStack.push_back(move(undoStack.back()));
+    undoStack.pop_back();
+    return redoStack.back();
+}
+
+void MutationJournal::keepRemoved(RemovedDetails details) {
+    Mutation& mutation = redoStack.back();
+    journalBytes -= mutationBytes(mutation);
+    mutation.removed = make_unique<RemovedDetails>(move(details));
+    journalBytes += mutationBytes(mutation);
+    enforceLimit();
+}
+
+const Mutation& MutationJournal::redo() {
+    undoStack.push_back(move(redoStack.back()));
+    redoStack.pop_back();
+    return undoStack.back();
+}
+
+void MutationJournal::clear() {
+    undoStack.clear();
+    redoStack.clear();
+    journalBytes = 0;
+}
+
+void MutationJournal::setLimit(size_t bytes) {
+    limitBytes = bytes;
+    enforceLimit();
+}
@@ -0,0 +1,150 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - undo journal
+ *
+ * Records every edit as a small mutation holding what is needed
+ * to reverse it and to apply it again: the road and its budget
+ * before and after, the old and new city name, or the city or
+ * road that was added. Undo and redo move one mutation between
+ * two stacks, so each step is O(1) and no graph is ever copied.
+ * Undoing an added city or road also keeps what was attached to it
+ * (district and location, or attributes and yearly budgets) with
+ * the mutation, so redo brings it back as it was.
+ *
+ * The journal is bounded by a memory cap; once it is exceeded the
+ * oldest mutations are dropped and can no longer be undone.
+ *****************************************************************/
+
+#ifndef RWANDA_JOURNAL_H
+#define RWANDA_JOURNAL_H
+
+#include "budget.h"
+#include "road_attributes.h"
+#include "spatial_index.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+//====================================================================
+// STRUCTURES
+//====================================================================
+
+enum class MutationKind : uint8_t {
+    AddCity,            // city = slot of the new city, newName = its name
+    AddRoad,            // city, otherCity = slots of the endpoints, oneWay
+    SetBudget,          // road, oldBudget, newBudget
+    RenameCity          // city, oldName, newName
+};
+
+/**
+ * What undoing an AddCity or AddRoad took away besides the city or
+ * road itself
+ */
+struct RemovedDetails {
+    int district = -1;                                  // AddCity
+    bool located = false;                               // AddCity: whether location is set
+    GeoPoint location = {0.0, 0.0};
+    bool hasAttributes = false;                         // AddRoad: whether attributes were stored
+    RoadAttributes attributes = {0.0, "", 0, 0};
+    std::vector<std::pair<int, Budget>> yearBudgets;    // AddRoad: (year, budget) of every funded year
+};
+
+struct Mutation {
+    MutationKind kind;
+    int city;
+    int otherCity;
+    int road;
+    Budget oldBudget;
+    Budget newBudget;
+    std::string oldName;
+    std::string newName;
+    bool oneWay = false;        // AddRoad: the road only leads from city to otherCity
+    std::unique_ptr<RemovedDetails> removed{};  // Set once an AddCity or AddRoad has been undone
+};
+
+//====================================================================
+// MUTATION JOURNAL
+//====================================================================
+
+class MutationJournal {
+private:
+    std::deque<Mutation> undoStack;     // Oldest mutation at the front
+    std::deque<Mutation> redoStack;     // Most recently undone mutation at the back
+    size_t limitBytes;
+    size_t journalBytes;
+
+    static size_t mutationBytes(const Mutation& mutation);
+    void enforceLimit();
+
+public:
+    static constexpr size_t DEFAULT_LIMIT_BYTES = 1 << 20;
+
+    explicit MutationJournal(size_t limit = DEFAULT_LIMIT_BYTES);
+
+    /**
+     * Records a new edit; anything that could be redone is discarded
+     */
+    void record(Mutation mutation);
+
+    bool canUndo() const {
+        return !undoStack.empty();
+    }
+
+    bool canRedo() const {
+        return !redoStack.empty();
+    }
+
+    /**
+     * Moves the newest edit to the redo stack and returns it
+     * Call only when canUndo() is true
+     */
+    const Mutation& undo();
+
+    /**
+     * Keeps what the undo just made took away, for redo to restore
+     * Call right after undo(), once done with the mutation it
+     * returned (the cap may drop it)
+     */
+    void keepRemoved(RemovedDetails details);
+
+    /**
+     * Moves the most recently undone edit back and returns it
+     * Call only when canRedo() is true
+     */
+    const Mutation& redo();
+
+    /**
+     * Forgets every edit, e.g. after the whole network is replaced
+     */
+    void clear();
+
+    /**
+     * Changes the memory cap, dropping the oldest edits if needed
+     */
+    void setLimit(size_t bytes);
+
+    size_t limit() const {
+        return limitBytes;
+    }
+
+    size_t undoCount() const {
+        return undoStack.size();
+    }
+
+    size_t redoCount() const {
+        return redoStack.size();
+    }
+
+    /**
+     * Bytes held by the recorded edits, counted against the cap
+     */
+    size_t usedBytes() const {
+        return journalBytes;
+    }
+};
+
+#endif // RWANDA_JOURNAL_H
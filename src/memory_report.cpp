@@ -0,0 +1,154 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - memory accounting
+ *
+ * Implements the memory report and the footprint predictor.
+ *****************************************************************/
+
+#include "memory_report.h"
+#include "directed_graph.h"
+#include "graph_memory.h"
+#include "regions.h"
+
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+
+//====================================================================
+// MEMORY FUNCTIONS
+//====================================================================
+
+const char* storageBackendName(StorageBackend backend) {
+    switch (backend) {
+        case StorageBackend::Dense:      return "dense";
+        case StorageBackend::Triangular: return "triangular";
+        case StorageBackend::Bitset:     return "bitset";
+        case StorageBackend::Csr:        return "csr";
+        case StorageBackend::Count:      break;
+    }
+    return "unknown";
+}
+
+size_t predictStorageBytes(StorageBackend backend, long cityCount, long pairCount) {
+    double n = cityCount;
+    double m = pairCount;
+    double bytes = 0.0;
+
+    switch (backend) {
+        case StorageBackend::Dense: {
+            // Rows padded to the storage's capacity
+            double stride = DenseStorage<Budget>::padded(cityCount);
+            bytes = stride * stride * (sizeof(unsigned char) + sizeof(Budget));
+            break;
+        }
+        case StorageBackend::Triangular:
+            bytes = n * (n - 1) / 2 * (sizeof(unsigned char) + sizeof(Budget));
+            break;
+        case StorageBackend::Bitset: {
+            // Rows of whole 64-bit words, allocated for a multiple of
+            // 64 rows; one map node and about one bucket per pair
+            double words = (cityCount + 63) / 64;
+            bytes = words * 64 * words * sizeof(uint64_t)
+                  + m * (BitsetStorage<Budget>::NODE_BYTES + sizeof(void*));
+            break;
+        }
+        case StorageBackend::Csr:
+            bytes = (n + 1) * sizeof(int) + 2 * m * (sizeof(int) + sizeof(Budget));
+            break;
+        case StorageBackend::Count:
+            break;
+    }
+    return static_cast<size_t>(bytes);
+}
+
+size_t predictMemoryBytes(StorageBackend backend, long cityCount, long roadCount, long pairCount,
+                          double averageNameLength) {
+    double n = cityCount;
+    double m = roadCount;
+
+    // Shared by every backend: cities, long names and their keys, the
+    // key table (a power of two at least twice the cities), edge list,
+    // adjacency, road attribute columns
+    size_t inlineCapacity = string().capacity();
+    double nameBytes = averageNameLength > inlineCapacity ? averageNameLength + 1 : 0.0;
+    double keyBuckets = 16;
+    while (keyBuckets < 2 * n) {
+        keyBuckets *= 2;
+    }
+    double bytes = n * (sizeof(City) + 2 * nameBytes)
+                 + keyBuckets * 2 * sizeof(int)
+                 + m * sizeof(Road)
+                 + n * sizeof(vector<RoadLink>) + 2 * m * sizeof(RoadLink)
+                 + m * (sizeof(float) + 3 * sizeof(uint8_t));
+
+    // Name indexes: the trigram index's names, trigram counts and one
+    // posting per distinct trigram of each padded name (at most its
+    // length plus one), and the prefix index's heads, names and slots
+    bytes += n * (sizeof(string) + nameBytes + sizeof(uint16_t)) + n * (averageNameLength + 1) * sizeof(int)
+           + n * (sizeof(uint64_t) + sizeof(string) + nameBytes + sizeof(int));
+
+    // Built on demand: out- and in-arcs both ways along every road,
+    // the cities and roads grouped by region, and the query columns
+    bytes += 2 * (n + 1) * sizeof(int) + 4 * m * sizeof(DirectedRoadGraph::Arc)
+           + 2 * n * sizeof(int) + m * sizeof(PartitionEdge)
+           + m * (2 * sizeof(int32_t) + sizeof(Budget) + sizeof(float) + 3 * sizeof(uint8_t) + 2 * sizeof(int16_t));
+
+    return static_cast<size_t>(bytes) + predictStorageBytes(backend, cityCount, pairCount);
+}
+
+string formatBytes(double bytes) {
+    const char* units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+    int unit = 0;
+    while (bytes >= 1024.0 && unit < 4) {
+        bytes /= 1024.0;
+        unit++;
+    }
+    ostringstream text;
+    text << fixed << setprecision(unit == 0 ? 0 : 1) << bytes << " " << units[unit];
+    return text.str();
+}
+
+void printMemoryReport(const RwandaInfrastructure& infrastructure, ostream& out) {
+    vector<MemoryUsage> usage = infrastructure.memoryUsage();
+    ios::fmtflags flags = out.flags();
+
+    out << "\nMemory usage (" << infrastructure.cityCount() << " cities, "
+        << infrastructure.roadCount() << " roads):\n";
+    out << left << setw(16) << "Structure" << right << setw(14) << "Used" << setw(14) << "Allocated" << endl;
+    size_t usedTotal = 0;
+    size_t capacityTotal = 0;
+    for (const auto& entry : usage) {
+        out << left << setw(16) << entry.structure << right << setw(14) << formatBytes(entry.usedBytes)
+            << setw(14) << formatBytes(entry.capacityBytes) << endl;
+        usedTotal += entry.usedBytes;
+        capacityTotal += entry.capacityBytes;
+    }
+    out << left << setw(16) << "total" << right << setw(14) << formatBytes(usedTotal)
+        << setw(14) << formatBytes(capacityTotal) << endl;
+    
+    GraphMemoryOptions options = graphMemoryOptions();
+    GraphMemoryStats stats = graphMemoryStats();
+    out << "\nLarge arrays: " << formatBytes(stats.mappedBytes) << " mapped, pages "
+        << pageModeName(options.pages) << ", placement " << nodePlacementName(options.placement)
+        << " over " << numaNodeCount() << " NUMA node(s)" << endl;
+    out << "Huge pages: " << formatBytes(stats.explicitHugeBytes) << " reserved, "
+        << formatBytes(transparentHugeBytes()) << " transparent";
+    if (stats.fallbacks > 0) {
+        out << " (" << stats.fallbacks << " reserved requests fell back to transparent)";
+    }
+    out << endl;
+    out.flags(flags);
+}
+
+void printMemoryPrediction(long cityCount, long roadCount, long pairCount, ostream& out) {
+    ios::fmtflags flags = out.flags();
+    out << "\nPredicted footprint for " << cityCount << " cities and " << roadCount << " roads:\n";
+    for (int b = 0; b < STORAGE_BACKEND_COUNT; ++b) {
+        StorageBackend backend = static_cast<StorageBackend>(b);
+        out << left << setw(16) << storageBackendName(backend) << right
+            << setw(14) << formatBytes(predictMemoryBytes(backend, cityCount, roadCount, pairCount)) << endl;
+    }
+    out.flags(flags);
+}
@@ -0,0 +1,68 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - memory accounting
+ *
+ * Reports how much memory the graph state holds and predicts the
+ * footprint of a network of a given size for each of the storage
+ * policies in graph_storage.h.
+ *****************************************************************/
+
+#ifndef RWANDA_MEMORY_REPORT_H
+#define RWANDA_MEMORY_REPORT_H
+
+#include "graph_storage.h"
+#include "infrastructure.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+//====================================================================
+// MEMORY FUNCTIONS
+//====================================================================
+
+/**
+ * Display name of a storage backend
+ */
+const char* storageBackendName(StorageBackend backend);
+
+/**
+ * Estimates the bytes the road and budget storage of a backend
+ * allocates for a network of the given size, loaded in one pass
+ * @param pairCount Connected pairs of cities; parallel roads share
+ * one storage entry
+ */
+size_t predictStorageBytes(StorageBackend backend, long cityCount, long pairCount);
+
+/**
+ * Estimates the bytes needed for a network of the given size
+ * Includes the city list, the names, the edge list and adjacency
+ * lists, the road attributes, the name and prefix indexes, and the
+ * route arcs, region partition and query table once built, plus the
+ * road and budget storage of the chosen backend. Left out are the
+ * structures that depend on the contents rather than the counts:
+ * the trigram map itself (one entry per distinct trigram of the
+ * names), the spatial index (located cities only), the budget
+ * history and the undo journal. Every road is assumed two-way.
+ * @param pairCount Connected pairs of cities, at most roadCount
+ * @param averageNameLength Average city name length in characters
+ */
+size_t predictMemoryBytes(StorageBackend backend, long cityCount, long roadCount, long pairCount,
+                          double averageNameLength = 8.0);
+
+/**
+ * Formats a byte count with a binary unit (B, KiB, MiB, GiB, TiB)
+ */
+std::string formatBytes(double bytes);
+
+/**
+ * Prints the used and allocated bytes of every structure
+ */
+void printMemoryReport(const RwandaInfrastructure& infrastructure, std::ostream& out);
+
+/**
+ * Prints the predicted footprint of every backend
+ */
+void printMemoryPrediction(long cityCount, long roadCount, long pairCount, std::ostream& out);
+
+#endif // RWANDA_MEMORY_REPORT_H
@@ -0,0 +1,215 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - operation metrics
+ *
+ * Implements the per-thread metric shards, their registry and the
+ * text report.
+ *****************************************************************/
+
+#include "metrics.h"
+
+#include <array>
+#include <atomic>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+
+using namespace std;
+
+//====================================================================
+// LATENCY HISTOGRAM
+//====================================================================
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        buckets[i] += other.buckets[i];
+    }
+    count += other.count;
+    totalNs += other.totalNs;
+    maxNs = max(maxNs, other.maxNs);
+}
+
+uint64_t LatencyHistogram::percentile(double quantile) const {
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(quantile * count);
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets[i];
+        if (seen > rank) {
+            // Report the bucket's upper edge, capped by the true maximum
+            uint64_t upper = i + 1 < BUCKET_COUNT ? bucketLowerBound(i + 1) - 1 : maxNs;
+            return min(upper, maxNs);
+        }
+    }
+    return maxNs;
+}
+
+//====================================================================
+// THREAD SHARDS
+//====================================================================
+
+namespace {
+
+/**
+ * Counters written by a single thread
+ * Values are atomics only so that reports from other threads can
+ * read them safely; the owning thread uses plain load/store pairs
+ */
+struct MetricsShard {
+    array<array<atomic<uint64_t>, LatencyHistogram::BUCKET_COUNT>, OPERATION_COUNT> buckets{};
+    array<atomic<uint64_t>, OPERATION_COUNT> counts{};
+    array<atomic<uint64_t>, OPERATION_COUNT> totals{};
+    array<atomic<uint64_t>, OPERATION_COUNT> maxima{};
+
+    MetricsShard();
+    ~MetricsShard();
+
+    void addTo(vector<LatencyHistogram>& histograms) const {
+        for (int op = 0; op < OPERATION_COUNT; ++op) {
+            LatencyHistogram& histogram = histograms[op];
+            for (int i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i) {
+                histogram.buckets[i] += buckets[op][i].load(memory_order_relaxed);
+            }
+            histogram.count += counts[op].load(memory_order_relaxed);
+            histogram.totalNs += totals[op].load(memory_order_relaxed);
+            histogram.maxNs = max(histogram.maxNs, maxima[op].load(memory_order_relaxed));
+        }
+    }
+
+    void clear() {
+        for (int op = 0; op < OPERATION_COUNT; ++op) {
+            for (auto& bucket : buckets[op]) {
+                bucket.store(0, memory_order_relaxed);
+            }
+            counts[op].store(0, memory_order_relaxed);
+            totals[op].store(0, memory_order_relaxed);
+            maxima[op].store(0, memory_order_relaxed);
+        }
+    }
+};
+
+/**
+ * Live shards plus the totals of threads that have exited
+ * Never destroyed, so shards of threads that outlive main can
+ * still unregister safely
+ */
+struct ShardRegistry {
+    mutex lock;
+    vector<MetricsShard*> shards;
+    vector<LatencyHistogram> retired = vector<LatencyHistogram>(OPERATION_COUNT);
+};
+
+ShardRegistry& shardRegistry() {
+    static ShardRegistry* registry = new ShardRegistry();
+    return *registry;
+}
+
+MetricsShard::MetricsShard() {
+    ShardRegistry& registry = shardRegistry();
+    lock_guard<mutex> guard(registry.lock);
+    registry.shards.push_back(this);
+}
+
+MetricsShard::~MetricsShard() {
+    ShardRegistry& registry = shardRegistry();
+    lock_guard<mutex> guard(registry.lock);
+    addTo(registry.retired);
+    for (size_t i = 0; i < registry.shards.size(); ++i) {
+        if (registry.shards[i] == this) {
+            registry.shards.erase(registry.shards.begin() + i);
+            break;
+        }
+    }
+}
+
+inline void bump(atomic<uint64_t>& counter, uint64_t amount) {
+    counter.store(counter.load(memory_order_relaxed) + amount, memory_order_relaxed);
+}
+
+} // namespace
+
+//====================================================================
+// METRICS FUNCTIONS
+//====================================================================
+
+const char* operationName(Operation operation) {
+    switch (operation) {
+        case Operation::AddCity:       return "addCity";
+        case Operation::AddRoad:       return "addRoad";
+        case Operation::AddBudget:     return "addBudget";
+        case Operation::FindCityIndex: return "findCityIndex";
+        case Operation::SaveToFiles:   return "saveToFiles";
+        case Operation::Count:         break;
+    }
+    return "unknown";
+}
+
+bool metricsEnabled() {
+#ifdef RWANDA_ENABLE_METRICS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void recordOperation(Operation operation, uint64_t ns) {
+    thread_local MetricsShard shard;
+    int op = static_cast<int>(operation);
+    bump(shard.buckets[op][LatencyHistogram::bucketIndex(ns)], 1);
+    bump(shard.counts[op], 1);
+    bump(shard.totals[op], ns);
+    if (ns > shard.maxima[op].load(memory_order_relaxed)) {
+        shard.maxima[op].store(ns, memory_order_relaxed);
+    }
+}
+
+vector<LatencyHistogram> metricsSnapshot() {
+    ShardRegistry& registry = shardRegistry();
+    lock_guard<mutex> guard(registry.lock);
+    vector<LatencyHistogram> histograms = registry.retired;
+    for (const MetricsShard* shard : registry.shards) {
+        shard->addTo(histograms);
+    }
+    return histograms;
+}
+
+void resetMetrics() {
+    ShardRegistry& registry = shardRegistry();
+    lock_guard<mutex> guard(registry.lock);
+    registry.retired.assign(OPERATION_COUNT, LatencyHistogram());
+    for (MetricsShard* shard : registry.shards) {
+        shard->clear();
+    }
+}
+
+void printMetricsReport(ostream& out) {
+    if (!metricsEnabled()) {
+        out << "Metrics are disabled in this build (RWANDA_ENABLE_METRICS is off)." << endl;
+        return;
+    }
+
+    vector<LatencyHistogram> histograms = metricsSnapshot();
+    ios::fmtflags flags = out.flags();
+    streamsize precision = out.precision();
+
+    out << "\nOperation metrics (latencies in microseconds):\n";
+    out << left << setw(16) << "Operation" << right << setw(10) << "Count"
+        << setw(10) << "Mean" << setw(10) << "p50" << setw(10) << "p90"
+        << setw(10) << "p99" << setw(10) << "p99.9" << setw(10) << "Max" << endl;
+    out << fixed << setprecision(2);
+    for (int op = 0; op < OPERATION_COUNT; ++op) {
+        const LatencyHistogram& histogram = histograms[op];
+        out << left << setw(16) << operationName(static_cast<Operation>(op)) << right
+            << setw(10) << histogram.count
+            << setw(10) << histogram.meanNs() / 1000.0
+            << setw(10) << histogram.percentile(0.50) / 1000.0
+            << setw(10) << histogram.percentile(0.90) / 1000.0
+            << setw(10) << histogram.percentile(0.99) / 1000.0
+            << setw(10) << histogram.percentile(0.999) / 1000.0
+            << setw(10) << histogram.maxNs / 1000.0 << endl;
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,157 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - operation metrics
+ *
+ * Counts the core operations and records their latencies in
+ * log-bucketed (HDR-style) histograms. Every thread writes to its
+ * own shard, so recording never takes a lock; reports merge the
+ * shards on demand.
+ *
+ * Metrics are compiled in when RWANDA_ENABLE_METRICS is defined
+ * (CMake option of the same name). Without it the timing macro
+ * expands to nothing and the report says metrics are disabled.
+ *****************************************************************/
+
+#ifndef RWANDA_METRICS_H
+#define RWANDA_METRICS_H
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+//====================================================================
+// STRUCTURES
+//====================================================================
+
+/**
+ * Operations that are counted and timed
+ */
+enum class Operation {
+    AddCity,
+    AddRoad,
+    AddBudget,
+    FindCityIndex,
+    SaveToFiles,
+    Count               // Number of operations, not an operation
+};
+
+constexpr int OPERATION_COUNT = static_cast<int>(Operation::Count);
+
+/**
+ * Display name of an operation
+ */
+const char* operationName(Operation operation);
+
+/**
+ * Latency histogram with logarithmic buckets
+ * Each power of two is split into 16 linear sub-buckets, so a
+ * recorded value is known to within about 6% while the whole
+ * 64-bit nanosecond range fits in under a thousand counters
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 4;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    std::vector<uint64_t> buckets;
+    uint64_t count;
+    uint64_t totalNs;
+    uint64_t maxNs;
+
+    LatencyHistogram() : buckets(BUCKET_COUNT, 0), count(0), totalNs(0), maxNs(0) {}
+
+    /**
+     * Maps a latency to its bucket
+     */
+    static int bucketIndex(uint64_t ns) {
+        if (ns < static_cast<uint64_t>(2 * SUB_BUCKETS)) {
+            return static_cast<int>(ns);
+        }
+        int magnitude = 63 - __builtin_clzll(ns);
+        int shift = magnitude - SUB_BUCKET_BITS;
+        int sub = static_cast<int>(ns >> shift) - SUB_BUCKETS;
+        return (shift + 1) * SUB_BUCKETS + sub;
+    }
+
+    /**
+     * Smallest latency that falls in the given bucket
+     */
+    static uint64_t bucketLowerBound(int index) {
+        if (index < 2 * SUB_BUCKETS) {
+            return index;
+        }
+        int shift = index / SUB_BUCKETS - 1;
+        uint64_t sub = index % SUB_BUCKETS;
+        return (SUB_BUCKETS + sub) << shift;
+    }
+
+    void merge(const LatencyHistogram& other);
+
+    /**
+     * Latency below which the given fraction of samples fall
+     * @param quantile Value between 0 and 1, e.g. 0.99
+     */
+    uint64_t percentile(double quantile) const;
+
+    double meanNs() const {
+        return count ? static_cast<double>(totalNs) / count : 0.0;
+    }
+};
+
+//====================================================================
+// METRICS FUNCTIONS
+//====================================================================
+
+/**
+ * Whether metrics were compiled in
+ */
+bool metricsEnabled();
+
+/**
+ * Records one operation in the calling thread's shard
+ */
+void recordOperation(Operation operation, uint64_t ns);
+
+/**
+ * Merges every thread's shard into one histogram per operation
+ */
+std::vector<LatencyHistogram> metricsSnapshot();
+
+/**
+ * Clears all counters and histograms
+ */
+void resetMetrics();
+
+/**
+ * Prints counts and latency percentiles for every operation
+ */
+void printMetricsReport(std::ostream& out);
+
+/**
+ * Times the enclosing scope and records it on destruction
+ */
+class OperationTimer {
+private:
+    Operation operation;
+    std::chrono::steady_clock::time_point started;
+
+public:
+    explicit OperationTimer(Operation op) : operation(op), started(std::chrono::steady_clock::now()) {}
+
+    ~OperationTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - started;
+        recordOperation(operation, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+
+    OperationTimer(const OperationTimer&) = delete;
+    OperationTimer& operator=(const OperationTimer&) = delete;
+};
+
+#ifdef RWANDA_ENABLE_METRICS
+#define RWANDA_TIME_OPERATION(op) OperationTimer operationTimer_(op)
+#else
+#define RWANDA_TIME_OPERATION(op) ((void)0)
+#endif
+
+#endif // RWANDA_METRICS_H
@@ -0,0 +1,91 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - city name keys
+ *
+ * Implements name normalization.
+ *****************************************************************/
+
+#include "name_key.h"
+
+#include <cctype>
+
+using namespace std;
+
+namespace {
+
+/**
+ * Base letters of a run of accented Latin code points
+ */
+struct Fold {
+    unsigned first;
+    unsigned last;
+    const char* base;
+};
+
+// Latin-1 Supplement and Latin Extended-A letters, lower case
+const Fold FOLDS[] = {
+    {0xC0, 0xC5, "a"}, {0xC6, 0xC6, "ae"}, {0xC7, 0xC7, "c"}, {0xC8, 0xCB, "e"}, {0xCC, 0xCF, "i"},
+    {0xD0, 0xD0, "d"}, {0xD1, 0xD1, "n"}, {0xD2, 0xD6, "o"}, {0xD8, 0xD8, "o"}, {0xD9, 0xDC, "u"},
+    {0xDD, 0xDD, "y"}, {0xDE, 0xDE, "th"}, {0xDF, 0xDF, "ss"}, {0xE0, 0xE5, "a"}, {0xE6, 0xE6, "ae"},
+    {0xE7, 0xE7, "c"}, {0xE8, 0xEB, "e"}, {0xEC, 0xEF, "i"}, {0xF0, 0xF0, "d"}, {0xF1, 0xF1, "n"},
+    {0xF2, 0xF6, "o"}, {0xF8, 0xF8, "o"}, {0xF9, 0xFC, "u"}, {0xFD, 0xFD, "y"}, {0xFE, 0xFE, "th"},
+    {0xFF, 0xFF, "y"}, {0x100, 0x105, "a"}, {0x106, 0x10D, "c"}, {0x10E, 0x111, "d"}, {0x112, 0x11B, "e"},
+    {0x11C, 0x123, "g"}, {0x124, 0x127, "h"}, {0x128, 0x131, "i"}, {0x132, 0x133, "ij"}, {0x134, 0x135, "j"},
+    {0x136, 0x138, "k"}, {0x139, 0x142, "l"}, {0x143, 0x14B, "n"}, {0x14C, 0x151, "o"}, {0x152, 0x153, "oe"},
+    {0x154, 0x159, "r"}, {0x15A, 0x161, "s"}, {0x162, 0x167, "t"}, {0x168, 0x173, "u"}, {0x174, 0x175, "w"},
+    {0x176, 0x178, "y"}, {0x179, 0x17E, "z"}, {0x17F, 0x17F, "s"}
+};
+
+const char* foldCodePoint(unsigned codePoint) {
+    for (const Fold& fold : FOLDS) {
+        if (codePoint >= fold.first && codePoint <= fold.last) {
+            return fold.base;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+string normalizeName(const string& name) {
+    string key;
+    key.reserve(name.size());
+    bool pendingSpace = false;
+
+    for (size_t i = 0; i < name.size(); ++i) {
+        unsigned char c = name[i];
+
+        // Two-byte UTF-8 sequences cover every letter folded here
+        if (c >= 0xC2 && c <= 0xDF && i + 1 < name.size() && (static_cast<unsigned char>(name[i + 1]) & 0xC0) == 0x80) {
+            unsigned codePoint = ((c & 0x1Fu) << 6) | (static_cast<unsigned char>(name[i + 1]) & 0x3Fu);
+            if (codePoint >= 0x300 && codePoint <= 0x36F) {
+                ++i;                                        // Combining mark: drop it
+                continue;
+            }
+            if (codePoint == 0xA0) {
+                ++i;                                        // No-break space
+                pendingSpace = !key.empty();
+                continue;
+            }
+            if (const char* base = foldCodePoint(codePoint)) {
+                if (pendingSpace) {
+                    key += ' ';
+                    pendingSpace = false;
+                }
+                key += base;
+                ++i;
+                continue;
+            }
+        }
+
+        if (isspace(c)) {
+            pendingSpace = !key.empty();
+            continue;
+        }
+        if (pendingSpace) {
+            key += ' ';
+            pendingSpace = false;
+        }
+        key += static_cast<char>(c < 0x80 ? tolower(c) : c);
+    }
+    return key;
+}
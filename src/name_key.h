@@ -0,0 +1,155 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - city name keys
+ *
+ * Every city name is normalized once, when it is added or renamed,
+ * into a key that ignores case, accents and surrounding or repeated
+ * blanks: "Kigali", " kigali " and "KIGALÍ" share the key "kigali".
+ * Duplicate checks and lookups hash and compare keys only, so a
+ * lookup normalizes the query and never the stored names.
+ *
+ * CityKeyTable is the open-addressing hash table behind the
+ * lookups. It stores city slots rather than copies of the keys,
+ * and reads a slot's key through an accessor supplied by the
+ * owner of the cities.
+ *****************************************************************/
+
+#ifndef RWANDA_NAME_KEY_H
+#define RWANDA_NAME_KEY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * The lookup key of a name: blanks trimmed and collapsed to single
+ * spaces, letters lower-cased, and accented Latin letters (UTF-8,
+ * precomposed or with combining marks) reduced to their base letter
+ */
+std::string normalizeName(const std::string& name);
+
+//====================================================================
+// CITY KEY TABLE
+//====================================================================
+
+class CityKeyTable {
+private:
+    struct Bucket {
+        int slot;               // -1 when empty
+        uint32_t hash;          // The key's hash, compared before the key and reused on growth
+    };
+
+    std::vector<Bucket> buckets;    // Power-of-two size, at most half full
+    size_t used = 0;
+
+    static uint32_t hashOf(const std::string& key) {
+        return static_cast<uint32_t>(std::hash<std::string>()(key));
+    }
+
+    size_t mask() const {
+        return buckets.size() - 1;
+    }
+
+    void grow() {
+        std::vector<Bucket> old;
+        old.swap(buckets);
+        buckets.assign(old.empty() ? 16 : old.size() * 2, {-1, 0});
+        for (const Bucket& bucket : old) {
+            if (bucket.slot >= 0) {
+                size_t at = bucket.hash & mask();
+                while (buckets[at].slot >= 0) {
+                    at = (at + 1) & mask();
+                }
+                buckets[at] = bucket;
+            }
+        }
+    }
+
+public:
+    /**
+     * Slot whose key equals the given key
+     * @param keyOf Returns the key of a slot
+     * @return The slot, or -1 if no slot has the key
+     */
+    template <typename KeyOf>
+    int find(const std::string& key, KeyOf keyOf) const {
+        if (buckets.empty()) {
+            return -1;
+        }
+        uint32_t hash = hashOf(key);
+        for (size_t at = hash & mask(); buckets[at].slot >= 0; at = (at + 1) & mask()) {
+            if (buckets[at].hash == hash && keyOf(buckets[at].slot) == key) {
+                return buckets[at].slot;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * Adds a slot under its current key, which must not be present
+     */
+    template <typename KeyOf>
+    void insert(int slot, KeyOf keyOf) {
+        if (2 * (used + 1) > buckets.size()) {
+            grow();
+        }
+        uint32_t hash = hashOf(keyOf(slot));
+        size_t at = hash & mask();
+        while (buckets[at].slot >= 0) {
+            at = (at + 1) & mask();
+        }
+        buckets[at] = {slot, hash};
+        ++used;
+    }
+
+    /**
+     * Removes a slot, looked up under its current key
+     */
+    template <typename KeyOf>
+    void erase(int slot, KeyOf keyOf) {
+        if (buckets.empty()) {
+            return;
+        }
+        size_t at = hashOf(keyOf(slot)) & mask();
+        while (buckets[at].slot >= 0 && buckets[at].slot != slot) {
+            at = (at + 1) & mask();
+        }
+        if (buckets[at].slot < 0) {
+            return;
+        }
+
+        // Shift later entries of the probe run back into the hole so
+        // no lookup stops early
+        size_t hole = at;
+        for (size_t next = (hole + 1) & mask(); buckets[next].slot >= 0; next = (next + 1) & mask()) {
+            size_t home = buckets[next].hash & mask();
+            bool movable = hole <= next ? (home <= hole || home > next) : (home <= hole && home > next);
+            if (movable) {
+                buckets[hole] = buckets[next];
+                hole = next;
+            }
+        }
+        buckets[hole] = {-1, 0};
+        --used;
+    }
+
+    void clear() {
+        buckets.clear();
+        used = 0;
+    }
+
+    size_t size() const {
+        return used;
+    }
+
+    size_t usedBytes() const {
+        return buckets.size() * sizeof(Bucket);
+    }
+
+    size_t capacityBytes() const {
+        return buckets.capacity() * sizeof(Bucket);
+    }
+};
+
+#endif // RWANDA_NAME_KEY_H
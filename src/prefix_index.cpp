@@ -0,0 +1,133 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - prefix search
+ *
+ * Implements the sorted name array and its two-stage range search.
+ *****************************************************************/
+
+#include "prefix_index.h"
+#include "name_key.h"
+
+#include <algorithm>
+#include <numeric>
+
+using namespace std;
+
+uint64_t PrefixIndex::headOf(const string& foldedName) {
+    uint64_t head = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        head <<= 8;
+        if (i < foldedName.size()) {
+            head |= static_cast<unsigned char>(foldedName[i]);
+        }
+    }
+    return head;
+}
+
+pair<size_t, size_t> PrefixIndex::prefixRange(const string& foldedPrefix) const {
+    // Heads sort like the names, so names starting with the first
+    // 8 bytes of the prefix have heads in [low, high]
+    size_t fixed = min<size_t>(foldedPrefix.size(), 8);
+    uint64_t low = headOf(foldedPrefix.substr(0, fixed));
+    uint64_t high = fixed == 8 ? low : low | (UINT64_MAX >> (8 * fixed));
+    size_t first = lower_bound(heads.begin(), heads.end(), low) - heads.begin();
+    size_t last = upper_bound(heads.begin() + first, heads.end(), high) - heads.begin();
+    if (foldedPrefix.size() <= 8) {
+        return {first, last};
+    }
+
+    // Longer prefixes compare the rest of the string within that range
+    auto begin = names.begin() + first;
+    auto end = names.begin() + last;
+    auto from = lower_bound(begin, end, foldedPrefix);
+    auto to = partition_point(from, end, [&](const string& name) {
+        return name.compare(0, foldedPrefix.size(), foldedPrefix) == 0;
+    });
+    return {static_cast<size_t>(from - names.begin()), static_cast<size_t>(to - names.begin())};
+}
+
+void PrefixIndex::add(int city, const string& name) {
+    string folded = normalizeName(name);
+    size_t at = lower_bound(names.begin(), names.end(), folded) - names.begin();
+    // Equal names stay ordered by city
+    while (at < names.size() && names[at] == folded && cities[at] < city) {
+        ++at;
+    }
+    heads.insert(heads.begin() + at, headOf(folded));
+    names.insert(names.begin() + at, folded);
+    cities.insert(cities.begin() + at, city);
+}
+
+void PrefixIndex::remove(int city, const string& name) {
+    string folded = normalizeName(name);
+    for (size_t at = lower_bound(names.begin(), names.end(), folded) - names.begin();
+         at < names.size() && names[at] == folded; ++at) {
+        if (cities[at] == city) {
+            heads.erase(heads.begin() + at);
+            names.erase(names.begin() + at);
+            cities.erase(cities.begin() + at);
+            return;
+        }
+    }
+}
+
+void PrefixIndex::build(const vector<string>& cityNames) {
+    vector<string> folded(cityNames.size());
+    for (size_t i = 0; i < cityNames.size(); ++i) {
+        folded[i] = normalizeName(cityNames[i]);
+    }
+    vector<int> order(cityNames.size());
+    iota(order.begin(), order.end(), 0);
+    sort(order.begin(), order.end(), [&](int a, int b) {
+        return folded[a] != folded[b] ? folded[a] < folded[b] : a < b;
+    });
+
+    clear();
+    heads.reserve(order.size());
+    names.reserve(order.size());
+    cities.reserve(order.size());
+    for (int city : order) {
+        heads.push_back(headOf(folded[city]));
+        names.push_back(move(folded[city]));
+        cities.push_back(city);
+    }
+}
+
+void PrefixIndex::clear() {
+    heads.clear();
+    names.clear();
+    cities.clear();
+}
+
+vector<int> PrefixIndex::complete(const string& prefix, size_t limit) const {
+    auto [first, last] = prefixRange(normalizeName(prefix));
+    last = min(last, first + limit);
+    return vector<int>(cities.begin() + first, cities.begin() + last);
+}
+
+size_t PrefixIndex::countWithPrefix(const string& prefix) const {
+    auto [first, last] = prefixRange(normalizeName(prefix));
+    return last - first;
+}
+
+size_t PrefixIndex::usedBytes() const {
+    size_t bytes = heads.size() * sizeof(uint64_t) + names.size() * sizeof(string) + cities.size() * sizeof(int);
+    size_t inlineCapacity = string().capacity();
+    for (const string& name : names) {
+        if (name.capacity() > inlineCapacity) {
+            bytes += name.size() + 1;
+        }
+    }
+    return bytes;
+}
+
+size_t PrefixIndex::capacityBytes() const {
+    size_t bytes = heads.capacity() * sizeof(uint64_t) + names.capacity() * sizeof(string) +
+                   cities.capacity() * sizeof(int);
+    size_t inlineCapacity = string().capacity();
+    for (const string& name : names) {
+        if (name.capacity() > inlineCapacity) {
+            bytes += name.capacity() + 1;
+        }
+    }
+    return bytes;
+}
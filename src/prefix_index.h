@@ -0,0 +1,76 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - prefix search
+ *
+ * The normalized city names kept in one sorted array, so the names
+ * starting with a prefix form a single contiguous range found by
+ * binary search. The first 8 bytes of every name are also packed
+ * big-endian into a separate array of integers: the search runs on
+ * that compact array with one integer comparison per step, and only
+ * prefixes longer than 8 bytes go on to compare strings inside the
+ * (usually tiny) range of equal heads.
+ *****************************************************************/
+
+#ifndef RWANDA_PREFIX_INDEX_H
+#define RWANDA_PREFIX_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+//====================================================================
+// PREFIX INDEX
+//====================================================================
+
+class PrefixIndex {
+private:
+    std::vector<uint64_t> heads;                // First 8 bytes of each name, big-endian
+    std::vector<std::string> names;             // Normalized names, sorted
+    std::vector<int> cities;                    // City slot of each name
+
+    static uint64_t headOf(const std::string& foldedName);
+    std::pair<size_t, size_t> prefixRange(const std::string& foldedPrefix) const;
+
+public:
+    /**
+     * Adds a city's name, keeping the array sorted
+     * O(n), since the later entries shift to make room: fine for
+     * cities added one at a time, while loading uses build()
+     */
+    void add(int city, const std::string& name);
+
+    /**
+     * Removes a city's name
+     */
+    void remove(int city, const std::string& name);
+
+    /**
+     * Replaces every name at once (name i belongs to slot i), sorting
+     * once in O(n log n)
+     */
+    void build(const std::vector<std::string>& cityNames);
+
+    void clear();
+
+    size_t size() const {
+        return names.size();
+    }
+
+    /**
+     * Cities whose names start with a prefix, ignoring case and
+     * accents, in alphabetical order
+     * @param limit Most cities to return
+     */
+    std::vector<int> complete(const std::string& prefix, size_t limit) const;
+
+    /**
+     * Number of names starting with a prefix, ignoring case and accents
+     */
+    size_t countWithPrefix(const std::string& prefix) const;
+
+    size_t usedBytes() const;
+    size_t capacityBytes() const;
+};
+
+#endif // RWANDA_PREFIX_INDEX_H
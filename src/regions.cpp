@@ -0,0 +1,164 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - region hierarchy
+ *
+ * Implements district and province lookup and the partitioned
+ * network layout.
+ *****************************************************************/
+
+#include "regions.h"
+#include "name_key.h"
+
+using namespace std;
+
+namespace {
+
+Budget edgeBudgetTotal(const vector<PartitionEdge>& edges, int begin, int end) {
+    Budget total = 0;
+    for (int e = begin; e < end; ++e) {
+        total += edges[e].budget;
+    }
+    return total;
+}
+
+/**
+ * Stable counting sort of edges into groups
+ * @param offsets Receives groupCount + 1 offsets
+ */
+vector<PartitionEdge> groupEdges(const vector<PartitionEdge>& edges, const vector<int>& groups,
+                                 int groupCount, vector<int>& offsets) {
+    offsets.assign(groupCount + 1, 0);
+    for (int group : groups) {
+        offsets[group + 1]++;
+    }
+    for (int g = 0; g < groupCount; ++g) {
+        offsets[g + 1] += offsets[g];
+    }
+    vector<int> next(offsets.begin(), offsets.end() - 1);
+    vector<PartitionEdge> grouped(edges.size());
+    for (size_t e = 0; e < edges.size(); ++e) {
+        grouped[next[groups[e]]++] = edges[e];
+    }
+    return grouped;
+}
+
+} // namespace
+
+//====================================================================
+// HIERARCHY
+//====================================================================
+
+int findDistrict(const string& name) {
+    string key = normalizeName(name);
+    for (int d = 0; d < DISTRICT_COUNT; ++d) {
+        if (key == normalizeName(RWANDA_DISTRICTS[d].name)) {
+            return d;
+        }
+    }
+    return -1;
+}
+
+int findProvince(const string& name) {
+    string key = normalizeName(name);
+    for (int p = 0; p < PROVINCE_COUNT; ++p) {
+        if (key == normalizeName(RWANDA_PROVINCES[p])) {
+            return p;
+        }
+    }
+    return -1;
+}
+
+//====================================================================
+// PARTITIONED LAYOUT
+//====================================================================
+
+int RegionPartition::provinceRoadCount(int province) const {
+    int inDistricts = districtEdgeOffsets[provinceFirstDistrict(province + 1)]
+                    - districtEdgeOffsets[provinceFirstDistrict(province)];
+    return inDistricts + provinceEdgeOffsets[province + 1] - provinceEdgeOffsets[province];
+}
+
+Budget RegionPartition::districtBudget(int district) const {
+    return edgeBudgetTotal(districtEdges, districtEdgeOffsets[district], districtEdgeOffsets[district + 1]);
+}
+
+Budget RegionPartition::provinceBudget(int province) const {
+    return edgeBudgetTotal(districtEdges, districtEdgeOffsets[provinceFirstDistrict(province)],
+                           districtEdgeOffsets[provinceFirstDistrict(province + 1)])
+         + edgeBudgetTotal(provinceEdges, provinceEdgeOffsets[province], provinceEdgeOffsets[province + 1]);
+}
+
+Budget RegionPartition::crossBudget() const {
+    return edgeBudgetTotal(crossEdges, 0, crossEdges.size());
+}
+
+Budget RegionPartition::unassignedBudget() const {
+    return edgeBudgetTotal(unassignedEdges, 0, unassignedEdges.size());
+}
+
+size_t RegionPartition::usedBytes() const {
+    size_t ints = order.size() + position.size() + cityOffsets.size() + districtEdgeOffsets.size()
+                + provinceEdgeOffsets.size();
+    size_t edges = districtEdges.size() + provinceEdges.size() + crossEdges.size() + unassignedEdges.size();
+    return ints * sizeof(int) + edges * sizeof(PartitionEdge);
+}
+
+size_t RegionPartition::capacityBytes() const {
+    size_t ints = order.capacity() + position.capacity() + cityOffsets.capacity()
+                + districtEdgeOffsets.capacity() + provinceEdgeOffsets.capacity();
+    size_t edges = districtEdges.capacity() + provinceEdges.capacity() + crossEdges.capacity()
+                 + unassignedEdges.capacity();
+    return ints * sizeof(int) + edges * sizeof(PartitionEdge);
+}
+
+RegionPartition buildRegionPartition(const vector<City>& cities, const vector<Road>& roads) {
+    RWANDA_TRACE_SCOPE("buildRegionPartition", "analytics");
+    RegionPartition partition;
+    int size = cities.size();
+
+    // Cities, grouped by district with unassigned cities last
+    vector<int> groupOf(size);
+    partition.cityOffsets.assign(DISTRICT_COUNT + 2, 0);
+    for (int slot = 0; slot < size; ++slot) {
+        int district = cities[slot].district;
+        groupOf[slot] = district >= 0 && district < DISTRICT_COUNT ? district : UNASSIGNED_DISTRICT;
+        partition.cityOffsets[groupOf[slot] + 1]++;
+    }
+    for (int g = 0; g <= DISTRICT_COUNT; ++g) {
+        partition.cityOffsets[g + 1] += partition.cityOffsets[g];
+    }
+    vector<int> next(partition.cityOffsets.begin(), partition.cityOffsets.end() - 1);
+    partition.order.resize(size);
+    partition.position.resize(size);
+    for (int slot = 0; slot < size; ++slot) {
+        int pos = next[groupOf[slot]]++;
+        partition.order[pos] = slot;
+        partition.position[slot] = pos;
+    }
+
+    // Roads, split by how far apart their cities are in the hierarchy
+    vector<PartitionEdge> districtEdges, provinceEdges;
+    vector<int> districtGroups, provinceGroups;
+    for (const Road& road : roads) {
+        int a = road.city1 - 1;
+        int b = road.city2 - 1;
+        PartitionEdge edge = {partition.position[a], partition.position[b], road.budget};
+        int da = groupOf[a];
+        int db = groupOf[b];
+        if (da == UNASSIGNED_DISTRICT || db == UNASSIGNED_DISTRICT) {
+            partition.unassignedEdges.push_back(edge);
+        } else if (da == db) {
+            districtEdges.push_back(edge);
+            districtGroups.push_back(da);
+        } else if (RWANDA_DISTRICTS[da].province == RWANDA_DISTRICTS[db].province) {
+            provinceEdges.push_back(edge);
+            provinceGroups.push_back(RWANDA_DISTRICTS[da].province);
+        } else {
+            partition.crossEdges.push_back(edge);
+        }
+    }
+    partition.districtEdges = groupEdges(districtEdges, districtGroups, DISTRICT_COUNT,
+                                         partition.districtEdgeOffsets);
+    partition.provinceEdges = groupEdges(provinceEdges, provinceGroups, PROVINCE_COUNT,
+                                         partition.provinceEdgeOffsets);
+    return partition;
+}
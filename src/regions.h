@@ -0,0 +1,152 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - region hierarchy
+ *
+ * Rwanda's administrative hierarchy (country, province, district,
+ * city) and a partitioned layout of the road network that follows
+ * it. In the partition the cities of each district are stored
+ * contiguously, and the roads are split into roads inside one
+ * district, roads between districts of one province, roads between
+ * provinces and roads touching a city without a district. A
+ * regional query or report only walks its own ranges.
+ *****************************************************************/
+
+#ifndef RWANDA_REGIONS_H
+#define RWANDA_REGIONS_H
+
+#include "graph_engine.h"
+
+#include <string>
+#include <vector>
+
+//====================================================================
+// HIERARCHY
+//====================================================================
+
+constexpr const char* RWANDA_PROVINCES[] = {
+    "Kigali City", "Northern", "Southern", "Eastern", "Western"
+};
+
+constexpr int PROVINCE_COUNT = sizeof(RWANDA_PROVINCES) / sizeof(RWANDA_PROVINCES[0]);
+
+/**
+ * A district and the province it belongs to
+ */
+struct District {
+    const char* name;
+    int province;
+};
+
+// Districts are listed province by province, so the districts of a
+// province have consecutive ids
+constexpr District RWANDA_DISTRICTS[] = {
+    {"Gasabo", 0}, {"Kicukiro", 0}, {"Nyarugenge", 0},
+    {"Burera", 1}, {"Gakenke", 1}, {"Gicumbi", 1}, {"Musanze", 1}, {"Rulindo", 1},
+    {"Gisagara", 2}, {"Huye", 2}, {"Kamonyi", 2}, {"Muhanga", 2},
+    {"Nyamagabe", 2}, {"Nyanza", 2}, {"Nyaruguru", 2}, {"Ruhango", 2},
+    {"Bugesera", 3}, {"Gatsibo", 3}, {"Kayonza", 3}, {"Kirehe", 3},
+    {"Ngoma", 3}, {"Nyagatare", 3}, {"Rwamagana", 3},
+    {"Karongi", 4}, {"Ngororero", 4}, {"Nyabihu", 4}, {"Nyamasheke", 4},
+    {"Rubavu", 4}, {"Rusizi", 4}, {"Rutsiro", 4}
+};
+
+constexpr int DISTRICT_COUNT = sizeof(RWANDA_DISTRICTS) / sizeof(RWANDA_DISTRICTS[0]);
+
+// Group id used in the partition for cities without a district
+constexpr int UNASSIGNED_DISTRICT = DISTRICT_COUNT;
+
+/**
+ * First district id of a province; PROVINCE_COUNT gives DISTRICT_COUNT
+ */
+constexpr int provinceFirstDistrict(int province) {
+    int d = 0;
+    while (d < DISTRICT_COUNT && RWANDA_DISTRICTS[d].province < province) {
+        ++d;
+    }
+    return d;
+}
+
+constexpr bool districtsGroupedByProvince() {
+    for (int d = 1; d < DISTRICT_COUNT; ++d) {
+        if (RWANDA_DISTRICTS[d].province < RWANDA_DISTRICTS[d - 1].province) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(districtsGroupedByProvince(), "Districts must be listed province by province");
+
+/**
+ * Looks up a district by name, ignoring case and accents as city
+ * lookups do (see name_key.h)
+ * @return The district id, or -1 if there is no such district
+ */
+int findDistrict(const std::string& name);
+
+/**
+ * Looks up a province by name, ignoring case and accents
+ * @return The province id, or -1 if there is no such province
+ */
+int findProvince(const std::string& name);
+
+//====================================================================
+// PARTITIONED LAYOUT
+//====================================================================
+
+/**
+ * A road inside the partition
+ * Endpoints are positions in RegionPartition::order, so the cities
+ * of one region are a contiguous range of positions
+ */
+struct PartitionEdge {
+    int from;
+    int to;
+    Budget budget;
+};
+
+/**
+ * The network laid out by region
+ * District group d holds positions [cityOffsets[d], cityOffsets[d + 1]);
+ * group UNASSIGNED_DISTRICT holds the cities without a district
+ */
+struct RegionPartition {
+    std::vector<int> order;                      // City slots grouped by district
+    std::vector<int> position;                   // Slot -> position in order
+    std::vector<int> cityOffsets;                // DISTRICT_COUNT + 2 entries
+    std::vector<PartitionEdge> districtEdges;    // Roads inside one district, grouped by district
+    std::vector<int> districtEdgeOffsets;        // DISTRICT_COUNT + 1 entries
+    std::vector<PartitionEdge> provinceEdges;    // Roads between districts of one province, grouped by province
+    std::vector<int> provinceEdgeOffsets;        // PROVINCE_COUNT + 1 entries
+    std::vector<PartitionEdge> crossEdges;       // Roads between districts of different provinces
+    std::vector<PartitionEdge> unassignedEdges;  // Roads touching a city without a district
+
+    int districtCityCount(int district) const {
+        return cityOffsets[district + 1] - cityOffsets[district];
+    }
+
+    int provinceCityCount(int province) const {
+        return cityOffsets[provinceFirstDistrict(province + 1)] - cityOffsets[provinceFirstDistrict(province)];
+    }
+
+    /**
+     * Roads inside a province: its district ranges and its own
+     * between-district range
+     */
+    int provinceRoadCount(int province) const;
+
+    Budget districtBudget(int district) const;
+    Budget provinceBudget(int province) const;
+    Budget crossBudget() const;
+    Budget unassignedBudget() const;
+
+    size_t usedBytes() const;
+    size_t capacityBytes() const;
+};
+
+/**
+ * Builds the partitioned layout with counting sorts over the
+ * cities and the edge list
+ */
+RegionPartition buildRegionPartition(const std::vector<City>& cities, const std::vector<Road>& roads);
+
+#endif // RWANDA_REGIONS_H
@@ -0,0 +1,117 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - road attributes
+ *
+ * Implements the columnar road attribute store and its scans.
+ *****************************************************************/
+
+#include "road_attributes.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+
+string lowerCase(const string& text) {
+    string lower = text;
+    transform(lower.begin(), lower.end(), lower.begin(),
+              [](unsigned char c) { return static_cast<char>(tolower(c)); });
+    return lower;
+}
+
+} // namespace
+
+RoadAttributeStore::RoadAttributeStore() {
+    for (const char* name : {"unknown", "asphalt", "concrete", "gravel", "earth"}) {
+        surfaceCodes[name] = surfaceNames.size();
+        surfaceNames.push_back(name);
+    }
+}
+
+void RoadAttributeStore::resize(size_t roadCount) {
+    lengths.resize(roadCount, 0.0f);
+    surfaces.resize(roadCount, 0);
+    laneCounts.resize(roadCount, 0);
+    conditions.resize(roadCount, NOT_RATED);
+}
+
+bool RoadAttributeStore::set(int roadId, const RoadAttributes& attributes) {
+    // NaN fails every comparison, so the length is checked to be finite
+    if (roadId < 0 || !isfinite(attributes.lengthKm) || attributes.lengthKm < 0 ||
+        attributes.lanes < 0 || attributes.lanes > 255 ||
+        attributes.condition < NOT_RATED || attributes.condition > MAX_CONDITION) {
+        return false;
+    }
+
+    string surface = lowerCase(attributes.surface.empty() ? "unknown" : attributes.surface);
+    auto found = surfaceCodes.find(surface);
+    if (found == surfaceCodes.end()) {
+        if (surfaceNames.size() >= MAX_SURFACES) {
+            return false;
+        }
+        found = surfaceCodes.emplace(surface, surfaceNames.size()).first;
+        surfaceNames.push_back(surface);
+    }
+
+    if (static_cast<size_t>(roadId) >= size()) {
+        resize(roadId + 1);
+    }
+    lengths[roadId] = static_cast<float>(attributes.lengthKm);
+    surfaces[roadId] = found->second;
+    laneCounts[roadId] = static_cast<uint8_t>(attributes.lanes);
+    conditions[roadId] = static_cast<uint8_t>(attributes.condition);
+    return true;
+}
+
+RoadAttributes RoadAttributeStore::get(int roadId) const {
+    if (roadId < 0 || static_cast<size_t>(roadId) >= size()) {
+        return {0.0, surfaceNames[0], 0, NOT_RATED};
+    }
+    return {lengths[roadId], surfaceNames[surfaces[roadId]], laneCounts[roadId], conditions[roadId]};
+}
+
+int RoadAttributeStore::surfaceCode(const string& name) const {
+    auto found = surfaceCodes.find(lowerCase(name));
+    return found == surfaceCodes.end() ? -1 : found->second;
+}
+
+vector<int> RoadAttributeStore::roadsWithSurface(int code) const {
+    vector<int> selected;
+    int count = surfaces.size();
+    for (int id = 0; id < count; ++id) {
+        if (surfaces[id] == code) {
+            selected.push_back(id);
+        }
+    }
+    return selected;
+}
+
+vector<int> RoadAttributeStore::ratedBelow(const vector<int>& candidates, int limit) const {
+    vector<int> selected;
+    for (int id : candidates) {
+        int condition = conditions[id];
+        if (condition != NOT_RATED && condition < limit) {
+            selected.push_back(id);
+        }
+    }
+    return selected;
+}
+
+size_t RoadAttributeStore::usedBytes() const {
+    size_t bytes = lengths.size() * sizeof(float) + surfaces.size() + laneCounts.size() + conditions.size();
+    for (const string& name : surfaceNames) {
+        bytes += sizeof(string) + name.size();
+    }
+    return bytes;
+}
+
+size_t RoadAttributeStore::capacityBytes() const {
+    size_t bytes = lengths.capacity() * sizeof(float) + surfaces.capacity()
+                 + laneCounts.capacity() + conditions.capacity();
+    for (const string& name : surfaceNames) {
+        bytes += sizeof(string) + name.capacity();
+    }
+    return bytes;
+}
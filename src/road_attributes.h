@@ -0,0 +1,117 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - road attributes
+ *
+ * Per-road length, surface, lane count and condition, stored
+ * column by column and keyed by road id (the index in the edge
+ * list). Surface names are dictionary-encoded into one byte per
+ * road. A scan such as "gravel roads in poor condition" reads the
+ * surface and condition columns and nothing else.
+ *****************************************************************/
+
+#ifndef RWANDA_ROAD_ATTRIBUTES_H
+#define RWANDA_ROAD_ATTRIBUTES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//====================================================================
+// STRUCTURES
+//====================================================================
+
+/**
+ * The attributes of one road, decoded
+ * Condition is a score from 1 (very poor) to 5 (very good), or 0
+ * if the road has not been rated
+ */
+struct RoadAttributes {
+    double lengthKm;
+    std::string surface;
+    int lanes;
+    int condition;
+};
+
+//====================================================================
+// ROAD ATTRIBUTE STORE
+//====================================================================
+
+class RoadAttributeStore {
+private:
+    std::vector<float> lengths;                     // Kilometres
+    std::vector<uint8_t> surfaces;                  // Codes into surfaceNames
+    std::vector<uint8_t> laneCounts;
+    std::vector<uint8_t> conditions;                // 0 = not rated, otherwise 1-5
+    std::vector<std::string> surfaceNames;          // Surface dictionary, code -> name
+    std::unordered_map<std::string, uint8_t> surfaceCodes;
+
+public:
+    static constexpr int NOT_RATED = 0;
+    static constexpr int MAX_CONDITION = 5;
+    static constexpr int MAX_SURFACES = 256;
+
+    /**
+     * Creates an empty store whose dictionary holds the common
+     * surfaces; code 0 is "unknown"
+     */
+    RoadAttributeStore();
+
+    /**
+     * Grows or shrinks every column to the given number of roads
+     * New roads have no length, an unknown surface and no rating
+     */
+    void resize(size_t roadCount);
+
+    size_t size() const {
+        return lengths.size();
+    }
+
+    /**
+     * Stores the attributes of a road, growing the columns if needed
+     * @return False if the values are out of range or the surface
+     *         dictionary is full
+     */
+    bool set(int roadId, const RoadAttributes& attributes);
+
+    /**
+     * Decodes the attributes of one road
+     */
+    RoadAttributes get(int roadId) const;
+
+    /**
+     * Looks up the code of a surface name (case-insensitive)
+     * @return The code, or -1 if the surface is not in the dictionary
+     */
+    int surfaceCode(const std::string& name) const;
+
+    const std::string& surfaceName(int code) const {
+        return surfaceNames[code];
+    }
+
+    int surfaceCount() const {
+        return surfaceNames.size();
+    }
+
+    const std::vector<float>& lengthColumn() const { return lengths; }
+    const std::vector<uint8_t>& surfaceColumn() const { return surfaces; }
+    const std::vector<uint8_t>& laneColumn() const { return laneCounts; }
+    const std::vector<uint8_t>& conditionColumn() const { return conditions; }
+
+    /**
+     * Ids of the roads with the given surface, reading only the
+     * surface column
+     */
+    std::vector<int> roadsWithSurface(int code) const;
+
+    /**
+     * Keeps the candidates that are rated below the given score,
+     * reading only the condition column
+     */
+    std::vector<int> ratedBelow(const std::vector<int>& candidates, int limit) const;
+
+    size_t usedBytes() const;
+    size_t capacityBytes() const;
+};
+
+#endif // RWANDA_ROAD_ATTRIBUTES_H
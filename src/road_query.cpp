@@ -0,0 +1,448 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - road queries
+ *
+ * Implements the query parser and the batch-at-a-time executor.
+ *****************************************************************/
+
+#include "road_query.h"
+#include "budget_kernels.h"
+#include "regions.h"
+#include "road_attributes.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <map>
+
+using namespace std;
+
+namespace {
+
+//--------------------------------------------------------------------
+// Parsing
+//--------------------------------------------------------------------
+
+string lowerCase(const string& text) {
+    string lower = text;
+    transform(lower.begin(), lower.end(), lower.begin(),
+              [](unsigned char c) { return static_cast<char>(tolower(c)); });
+    return lower;
+}
+
+/**
+ * Splits a query into words, quoted names and comparison operators
+ */
+vector<string> tokenize(const string& text) {
+    vector<string> tokens;
+    size_t i = 0;
+    while (i < text.size()) {
+        char c = text[i];
+        if (isspace(static_cast<unsigned char>(c))) {
+            i++;
+        } else if (c == '"') {
+            size_t end = text.find('"', i + 1);
+            if (end == string::npos) {
+                end = text.size();
+            }
+            tokens.push_back(text.substr(i, end - i));      // Keeps the opening quote as a marker
+            i = end + 1;
+        } else if (c == '<' || c == '>' || c == '=' || c == '!') {
+            size_t length = i + 1 < text.size() && text[i + 1] == '=' ? 2 : 1;
+            tokens.push_back(text.substr(i, length));
+            i += length;
+        } else {
+            size_t start = i;
+            while (i < text.size() && !isspace(static_cast<unsigned char>(text[i])) &&
+                   text[i] != '<' && text[i] != '>' && text[i] != '=' && text[i] != '!' && text[i] != '"') {
+                i++;
+            }
+            tokens.push_back(text.substr(start, i - start));
+        }
+    }
+    return tokens;
+}
+
+bool parseField(const string& word, QueryField& field) {
+    static const map<string, QueryField> fields = {
+        {"budget", QueryField::Budget}, {"length", QueryField::Length},
+        {"lanes", QueryField::Lanes}, {"condition", QueryField::Condition},
+        {"surface", QueryField::Surface}, {"city", QueryField::City},
+        {"district", QueryField::District}, {"province", QueryField::Province}
+    };
+    auto found = fields.find(lowerCase(word));
+    if (found == fields.end()) {
+        return false;
+    }
+    field = found->second;
+    return true;
+}
+
+bool parseComparison(const string& word, Comparison& comparison) {
+    static const map<string, Comparison> comparisons = {
+        {"=", Comparison::Equal}, {"==", Comparison::Equal}, {"!=", Comparison::NotEqual},
+        {"<", Comparison::Less}, {"<=", Comparison::LessEqual},
+        {">", Comparison::Greater}, {">=", Comparison::GreaterEqual}
+    };
+    auto found = comparisons.find(word);
+    if (found == comparisons.end()) {
+        return false;
+    }
+    comparison = found->second;
+    return true;
+}
+
+bool parseAggregate(const string& word, QueryAggregate& aggregate) {
+    static const map<string, QueryAggregate> aggregates = {
+        {"list", QueryAggregate::List}, {"count", QueryAggregate::Count},
+        {"sum", QueryAggregate::Sum}, {"avg", QueryAggregate::Average},
+        {"average", QueryAggregate::Average}, {"min", QueryAggregate::Min},
+        {"max", QueryAggregate::Max}
+    };
+    auto found = aggregates.find(lowerCase(word));
+    if (found == aggregates.end()) {
+        return false;
+    }
+    aggregate = found->second;
+    return true;
+}
+
+bool parseNumber(const string& word, double& value) {
+    char* end = nullptr;
+    value = strtod(word.c_str(), &end);
+    return !word.empty() && end != nullptr && *end == '\0' && isfinite(value);
+}
+
+bool isNamedField(QueryField field) {
+    return field == QueryField::Surface || field == QueryField::City ||
+           field == QueryField::District || field == QueryField::Province;
+}
+
+//--------------------------------------------------------------------
+// Execution
+//--------------------------------------------------------------------
+
+/**
+ * The rows of one batch that are still selected
+ * Until the first predicate runs the batch is dense (every row in
+ * [base, base + count) is selected and ids holds nothing yet)
+ */
+struct Batch {
+    int base;
+    int count;
+    bool dense;
+    int selected;
+    int* ids;
+};
+
+/**
+ * Keeps the rows for which keep(id) is true
+ * The id is written unconditionally and the count advanced by the
+ * test, so the loop has no data-dependent branch
+ */
+template <typename Keep>
+void narrow(Batch& batch, Keep keep) {
+    int kept = 0;
+    if (batch.dense) {
+        for (int i = 0; i < batch.count; ++i) {
+            int id = batch.base + i;
+            batch.ids[kept] = id;
+            kept += keep(id);
+        }
+        batch.dense = false;
+    } else {
+        for (int j = 0; j < batch.selected; ++j) {
+            int id = batch.ids[j];
+            batch.ids[kept] = id;
+            kept += keep(id);
+        }
+    }
+    batch.selected = kept;
+}
+
+/**
+ * Compares column values converted to the type of value, so budget
+ * columns compare as integers, lengths as floats and the others as
+ * doubles
+ */
+template <typename T, typename V, typename Compare>
+void narrowColumn(Batch& batch, const T* column, V value, Compare compare) {
+    narrow(batch, [column, value, compare](int id) {
+        return static_cast<int>(compare(static_cast<V>(column[id]), value));
+    });
+}
+
+template <typename T, typename V>
+void compareColumn(Batch& batch, const T* column, Comparison comparison, V value) {
+    switch (comparison) {
+        case Comparison::Equal:        narrowColumn(batch, column, value, equal_to<V>()); break;
+        case Comparison::NotEqual:     narrowColumn(batch, column, value, not_equal_to<V>()); break;
+        case Comparison::Less:         narrowColumn(batch, column, value, less<V>()); break;
+        case Comparison::LessEqual:    narrowColumn(batch, column, value, less_equal<V>()); break;
+        case Comparison::Greater:      narrowColumn(batch, column, value, greater<V>()); break;
+        case Comparison::GreaterEqual: narrowColumn(batch, column, value, greater_equal<V>()); break;
+    }
+}
+
+/**
+ * Keeps roads with either endpoint equal to code (or neither, for !=)
+ */
+template <typename T>
+void compareEndpoints(Batch& batch, const T* first, const T* second, Comparison comparison, int code) {
+    int wanted = comparison == Comparison::Equal ? 1 : 0;
+    narrow(batch, [first, second, code, wanted](int id) {
+        return static_cast<int>(((first[id] == code) | (second[id] == code)) == wanted);
+    });
+}
+
+void applyPredicate(Batch& batch, const RoadTable& table, const QueryPredicate& predicate,
+                    const vector<int16_t>& provinceOf) {
+    switch (predicate.field) {
+        case QueryField::Budget:
+            compareColumn(batch, table.budget.data(), predicate.comparison, predicate.budget);
+            break;
+        case QueryField::Length:
+            // Lengths are stored as floats, so 12.3 must match 12.3f
+            compareColumn(batch, table.length.data(), predicate.comparison, static_cast<float>(predicate.number));
+            break;
+        case QueryField::Lanes:
+            compareColumn(batch, table.lanes.data(), predicate.comparison, predicate.number);
+            break;
+        case QueryField::Condition: {
+            // Unrated roads have no score to compare, as in ratedBelow()
+            const uint8_t* condition = table.condition.data();
+            narrow(batch, [condition](int id) {
+                return static_cast<int>(condition[id] != RoadAttributeStore::NOT_RATED);
+            });
+            compareColumn(batch, condition, predicate.comparison, predicate.number);
+            break;
+        }
+        case QueryField::Surface:
+            compareColumn(batch, table.surface.data(), predicate.comparison, predicate.code);
+            break;
+        case QueryField::City:
+            compareEndpoints(batch, table.city1.data(), table.city2.data(), predicate.comparison, predicate.code);
+            break;
+        case QueryField::District:
+            compareEndpoints(batch, table.district1.data(), table.district2.data(),
+                             predicate.comparison, predicate.code);
+            break;
+        case QueryField::Province: {
+            // provinceOf is indexed by district + 1 so unassigned cities map to -1
+            const int16_t* province = provinceOf.data() + 1;
+            const int16_t* first = table.district1.data();
+            const int16_t* second = table.district2.data();
+            int code = predicate.code;
+            int wanted = predicate.comparison == Comparison::Equal ? 1 : 0;
+            narrow(batch, [province, first, second, code, wanted](int id) {
+                return static_cast<int>(((province[first[id]] == code) | (province[second[id]] == code)) == wanted);
+            });
+            break;
+        }
+    }
+}
+
+} // namespace
+
+//====================================================================
+// ROAD TABLE
+//====================================================================
+
+size_t RoadTable::usedBytes() const {
+    return size() * (2 * sizeof(int32_t) + sizeof(Budget) + sizeof(float) + 3 * sizeof(uint8_t) +
+                     2 * sizeof(int16_t));
+}
+
+size_t RoadTable::capacityBytes() const {
+    return (city1.capacity() + city2.capacity()) * sizeof(int32_t) + budget.capacity() * sizeof(Budget) +
+           length.capacity() * sizeof(float) + surface.capacity() + lanes.capacity() + condition.capacity() +
+           (district1.capacity() + district2.capacity()) * sizeof(int16_t);
+}
+
+//====================================================================
+// QUERY FUNCTIONS
+//====================================================================
+
+bool parseRoadQuery(const string& text, RoadQuery& query, string& error) {
+    query = RoadQuery();
+    vector<string> tokens = tokenize(text);
+    size_t pos = 0;
+    auto next = [&tokens, &pos]() { return pos < tokens.size() ? tokens[pos] : string(); };
+
+    if (lowerCase(next()) == "where") {
+        pos++;
+    }
+
+    QueryAggregate aggregate = QueryAggregate::List;
+    while (pos < tokens.size() && !parseAggregate(next(), aggregate)) {
+        QueryPredicate predicate = {QueryField::Budget, Comparison::Equal, 0.0, 0, "", -1};
+        if (!parseField(next(), predicate.field)) {
+            error = "Unknown field '" + next() + "'";
+            return false;
+        }
+        pos++;
+        if (!parseComparison(next(), predicate.comparison)) {
+            error = "Expected a comparison after '" + tokens[pos - 1] + "'";
+            return false;
+        }
+        pos++;
+        string value = next();
+        if (value.empty()) {
+            error = "Missing value after '" + tokens[pos - 1] + "'";
+            return false;
+        }
+        pos++;
+
+        if (isNamedField(predicate.field)) {
+            if (predicate.comparison != Comparison::Equal && predicate.comparison != Comparison::NotEqual) {
+                error = "Names can only be compared with = or !=";
+                return false;
+            }
+            predicate.text = value[0] == '"' ? value.substr(1) : value;
+        } else if (predicate.field == QueryField::Budget) {
+            if (!parseBudget(value, predicate.budget)) {
+                error = "Expected a budget in billions with at most " + to_string(BUDGET_DECIMALS) +
+                        " decimals instead of '" + value + "'";
+                return false;
+            }
+        } else if (!parseNumber(value, predicate.number)) {
+            error = "Expected a number instead of '" + value + "'";
+            return false;
+        }
+        query.predicates.push_back(predicate);
+
+        if (lowerCase(next()) == "and") {
+            pos++;
+            if (pos == tokens.size()) {
+                error = "Missing condition after 'and'";
+                return false;
+            }
+        } else if (pos < tokens.size() && !parseAggregate(next(), aggregate)) {
+            error = "Expected 'and' or an aggregate instead of '" + next() + "'";
+            return false;
+        }
+    }
+
+    if (pos == tokens.size()) {
+        return true;
+    }
+    query.aggregate = aggregate;
+    pos++;
+
+    if (lowerCase(next()) == "by") {
+        pos++;
+        string grouping = lowerCase(next());
+        pos++;
+        if (grouping == "surface") {
+            query.grouping = QueryGrouping::Surface;
+        } else if (grouping == "bucket") {
+            if (!parseBudget(next(), query.bucketWidth) || query.bucketWidth <= 0) {
+                error = "Expected a positive bucket width after 'bucket'";
+                return false;
+            }
+            pos++;
+            query.grouping = QueryGrouping::BudgetBucket;
+        } else {
+            error = "Expected 'bucket <width>' or 'surface' after 'by'";
+            return false;
+        }
+        if (query.aggregate == QueryAggregate::List) {
+            query.aggregate = QueryAggregate::Count;
+        }
+    }
+
+    if (pos != tokens.size()) {
+        error = "Unexpected '" + next() + "' at the end of the query";
+        return false;
+    }
+    return true;
+}
+
+QueryResult executeRoadQuery(const RoadTable& table, const RoadQuery& query) {
+    RWANDA_TRACE_SCOPE("executeRoadQuery", "analytics");
+    QueryResult result;
+
+    vector<int16_t> provinceOf(DISTRICT_COUNT + 1, -1);
+    for (int d = 0; d < DISTRICT_COUNT; ++d) {
+        provinceOf[d + 1] = RWANDA_DISTRICTS[d].province;
+    }
+
+    map<long, QueryGroup> groups;
+    if (query.aggregate != QueryAggregate::List && query.grouping == QueryGrouping::None) {
+        groups[0] = {0, 0, 0, numeric_limits<Budget>::max(), numeric_limits<Budget>::min()};
+    }
+
+    vector<int> ids(QUERY_BATCH_SIZE);
+    vector<Budget> selectedBudgets(QUERY_BATCH_SIZE);
+    int total = table.size();
+    for (int base = 0; base < total; base += QUERY_BATCH_SIZE) {
+        Batch batch = {base, min(QUERY_BATCH_SIZE, total - base), true, 0, ids.data()};
+        for (const QueryPredicate& predicate : query.predicates) {
+            applyPredicate(batch, table, predicate, provinceOf);
+        }
+        if (batch.dense) {
+            for (int i = 0; i < batch.count; ++i) {
+                ids[i] = base + i;
+            }
+            batch.selected = batch.count;
+        }
+
+        if (query.aggregate == QueryAggregate::List) {
+            result.roadIds.insert(result.roadIds.end(), ids.begin(), ids.begin() + batch.selected);
+            continue;
+        }
+        if (query.grouping == QueryGrouping::None) {
+            // Gather the selected budgets (a dense batch is already
+            // contiguous) and reduce them in one pass
+            const Budget* values = table.budget.data() + base;
+            if (batch.selected < batch.count) {
+                for (int j = 0; j < batch.selected; ++j) {
+                    selectedBudgets[j] = table.budget[ids[j]];
+                }
+                values = selectedBudgets.data();
+            }
+            QueryGroup& group = groups[0];
+            group.count += batch.selected;
+            group.sum += sumBudgets(values, batch.selected);
+            for (int j = 0; j < batch.selected; ++j) {
+                group.min = min(group.min, values[j]);
+                group.max = max(group.max, values[j]);
+            }
+            continue;
+        }
+        for (int j = 0; j < batch.selected; ++j) {
+            int id = ids[j];
+            Budget budget = table.budget[id];
+            // Budgets are never negative, so division rounds down
+            long key = query.grouping == QueryGrouping::BudgetBucket ? budget / query.bucketWidth : table.surface[id];
+            auto inserted = groups.emplace(key, QueryGroup{key, 0, 0, budget, budget});
+            QueryGroup& group = inserted.first->second;
+            group.count++;
+            group.sum += budget;
+            group.min = min(group.min, budget);
+            group.max = max(group.max, budget);
+        }
+    }
+
+    for (const auto& entry : groups) {
+        result.groups.push_back(entry.second);
+        if (entry.second.count == 0) {
+            result.groups.back().min = 0;
+            result.groups.back().max = 0;
+        }
+    }
+    return result;
+}
+
+const char* roadQueryHelp() {
+    return "  [where] <field> <op> <value> [and ...] [list|count|sum|avg|min|max] [by bucket <width>|by surface]\n"
+           "  Fields: budget, length, lanes, condition (numbers); city, district, province, surface (names)\n"
+           "  Roads without a condition rating never match a condition\n"
+           "  Operators: = != < <= > >= (names only = and !=); quote names with spaces\n"
+           "  Examples: city = Musanze and budget > 50\n"
+           "            surface = gravel and condition < 3 sum\n"
+           "            count by bucket 25\n";
+}
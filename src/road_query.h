@@ -0,0 +1,135 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - road queries
+ *
+ * A small query engine over the roads. A query is a list of
+ * predicates joined by "and", followed by an optional aggregate
+ * and grouping, e.g.
+ *
+ *   city = Musanze and budget > 50
+ *   surface = gravel and condition < 3 sum
+ *   count by bucket 25
+ *
+ * Names in the predicates are resolved to integer codes once, and
+ * the query is run batch by batch over a columnar copy of the edge
+ * list: each predicate narrows a selection vector with a tight
+ * loop over a single column, and the aggregate reads only the
+ * selected rows. Budgets are compared and added as whole thousands
+ * of RWF, so sums and bucket edges are exact.
+ *****************************************************************/
+
+#ifndef RWANDA_ROAD_QUERY_H
+#define RWANDA_ROAD_QUERY_H
+
+#include "budget.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//====================================================================
+// STRUCTURES
+//====================================================================
+
+enum class QueryField { Budget, Length, Lanes, Condition, Surface, City, District, Province };
+
+enum class Comparison { Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual };
+
+enum class QueryAggregate { List, Count, Sum, Average, Min, Max };
+
+enum class QueryGrouping { None, BudgetBucket, Surface };
+
+/**
+ * One condition on a road
+ * Budgets compare against budget, the other numeric fields against
+ * number. City, district, province
+ * and surface compare by name (text), which is resolved to code
+ * before the query runs; a road matches a city, district or
+ * province when either of its endpoints does
+ */
+struct QueryPredicate {
+    QueryField field;
+    Comparison comparison;
+    double number;
+    Budget budget;
+    std::string text;
+    int code;
+};
+
+struct RoadQuery {
+    std::vector<QueryPredicate> predicates;
+    QueryAggregate aggregate = QueryAggregate::List;
+    QueryGrouping grouping = QueryGrouping::None;
+    Budget bucketWidth = 0;
+};
+
+/**
+ * The roads as one array per column, indexed by road id
+ */
+struct RoadTable {
+    std::vector<int32_t> city1;         // 0-based slots
+    std::vector<int32_t> city2;
+    std::vector<Budget> budget;
+    std::vector<float> length;
+    std::vector<uint8_t> surface;
+    std::vector<uint8_t> lanes;
+    std::vector<uint8_t> condition;
+    std::vector<int16_t> district1;     // District of each endpoint, -1 if unassigned
+    std::vector<int16_t> district2;
+
+    size_t size() const {
+        return budget.size();
+    }
+
+    size_t usedBytes() const;
+    size_t capacityBytes() const;
+};
+
+/**
+ * Count and budget statistics of one group of roads
+ * key is the bucket index or the surface code
+ */
+struct QueryGroup {
+    long key;
+    size_t count;
+    Budget sum;
+    Budget min;
+    Budget max;
+};
+
+/**
+ * Selected road ids (for List) or one group per key, in key order
+ * Without grouping there is a single group with key 0
+ */
+struct QueryResult {
+    std::vector<int> roadIds;
+    std::vector<QueryGroup> groups;
+    std::string error;
+};
+
+//====================================================================
+// QUERY FUNCTIONS
+//====================================================================
+
+// Roads processed per batch; a batch's selection vector stays in L1
+constexpr int QUERY_BATCH_SIZE = 1024;
+
+/**
+ * Parses the text form of a query
+ * Names are left unresolved (code = -1)
+ * @param error Receives a message when parsing fails
+ * @return False if the text is not a valid query
+ */
+bool parseRoadQuery(const std::string& text, RoadQuery& query, std::string& error);
+
+/**
+ * Runs a query whose names have been resolved
+ */
+QueryResult executeRoadQuery(const RoadTable& table, const RoadQuery& query);
+
+/**
+ * Describes the query syntax, one line per clause
+ */
+const char* roadQueryHelp();
+
+#endif // RWANDA_ROAD_QUERY_H
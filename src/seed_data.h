@@ -0,0 +1,148 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - seed dataset
+ *
+ * The default network loaded at start-up. Roads name their cities
+ * and cities name their districts, and the names are resolved to
+ * indices at compile time, so a typo fails the build instead of
+ * silently dropping a road.
+ *****************************************************************/
+
+#ifndef RWANDA_SEED_DATA_H
+#define RWANDA_SEED_DATA_H
+
+#include "budget.h"
+#include "regions.h"
+
+//====================================================================
+// STRUCTURES
+//====================================================================
+
+/**
+ * A seed city with its district already resolved to an id and its
+ * coordinates in decimal degrees
+ */
+struct SeedCity {
+    const char* name;
+    int district;
+    double latitude;
+    double longitude;
+};
+
+/**
+ * A seed road with its cities already resolved to 1-based indices
+ */
+struct SeedRoad {
+    int city1;
+    int city2;
+    Budget budget;
+};
+
+//====================================================================
+// SEED DATA
+//====================================================================
+
+/**
+ * Compares two strings at compile time
+ */
+constexpr bool seedNamesEqual(const char* a, const char* b) {
+    while (*a != '\0' && *a == *b) {
+        ++a;
+        ++b;
+    }
+    return *a == *b;
+}
+
+/**
+ * Resolves a district name to its id
+ * @return The id, or -1 if the name is not a district
+ */
+constexpr int seedDistrictId(const char* name) {
+    for (int d = 0; d < DISTRICT_COUNT; ++d) {
+        if (seedNamesEqual(RWANDA_DISTRICTS[d].name, name)) {
+            return d;
+        }
+    }
+    return -1;
+}
+
+constexpr SeedCity SEED_CITIES[] = {
+    {"Kigali", seedDistrictId("Nyarugenge"), -1.9441, 30.0619},
+    {"Huye", seedDistrictId("Huye"), -2.5967, 29.7394},
+    {"Muhanga", seedDistrictId("Muhanga"), -2.0845, 29.7564},
+    {"Musanze", seedDistrictId("Musanze"), -1.4998, 29.6344},
+    {"Nyagatare", seedDistrictId("Nyagatare"), -1.2986, 30.3275},
+    {"Rubavu", seedDistrictId("Rubavu"), -1.6792, 29.2597},
+    {"Rusizi", seedDistrictId("Rusizi"), -2.4846, 28.9075}
+};
+
+constexpr int SEED_CITY_COUNT = sizeof(SEED_CITIES) / sizeof(SEED_CITIES[0]);
+
+/**
+ * Resolves a seed city name to its 1-based index
+ * @return The index, or -1 if the name is not a seed city
+ */
+constexpr int seedCityIndex(const char* name) {
+    for (int i = 0; i < SEED_CITY_COUNT; ++i) {
+        if (seedNamesEqual(SEED_CITIES[i].name, name)) {
+            return i + 1;
+        }
+    }
+    return -1;
+}
+
+constexpr SeedRoad SEED_ROADS[] = {
+    {seedCityIndex("Kigali"), seedCityIndex("Muhanga"), budgetFromBillions(28.6)},
+    {seedCityIndex("Kigali"), seedCityIndex("Musanze"), budgetFromBillions(28.6)},
+    {seedCityIndex("Kigali"), seedCityIndex("Nyagatare"), budgetFromBillions(70.84)},
+    {seedCityIndex("Muhanga"), seedCityIndex("Huye"), budgetFromBillions(56.7)},
+    {seedCityIndex("Musanze"), seedCityIndex("Rubavu"), budgetFromBillions(33.7)},
+    {seedCityIndex("Huye"), seedCityIndex("Rusizi"), budgetFromBillions(80.96)},
+    {seedCityIndex("Muhanga"), seedCityIndex("Rusizi"), budgetFromBillions(117.5)},
+    {seedCityIndex("Musanze"), seedCityIndex("Nyagatare"), budgetFromBillions(96.14)},
+    {seedCityIndex("Muhanga"), seedCityIndex("Musanze"), budgetFromBillions(66.3)}
+};
+
+constexpr int SEED_ROAD_COUNT = sizeof(SEED_ROADS) / sizeof(SEED_ROADS[0]);
+
+/**
+ * Checks every seed city at compile time
+ */
+constexpr bool seedCitiesValid() {
+    for (int i = 0; i < SEED_CITY_COUNT; ++i) {
+        const SeedCity& city = SEED_CITIES[i];
+        if (city.district < 0) {
+            return false;
+        }
+        // Rwanda lies within about 1-3 S and 28.8-31 E
+        if (city.latitude < -3.0 || city.latitude > -1.0 || city.longitude < 28.8 || city.longitude > 31.0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(seedCitiesValid(), "Every seed city must name a district and lie in Rwanda");
+
+/**
+ * Checks every seed road at compile time
+ */
+constexpr bool seedRoadsValid() {
+    for (int r = 0; r < SEED_ROAD_COUNT; ++r) {
+        const SeedRoad& road = SEED_ROADS[r];
+        if (road.city1 < 1 || road.city2 < 1 || road.city1 == road.city2 || road.budget < 0) {
+            return false;
+        }
+        for (int other = 0; other < r; ++other) {
+            const SeedRoad& previous = SEED_ROADS[other];
+            if ((previous.city1 == road.city1 && previous.city2 == road.city2) ||
+                (previous.city1 == road.city2 && previous.city2 == road.city1)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static_assert(seedRoadsValid(), "Seed roads must join two different seed cities once with a non-negative budget");
+
+#endif // RWANDA_SEED_DATA_H
@@ -0,0 +1,464 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - network snapshots
+ *
+ * Implements reading and writing snapshot files and the linear
+ * time diff between two snapshots.
+ *****************************************************************/
+
+#include "snapshot.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+/**
+ * Road with both endpoints in one numbering, lower endpoint first
+ * Forward means one-way from low to high
+ */
+struct KeyedRoad {
+    int low;
+    int high;
+    Budget budget;
+    RoadDirection direction;
+};
+
+/**
+ * The same direction seen from the other end of the road
+ */
+RoadDirection reversed(RoadDirection direction) {
+    switch (direction) {
+        case RoadDirection::Forward:
+            return RoadDirection::Backward;
+        case RoadDirection::Backward:
+            return RoadDirection::Forward;
+        default:
+            return RoadDirection::TwoWay;
+    }
+}
+
+string trim(const string& text) {
+    size_t first = text.find_first_not_of(" \t\r");
+    if (first == string::npos) {
+        return "";
+    }
+    size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+/**
+ * Splits "Name1-Name2", or "From->To" for a one-way road, at the
+ * dash that leaves two known cities, so city names may themselves
+ * contain dashes
+ */
+bool splitRoadName(const string& roadName, const unordered_map<string, int>& slots, int& city1, int& city2,
+                   bool& oneWay) {
+    for (size_t dash = roadName.find('-'); dash != string::npos; dash = roadName.find('-', dash + 1)) {
+        auto first = slots.find(roadName.substr(0, dash));
+        if (first == slots.end()) {
+            continue;
+        }
+        bool arrow = dash + 1 < roadName.size() && roadName[dash + 1] == '>';
+        auto second = slots.find(roadName.substr(dash + (arrow ? 2 : 1)));
+        if (second != slots.end()) {
+            city1 = first->second;
+            city2 = second->second;
+            oneWay = arrow;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Stable counting sort of roads by one small integer field,
+ * O(roads + keys)
+ */
+template <typename Field>
+void countingSort(vector<KeyedRoad>& roads, int keys, Field field) {
+    vector<size_t> offsets(keys + 1, 0);
+    for (const KeyedRoad& road : roads) {
+        ++offsets[field(road) + 1];
+    }
+    for (int k = 0; k < keys; ++k) {
+        offsets[k + 1] += offsets[k];
+    }
+    vector<KeyedRoad> sorted(roads.size());
+    for (const KeyedRoad& road : roads) {
+        sorted[offsets[field(road)]++] = road;
+    }
+    roads.swap(sorted);
+}
+
+/**
+ * Maps a snapshot's roads to the shared numbering and sorts them by
+ * (low, high, direction) with three counting-sort passes
+ */
+vector<KeyedRoad> sortedRoads(const vector<Road>& roads, const vector<int>& key, int keys) {
+    vector<KeyedRoad> keyed;
+    keyed.reserve(roads.size());
+    for (const Road& road : roads) {
+        int a = key[road.city1 - 1];
+        int b = key[road.city2 - 1];
+        RoadDirection direction = !road.oneWay ? RoadDirection::TwoWay
+                                  : (a < b ? RoadDirection::Forward : RoadDirection::Backward);
+        keyed.push_back({min(a, b), max(a, b), road.budget, direction});
+    }
+    countingSort(keyed, 3, [](const KeyedRoad& road) { return static_cast<int>(road.direction); });
+    countingSort(keyed, keys, [](const KeyedRoad& road) { return road.high; });
+    countingSort(keyed, keys, [](const KeyedRoad& road) { return road.low; });
+    return keyed;
+}
+
+/**
+ * "Name1-Name2", or "From->To" for a one-way road
+ */
+string roadText(const vector<string>& names, int city1, int city2, RoadDirection direction) {
+    switch (direction) {
+        case RoadDirection::Forward:
+            return names[city1] + "->" + names[city2];
+        case RoadDirection::Backward:
+            return names[city2] + "->" + names[city1];
+        default:
+            return names[city1] + "-" + names[city2];
+    }
+}
+
+} // namespace
+
+//====================================================================
+// FILE ROWS
+//====================================================================
+
+void writeCityHeader(ostream& out) {
+    out << left << setw(7) << "Index" << ' ' << "City_Name" << '\n';
+}
+
+void writeCityRow(ostream& out, int index, const string& name) {
+    out << left << setw(7) << index << ' ' << name << '\n';
+}
+
+void writeRoadHeader(ostream& out) {
+    out << left << setw(4) << "Nbr" << ' ' << setw(24) << "Road" << ' ' << "Budget" << '\n';
+}
+
+void writeRoadRow(ostream& out, int number, const string& roadName, Budget budget) {
+    out << left << setw(4) << (to_string(number) + ".") << ' ' << setw(24) << roadName << ' '
+        << formatBudget(budget) << '\n';
+}
+
+//====================================================================
+// SNAPSHOT FILES
+//====================================================================
+
+bool readSnapshot(const string& directory, NetworkSnapshot& snapshot) {
+    RWANDA_TRACE_SCOPE("readSnapshot", "load");
+    fs::path cityFilePath = fs::path(directory) / "cities.txt";
+    fs::path roadFilePath = fs::path(directory) / "roads.txt";
+
+    ifstream cityFile(cityFilePath);
+    if (!cityFile.is_open()) {
+        cerr << "Error: Could not open " << cityFilePath.string() << " for reading!" << endl;
+        return false;
+    }
+    ifstream roadFile(roadFilePath);
+    if (!roadFile.is_open()) {
+        cerr << "Error: Could not open " << roadFilePath.string() << " for reading!" << endl;
+        return false;
+    }
+
+    snapshot.cityNames.clear();
+    snapshot.roads.clear();
+
+    // "Index City_Name" rows; the name is the rest of the line
+    unordered_map<string, int> slots;
+    string line;
+    getline(cityFile, line);
+    while (getline(cityFile, line)) {
+        istringstream row(line);
+        int index;
+        if (!(row >> index)) {
+            continue;
+        }
+        string rest;
+        getline(row, rest);
+        string name = trim(rest);
+        slots.emplace(name, snapshot.cityNames.size());
+        snapshot.cityNames.push_back(name);
+    }
+
+    // "Nbr. Road Budget" rows, split at the first and the last blank,
+    // since a road name may contain blanks but the other fields do not
+    getline(roadFile, line);
+    while (getline(roadFile, line)) {
+        string row = trim(line);
+        size_t afterNumber = row.find_first_of(" \t");
+        size_t beforeBudget = row.find_last_of(" \t");
+        if (afterNumber == string::npos || beforeBudget <= afterNumber) {
+            continue;
+        }
+        string roadName = trim(row.substr(afterNumber, beforeBudget - afterNumber));
+        Budget budget;
+        int city1, city2;
+        bool oneWay;
+        if (!parseBudget(row.substr(beforeBudget + 1), budget) || !splitRoadName(roadName, slots, city1, city2, oneWay)) {
+            cerr << "Warning: Skipping unreadable road \"" << row << "\" in " << roadFilePath.string() << endl;
+            continue;
+        }
+        snapshot.roads.push_back({city1 + 1, city2 + 1, budget, oneWay});
+    }
+    return true;
+}
+
+bool writeSnapshot(const NetworkSnapshot& snapshot, const string& directory) {
+    RWANDA_TRACE_SCOPE("writeSnapshot", "save");
+    error_code error;
+    fs::create_directories(directory, error);
+    fs::path cityFilePath = fs::path(directory) / "cities.txt";
+    fs::path roadFilePath = fs::path(directory) / "roads.txt";
+
+    ofstream cityFile(cityFilePath);
+    if (!cityFile.is_open()) {
+        cerr << "Error: Could not open " << cityFilePath.string() << " for writing!" << endl;
+        return false;
+    }
+    writeCityHeader(cityFile);
+    for (size_t i = 0; i < snapshot.cityNames.size(); ++i) {
+        writeCityRow(cityFile, i + 1, snapshot.cityNames[i]);
+    }
+
+    ofstream roadFile(roadFilePath);
+    if (!roadFile.is_open()) {
+        cerr << "Error: Could not open " << roadFilePath.string() << " for writing!" << endl;
+        return false;
+    }
+    writeRoadHeader(roadFile);
+    int counter = 1;
+    for (const Road& road : snapshot.roads) {
+        int low = min(road.city1, road.city2);
+        int high = max(road.city1, road.city2);
+        string roadName = road.oneWay ? snapshot.cityNames[road.city1 - 1] + "->" + snapshot.cityNames[road.city2 - 1]
+                                      : snapshot.cityNames[low - 1] + "-" + snapshot.cityNames[high - 1];
+        writeRoadRow(roadFile, counter++, roadName, road.budget);
+    }
+    return true;
+}
+
+//====================================================================
+// DIFF
+//====================================================================
+
+vector<NetworkChange> diffSnapshots(const NetworkSnapshot& before, const NetworkSnapshot& after) {
+    RWANDA_TRACE_SCOPE("diffSnapshots", "analytics");
+    vector<NetworkChange> changes;
+    int beforeCount = before.cityNames.size();
+    int afterCount = after.cityNames.size();
+
+    // Hash join on names: build on the older cities, probe with the newer
+    unordered_map<string, int> beforeSlots;
+    beforeSlots.reserve(beforeCount);
+    for (int i = 0; i < beforeCount; ++i) {
+        beforeSlots.emplace(before.cityNames[i], i);
+    }
+    vector<int> matchOf(beforeCount, -1);      // Newer slot of each older city
+    vector<bool> matched(afterCount, false);
+    for (int j = 0; j < afterCount; ++j) {
+        auto found = beforeSlots.find(after.cityNames[j]);
+        if (found != beforeSlots.end() && matchOf[found->second] < 0) {
+            matchOf[found->second] = j;
+            matched[j] = true;
+        }
+    }
+
+    // An unmatched city whose slot holds another unmatched name was
+    // renamed, since editCity keeps the index
+    {
+        RWANDA_TRACE_SCOPE("match cities", "analytics");
+        for (int i = 0; i < beforeCount; ++i) {
+            if (matchOf[i] < 0 && i < afterCount && !matched[i]) {
+                matchOf[i] = i;
+                matched[i] = true;
+                changes.push_back({ChangeKind::CityRenamed, i, i, -1, -1, 0, 0});
+            }
+        }
+        for (int i = 0; i < beforeCount; ++i) {
+            if (matchOf[i] < 0) {
+                changes.push_back({ChangeKind::CityRemoved, i, -1, -1, -1, 0, 0});
+            }
+        }
+        for (int j = 0; j < afterCount; ++j) {
+            if (!matched[j]) {
+                changes.push_back({ChangeKind::CityAdded, -1, j, -1, -1, 0, 0});
+            }
+        }
+    }
+
+    // Shared numbering: newer slots, then the removed older cities
+    int keys = afterCount;
+    vector<int> beforeKey(beforeCount);
+    for (int i = 0; i < beforeCount; ++i) {
+        beforeKey[i] = matchOf[i] >= 0 ? matchOf[i] : keys++;
+    }
+    vector<int> afterKey(afterCount);
+    for (int j = 0; j < afterCount; ++j) {
+        afterKey[j] = j;
+    }
+    vector<int> beforeSlotOf(keys, -1);
+    for (int i = 0; i < beforeCount; ++i) {
+        beforeSlotOf[beforeKey[i]] = i;
+    }
+
+    vector<KeyedRoad> oldRoads, newRoads;
+    {
+        RWANDA_TRACE_SCOPE("sort edges", "analytics");
+        oldRoads = sortedRoads(before.roads, beforeKey, keys);
+        newRoads = sortedRoads(after.roads, afterKey, keys);
+    }
+
+    // Merge join on (low, high), one pair of cities at a time; within a
+    // pair, roads with the same direction are joined first and those
+    // left over on both sides have changed direction
+    RWANDA_TRACE_SCOPE("merge edges", "analytics");
+    auto removed = [&](const KeyedRoad& road) {
+        int city1 = beforeSlotOf[road.low];
+        int city2 = beforeSlotOf[road.high];
+        RoadDirection direction = city1 < city2 ? road.direction : reversed(road.direction);
+        NetworkChange change = {ChangeKind::RoadRemoved, -1, -1, min(city1, city2), max(city1, city2),
+                                road.budget, 0};
+        change.oldDirection = direction;
+        changes.push_back(change);
+    };
+    auto added = [&](const KeyedRoad& road) {
+        NetworkChange change = {ChangeKind::RoadAdded, -1, -1, road.low, road.high, 0, road.budget};
+        change.newDirection = road.direction;
+        changes.push_back(change);
+    };
+    auto samePair = [](const KeyedRoad& x, const KeyedRoad& y) {
+        return x.low == y.low && x.high == y.high;
+    };
+
+    vector<const KeyedRoad*> oldLeft, newLeft;
+    size_t a = 0, b = 0;
+    while (a < oldRoads.size() || b < newRoads.size()) {
+        int order;                              // < 0: only older, > 0: only newer
+        if (a == oldRoads.size()) {
+            order = 1;
+        } else if (b == newRoads.size()) {
+            order = -1;
+        } else if (oldRoads[a].low != newRoads[b].low) {
+            order = oldRoads[a].low < newRoads[b].low ? -1 : 1;
+        } else {
+            order = oldRoads[a].high == newRoads[b].high ? 0 : (oldRoads[a].high < newRoads[b].high ? -1 : 1);
+        }
+
+        if (order < 0) {
+            removed(oldRoads[a++]);
+            continue;
+        }
+        if (order > 0) {
+            added(newRoads[b++]);
+            continue;
+        }
+
+        size_t oldEnd = a, newEnd = b;
+        while (oldEnd < oldRoads.size() && samePair(oldRoads[oldEnd], oldRoads[a])) {
+            oldEnd++;
+        }
+        while (newEnd < newRoads.size() && samePair(newRoads[newEnd], newRoads[b])) {
+            newEnd++;
+        }
+        oldLeft.clear();
+        newLeft.clear();
+        while (a < oldEnd || b < newEnd) {
+            if (b == newEnd || (a < oldEnd && oldRoads[a].direction < newRoads[b].direction)) {
+                oldLeft.push_back(&oldRoads[a++]);
+            } else if (a == oldEnd || newRoads[b].direction < oldRoads[a].direction) {
+                newLeft.push_back(&newRoads[b++]);
+            } else {
+                const KeyedRoad& oldRoad = oldRoads[a++];
+                const KeyedRoad& newRoad = newRoads[b++];
+                if (oldRoad.budget != newRoad.budget) {
+                    NetworkChange change = {ChangeKind::BudgetChanged, -1, -1, newRoad.low, newRoad.high,
+                                            oldRoad.budget, newRoad.budget};
+                    change.oldDirection = change.newDirection = newRoad.direction;
+                    changes.push_back(change);
+                }
+            }
+        }
+        size_t turned = min(oldLeft.size(), newLeft.size());
+        for (size_t k = 0; k < turned; ++k) {
+            NetworkChange change = {ChangeKind::DirectionChanged, -1, -1, newLeft[k]->low, newLeft[k]->high,
+                                    oldLeft[k]->budget, newLeft[k]->budget};
+            change.oldDirection = oldLeft[k]->direction;
+            change.newDirection = newLeft[k]->direction;
+            changes.push_back(change);
+        }
+        for (size_t k = turned; k < oldLeft.size(); ++k) {
+            removed(*oldLeft[k]);
+        }
+        for (size_t k = turned; k < newLeft.size(); ++k) {
+            added(*newLeft[k]);
+        }
+    }
+    return changes;
+}
+
+void printChanges(const NetworkSnapshot& before, const NetworkSnapshot& after,
+                  const vector<NetworkChange>& changes, ostream& out) {
+    if (changes.empty()) {
+        out << "No changes.\n";
+        return;
+    }
+
+    size_t counts[7] = {0, 0, 0, 0, 0, 0, 0};
+    for (const NetworkChange& change : changes) {
+        ++counts[static_cast<int>(change.kind)];
+        switch (change.kind) {
+            case ChangeKind::CityAdded:
+                out << "+ city  " << after.cityNames[change.after] << " (index " << change.after + 1 << ")\n";
+                break;
+            case ChangeKind::CityRemoved:
+                out << "- city  " << before.cityNames[change.before] << " (index " << change.before + 1 << ")\n";
+                break;
+            case ChangeKind::CityRenamed:
+                out << "~ city  " << before.cityNames[change.before] << " -> "
+                    << after.cityNames[change.after] << " (index " << change.after + 1 << ")\n";
+                break;
+            case ChangeKind::RoadAdded:
+                out << "+ road  " << roadText(after.cityNames, change.city1, change.city2, change.newDirection)
+                    << "  " << formatBudget(change.newBudget) << " billion RWF\n";
+                break;
+            case ChangeKind::RoadRemoved:
+                out << "- road  " << roadText(before.cityNames, change.city1, change.city2, change.oldDirection)
+                    << "  " << formatBudget(change.oldBudget) << " billion RWF\n";
+                break;
+            case ChangeKind::BudgetChanged:
+                out << "~ road  " << roadText(after.cityNames, change.city1, change.city2, change.newDirection)
+                    << "  " << formatBudget(change.oldBudget) << " -> " << formatBudget(change.newBudget)
+                    << " billion RWF\n";
+                break;
+            case ChangeKind::DirectionChanged:
+                out << "~ road  " << roadText(after.cityNames, change.city1, change.city2, change.oldDirection)
+                    << " now " << roadText(after.cityNames, change.city1, change.city2, change.newDirection);
+                if (change.oldBudget != change.newBudget) {
+                    out << "  " << formatBudget(change.oldBudget) << " -> " << formatBudget(change.newBudget);
+                } else {
+                    out << "  " << formatBudget(change.newBudget);
+                }
+                out << " billion RWF\n";
+                break;
+        }
+    }
+    out << "\nCities: " << counts[0] << " added, " << counts[2] << " renamed, " << counts[1] << " removed\n";
+    out << "Roads: " << counts[3] << " added, " << counts[4] << " removed, " << counts[5] << " budgets changed, "
+        << counts[6] << " directions changed\n";
+}
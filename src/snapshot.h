@@ -0,0 +1,121 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - network snapshots
+ *
+ * A snapshot is a copy of the cities and roads at one point in
+ * time, taken from a running network or read back from the
+ * cities.txt / roads.txt files. Two snapshots are compared in
+ * linear time: a hash join on the city names matches the cities
+ * (a city keeps its index when renamed), then both edge lists are
+ * counting-sorted by their matched endpoints and direction and
+ * merge-joined. Parallel roads between the same cities are paired
+ * in the order they were added, roads with the same direction
+ * first; a road left over on each side counts as a change of
+ * direction.
+ *****************************************************************/
+
+#ifndef RWANDA_SNAPSHOT_H
+#define RWANDA_SNAPSHOT_H
+
+#include "graph_engine.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+//====================================================================
+// STRUCTURES
+//====================================================================
+
+/**
+ * Cities (name of index i + 1 at position i) and roads by 1-based index
+ */
+struct NetworkSnapshot {
+    std::vector<std::string> cityNames;
+    std::vector<Road> roads;
+};
+
+enum class ChangeKind : uint8_t {
+    CityAdded,          // after = slot in the newer snapshot
+    CityRemoved,        // before = slot in the older snapshot
+    CityRenamed,        // before and after = the city's slots
+    RoadAdded,          // city1, city2 = slots in the newer snapshot
+    RoadRemoved,        // city1, city2 = slots in the older snapshot
+    BudgetChanged,      // city1, city2 = slots in the newer snapshot
+    DirectionChanged    // city1, city2 = slots in the newer snapshot
+};
+
+/**
+ * Which way a road is travelled, relative to the city1 and city2 of
+ * a change
+ */
+enum class RoadDirection : uint8_t {
+    TwoWay,
+    Forward,            // One-way from city1 to city2
+    Backward            // One-way from city2 to city1
+};
+
+/**
+ * One difference between two snapshots
+ * Cities are referred to by slot so a change set holds no strings;
+ * road changes have city1 < city2 and give the direction of the
+ * road before and after (the same for BudgetChanged)
+ */
+struct NetworkChange {
+    ChangeKind kind;
+    int before;
+    int after;
+    int city1;
+    int city2;
+    Budget oldBudget;
+    Budget newBudget;
+    RoadDirection oldDirection = RoadDirection::TwoWay;
+    RoadDirection newDirection = RoadDirection::TwoWay;
+};
+
+//====================================================================
+// FILE ROWS
+//====================================================================
+
+/**
+ * Write the header and the rows of cities.txt and roads.txt
+ * Columns are padded to line up and always followed by a space, so
+ * long names and large numbers never run together; every writer of
+ * the two files goes through these so readSnapshot can read them
+ */
+void writeCityHeader(std::ostream& out);
+void writeCityRow(std::ostream& out, int index, const std::string& name);
+void writeRoadHeader(std::ostream& out);
+void writeRoadRow(std::ostream& out, int number, const std::string& roadName, Budget budget);
+
+//====================================================================
+// SNAPSHOT FUNCTIONS
+//====================================================================
+
+/**
+ * Reads a snapshot from cities.txt and roads.txt in a directory
+ * Roads naming unknown cities are reported and skipped
+ * @return False if either file cannot be read
+ */
+bool readSnapshot(const std::string& directory, NetworkSnapshot& snapshot);
+
+/**
+ * Writes a snapshot to cities.txt and roads.txt in a directory,
+ * creating it if needed, in the same format as saveToFiles()
+ * @return False if a file cannot be written
+ */
+bool writeSnapshot(const NetworkSnapshot& snapshot, const std::string& directory);
+
+/**
+ * Lists what changed from an older to a newer snapshot
+ * City changes come first, then road changes ordered by endpoints
+ */
+std::vector<NetworkChange> diffSnapshots(const NetworkSnapshot& before, const NetworkSnapshot& after);
+
+/**
+ * Prints a change set with the city names of both snapshots
+ */
+void printChanges(const NetworkSnapshot& before, const NetworkSnapshot& after,
+                  const std::vector<NetworkChange>& changes, std::ostream& out);
+
+#endif // RWANDA_SNAPSHOT_H
@@ -0,0 +1,392 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - spatial index
+ *
+ * Implements the STR bulk load, the buffered logarithmic-method
+ * inserts and the best-first nearest-neighbor search.
+ *****************************************************************/
+
+#include "spatial_index.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+
+using namespace std;
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double KM_PER_DEGREE = 111.195;
+constexpr double REFERENCE_LATITUDE = -1.94;                // Centre of Rwanda
+const double KM_PER_DEGREE_EAST = KM_PER_DEGREE * cos(REFERENCE_LATITUDE * PI / 180.0);
+
+double projectX(double longitude) {
+    return longitude * KM_PER_DEGREE_EAST;
+}
+
+double projectY(double latitude) {
+    return latitude * KM_PER_DEGREE;
+}
+
+/**
+ * Squared distance from a point to the nearest point of a box
+ * (0 inside the box)
+ */
+template <typename BoxType>
+double boxDistance2(const BoxType& box, double x, double y) {
+    double dx = x < box.minX ? box.minX - x : (x > box.maxX ? x - box.maxX : 0.0);
+    double dy = y < box.minY ? box.minY - y : (y > box.maxY ? y - box.maxY : 0.0);
+    return dx * dx + dy * dy;
+}
+
+template <typename BoxType>
+bool boxesOverlap(const BoxType& a, const BoxType& b) {
+    return a.minX <= b.maxX && b.minX <= a.maxX && a.minY <= b.maxY && b.minY <= a.maxY;
+}
+
+/**
+ * Sort-Tile-Recursive order: sorts by x, cuts into vertical slices
+ * of whole nodes, and sorts each slice by y, so consecutive runs of
+ * NODE_CAPACITY items are compact tiles
+ */
+template <typename Item, typename CenterX, typename CenterY>
+void strSort(vector<Item>& items, CenterX centerX, CenterY centerY) {
+    size_t capacity = SpatialIndex::NODE_CAPACITY;
+    size_t nodeCount = (items.size() + capacity - 1) / capacity;
+    size_t sliceCount = static_cast<size_t>(ceil(sqrt(static_cast<double>(nodeCount))));
+    size_t sliceSize = sliceCount * capacity;
+
+    sort(items.begin(), items.end(), [&](const Item& a, const Item& b) {
+        return centerX(a) < centerX(b);
+    });
+    for (size_t start = 0; start < items.size(); start += sliceSize) {
+        auto end = items.begin() + min(start + sliceSize, items.size());
+        sort(items.begin() + start, end, [&](const Item& a, const Item& b) {
+            return centerY(a) < centerY(b);
+        });
+    }
+}
+
+} // namespace
+
+double distanceKm(GeoPoint a, GeoPoint b) {
+    double dx = projectX(a.longitude) - projectX(b.longitude);
+    double dy = projectY(a.latitude) - projectY(b.latitude);
+    return sqrt(dx * dx + dy * dy);
+}
+
+//====================================================================
+// SPATIAL INDEX
+//====================================================================
+
+SpatialIndex::SpatialIndex() : liveCount(0), staleCount(0) {}
+
+bool SpatialIndex::isLive(const Entry& entry) const {
+    return hasLocation(entry.city) && versions[entry.city] == entry.version;
+}
+
+SpatialIndex::Tree SpatialIndex::buildTree(vector<Entry> entries) const {
+    RWANDA_TRACE_SCOPE("build R-tree", "index");
+    Tree tree;
+    tree.entries = move(entries);
+    if (tree.entries.empty()) {
+        return tree;
+    }
+
+    // Leaves over runs of entries
+    strSort(tree.entries, [](const Entry& e) { return e.x; }, [](const Entry& e) { return e.y; });
+    vector<Node> level;
+    for (size_t first = 0; first < tree.entries.size(); first += NODE_CAPACITY) {
+        size_t last = min(first + NODE_CAPACITY, tree.entries.size());
+        Box box = {tree.entries[first].x, tree.entries[first].y, tree.entries[first].x, tree.entries[first].y};
+        for (size_t e = first + 1; e < last; ++e) {
+            box.minX = min(box.minX, tree.entries[e].x);
+            box.minY = min(box.minY, tree.entries[e].y);
+            box.maxX = max(box.maxX, tree.entries[e].x);
+            box.maxY = max(box.maxY, tree.entries[e].y);
+        }
+        level.push_back({box, static_cast<int>(first), static_cast<int>(last - first)});
+    }
+
+    // Each upper level packs the STR-ordered level below it
+    while (level.size() > 1) {
+        strSort(level, [](const Node& n) { return n.box.minX + n.box.maxX; },
+                       [](const Node& n) { return n.box.minY + n.box.maxY; });
+        vector<Node> parents;
+        for (size_t first = 0; first < level.size(); first += NODE_CAPACITY) {
+            size_t last = min(first + NODE_CAPACITY, level.size());
+            Box box = level[first].box;
+            for (size_t c = first + 1; c < last; ++c) {
+                box.minX = min(box.minX, level[c].box.minX);
+                box.minY = min(box.minY, level[c].box.minY);
+                box.maxX = max(box.maxX, level[c].box.maxX);
+                box.maxY = max(box.maxY, level[c].box.maxY);
+            }
+            parents.push_back({box, static_cast<int>(first), static_cast<int>(last - first)});
+        }
+        tree.levels.push_back(move(level));
+        level = move(parents);
+    }
+    tree.levels.push_back(move(level));
+    return tree;
+}
+
+void SpatialIndex::insert(const Entry& entry) {
+    buffer.push_back(entry);
+    if (buffer.size() < BUFFER_CAPACITY) {
+        return;
+    }
+
+    // Carry the full buffer up through the occupied trees, like a
+    // binary counter, and bulk-load the first free slot
+    vector<Entry> carry;
+    auto keepLive = [&](const vector<Entry>& entries) {
+        for (const Entry& old : entries) {
+            if (isLive(old)) {
+                carry.push_back(old);
+            } else {
+                --staleCount;
+            }
+        }
+    };
+    keepLive(buffer);
+    buffer.clear();
+    size_t k = 0;
+    for (; k < trees.size() && !trees[k].entries.empty(); ++k) {
+        keepLive(trees[k].entries);
+        trees[k] = Tree();
+    }
+    if (k == trees.size()) {
+        trees.emplace_back();
+    }
+    trees[k] = buildTree(move(carry));
+}
+
+void SpatialIndex::retire(int city) {
+    if (!hasLocation(city)) {
+        return;
+    }
+    located[city] = false;
+    ++versions[city];
+    --liveCount;
+    ++staleCount;
+    if (staleCount > liveCount && staleCount > BUFFER_CAPACITY) {
+        rebuild();
+    }
+}
+
+void SpatialIndex::rebuild() {
+    vector<Entry> live;
+    live.reserve(liveCount);
+    for (const Entry& entry : buffer) {
+        if (isLive(entry)) {
+            live.push_back(entry);
+        }
+    }
+    for (const Tree& tree : trees) {
+        for (const Entry& entry : tree.entries) {
+            if (isLive(entry)) {
+                live.push_back(entry);
+            }
+        }
+    }
+    buffer.clear();
+    trees.clear();
+    staleCount = 0;
+    if (live.empty()) {
+        return;
+    }
+
+    // One tree in the slot matching its size
+    size_t slot = 0;
+    while ((BUFFER_CAPACITY << (slot + 1)) <= live.size()) {
+        ++slot;
+    }
+    trees.resize(slot + 1);
+    trees[slot] = buildTree(move(live));
+}
+
+void SpatialIndex::resize(size_t cityCount) {
+    for (size_t city = cityCount; city < located.size(); ++city) {
+        retire(city);
+    }
+    points.resize(cityCount, {0.0, 0.0});
+    located.resize(cityCount, false);
+    if (versions.size() < cityCount) {
+        versions.resize(cityCount, 0);
+    }
+}
+
+bool SpatialIndex::setLocation(int city, GeoPoint point) {
+    if (city < 0 || !(point.latitude >= -90.0 && point.latitude <= 90.0) ||
+        !(point.longitude >= -180.0 && point.longitude <= 180.0)) {
+        return false;
+    }
+    if (city >= static_cast<int>(located.size())) {
+        resize(city + 1);
+    }
+    retire(city);
+    points[city] = point;
+    located[city] = true;
+    ++liveCount;
+    insert({projectX(point.longitude), projectY(point.latitude), city, versions[city]});
+    return true;
+}
+
+void SpatialIndex::clearLocation(int city) {
+    retire(city);
+}
+
+void SpatialIndex::clear() {
+    points.clear();
+    located.clear();
+    versions.clear();
+    buffer.clear();
+    trees.clear();
+    liveCount = 0;
+    staleCount = 0;
+}
+
+vector<SpatialIndex::Neighbor> SpatialIndex::nearest(GeoPoint point, size_t k) const {
+    vector<Neighbor> found;
+    if (k == 0 || liveCount == 0) {
+        return found;
+    }
+    double x = projectX(point.longitude);
+    double y = projectY(point.latitude);
+
+    // The k best entries so far, farthest on top; nodes no closer
+    // than the farthest of a full set cannot improve it
+    vector<pair<double, int>> best;
+    best.reserve(k + 1);
+    auto bound = [&]() {
+        return best.size() < k ? numeric_limits<double>::infinity() : best.front().first;
+    };
+    auto offer = [&](const Entry& entry) {
+        double dx = entry.x - x;
+        double dy = entry.y - y;
+        double distance2 = dx * dx + dy * dy;
+        if (distance2 >= bound() || !isLive(entry)) {
+            return;
+        }
+        if (best.size() == k) {
+            pop_heap(best.begin(), best.end());
+            best.pop_back();
+        }
+        best.push_back({distance2, entry.city});
+        push_heap(best.begin(), best.end());
+    };
+
+    struct Candidate {
+        double distance2;
+        int tree;
+        int level;
+        int index;
+        bool operator>(const Candidate& other) const {
+            return distance2 > other.distance2;
+        }
+    };
+    vector<Candidate> storage;
+    storage.reserve(4 * NODE_CAPACITY);
+    priority_queue<Candidate, vector<Candidate>, greater<Candidate>> queue(greater<Candidate>(), move(storage));
+
+    for (const Entry& entry : buffer) {
+        offer(entry);
+    }
+    for (size_t t = 0; t < trees.size(); ++t) {
+        if (!trees[t].levels.empty()) {
+            int root = trees[t].levels.size() - 1;
+            queue.push({boxDistance2(trees[t].levels[root][0].box, x, y), static_cast<int>(t), root, 0});
+        }
+    }
+
+    // Best-first over the nodes of every tree at once
+    while (!queue.empty() && queue.top().distance2 < bound()) {
+        Candidate next = queue.top();
+        queue.pop();
+        const Tree& tree = trees[next.tree];
+        const Node& node = tree.levels[next.level][next.index];
+        for (int c = node.first; c < node.first + node.count; ++c) {
+            if (next.level == 0) {
+                offer(tree.entries[c]);
+                continue;
+            }
+            double distance2 = boxDistance2(tree.levels[next.level - 1][c].box, x, y);
+            if (distance2 < bound()) {
+                queue.push({distance2, next.tree, next.level - 1, c});
+            }
+        }
+    }
+
+    sort_heap(best.begin(), best.end());
+    found.reserve(best.size());
+    for (const auto& [distance2, city] : best) {
+        found.push_back({city, sqrt(distance2)});
+    }
+    return found;
+}
+
+vector<int> SpatialIndex::within(const GeoBox& area) const {
+    vector<int> found;
+    Box box = {projectX(area.west), projectY(area.south), projectX(area.east), projectY(area.north)};
+    auto inside = [&](const Entry& entry) {
+        return entry.x >= box.minX && entry.x <= box.maxX && entry.y >= box.minY && entry.y <= box.maxY;
+    };
+
+    for (const Entry& entry : buffer) {
+        if (inside(entry) && isLive(entry)) {
+            found.push_back(entry.city);
+        }
+    }
+    for (const Tree& tree : trees) {
+        if (tree.levels.empty()) {
+            continue;
+        }
+        // Depth-first over the nodes overlapping the box
+        vector<pair<int, int>> stack = {{static_cast<int>(tree.levels.size()) - 1, 0}};
+        while (!stack.empty()) {
+            auto [level, index] = stack.back();
+            stack.pop_back();
+            const Node& node = tree.levels[level][index];
+            if (!boxesOverlap(node.box, box)) {
+                continue;
+            }
+            for (int c = node.first; c < node.first + node.count; ++c) {
+                if (level > 0) {
+                    stack.push_back({level - 1, c});
+                } else if (inside(tree.entries[c]) && isLive(tree.entries[c])) {
+                    found.push_back(tree.entries[c].city);
+                }
+            }
+        }
+    }
+    sort(found.begin(), found.end());
+    return found;
+}
+
+size_t SpatialIndex::usedBytes() const {
+    size_t bytes = points.size() * sizeof(GeoPoint) + located.size() / 8 +
+                   versions.size() * sizeof(uint32_t) + buffer.size() * sizeof(Entry);
+    for (const Tree& tree : trees) {
+        bytes += tree.entries.size() * sizeof(Entry);
+        for (const auto& level : tree.levels) {
+            bytes += level.size() * sizeof(Node);
+        }
+    }
+    return bytes;
+}
+
+size_t SpatialIndex::capacityBytes() const {
+    size_t bytes = points.capacity() * sizeof(GeoPoint) + located.capacity() / 8 +
+                   versions.capacity() * sizeof(uint32_t) + buffer.capacity() * sizeof(Entry) +
+                   trees.capacity() * sizeof(Tree);
+    for (const Tree& tree : trees) {
+        bytes += tree.entries.capacity() * sizeof(Entry) + tree.levels.capacity() * sizeof(vector<Node>);
+        for (const auto& level : tree.levels) {
+            bytes += level.capacity() * sizeof(Node);
+        }
+    }
+    return bytes;
+}
@@ -0,0 +1,164 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - spatial index
+ *
+ * City coordinates and an index over them for nearest-city and
+ * bounding-box queries. Points are projected to kilometres with an
+ * equirectangular projection centred on Rwanda, which is accurate
+ * to well under 1% within the country.
+ *
+ * The index follows the logarithmic method: new points go to a
+ * small buffer, and a full buffer is merged with the existing
+ * trees into a packed R-tree bulk-loaded with Sort-Tile-Recursive
+ * (STR). Tree k holds about BUFFER_CAPACITY * 2^k points, so an
+ * insert costs O(log n) amortized and a query visits O(log n)
+ * trees of logarithmic height. Moved or removed points leave stale
+ * entries behind that queries skip; once they outnumber the live
+ * points everything is rebuilt into one tree.
+ *****************************************************************/
+
+#ifndef RWANDA_SPATIAL_INDEX_H
+#define RWANDA_SPATIAL_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//====================================================================
+// STRUCTURES
+//====================================================================
+
+/**
+ * A position in decimal degrees (south and west are negative)
+ */
+struct GeoPoint {
+    double latitude;
+    double longitude;
+};
+
+/**
+ * A latitude/longitude rectangle, edges included
+ */
+struct GeoBox {
+    double south;
+    double west;
+    double north;
+    double east;
+};
+
+//====================================================================
+// SPATIAL INDEX
+//====================================================================
+
+class SpatialIndex {
+public:
+    static constexpr int NODE_CAPACITY = 16;                // Children per R-tree node
+    static constexpr size_t BUFFER_CAPACITY = 64;           // Points inserted before a merge
+
+    /**
+     * A city found by nearest(), with its distance from the query point
+     */
+    struct Neighbor {
+        int city;
+        double distanceKm;
+    };
+
+private:
+    struct Entry {
+        double x;                                           // Projected km east
+        double y;                                           // Projected km north
+        int city;
+        uint32_t version;                                   // Stale once versions[city] moves on
+    };
+
+    struct Box {
+        double minX;
+        double minY;
+        double maxX;
+        double maxY;
+    };
+
+    struct Node {
+        Box box;
+        int first;                                          // First child in the level below
+        int count;
+    };
+
+    struct Tree {
+        std::vector<Entry> entries;                         // Leaf order
+        std::vector<std::vector<Node>> levels;              // levels[0] = leaves, back() = root
+    };
+
+    std::vector<GeoPoint> points;                           // Location of each city slot
+    std::vector<bool> located;
+    std::vector<uint32_t> versions;                         // Never shrinks
+    std::vector<Entry> buffer;
+    std::vector<Tree> trees;                                // trees[k] empty or ~BUFFER_CAPACITY << k entries
+    size_t liveCount;
+    size_t staleCount;
+
+    bool isLive(const Entry& entry) const;
+    Tree buildTree(std::vector<Entry> entries) const;
+    void insert(const Entry& entry);
+    void retire(int city);
+    void rebuild();
+
+public:
+    SpatialIndex();
+
+    /**
+     * Adds city slots without a location up to the given count, or
+     * drops the slots from the given count on
+     */
+    void resize(size_t cityCount);
+
+    /**
+     * Sets or moves a city's location, adding slots as needed
+     * @return False if the latitude or longitude is out of range
+     */
+    bool setLocation(int city, GeoPoint point);
+
+    /**
+     * Forgets a city's location
+     */
+    void clearLocation(int city);
+
+    /**
+     * Forgets every city and location
+     */
+    void clear();
+
+    bool hasLocation(int city) const {
+        return city >= 0 && city < static_cast<int>(located.size()) && located[city];
+    }
+
+    GeoPoint location(int city) const {
+        return points[city];
+    }
+
+    size_t locatedCount() const {
+        return liveCount;
+    }
+
+    /**
+     * The k located cities closest to a point, nearest first
+     * Searches best-first, so only nodes closer than the k-th
+     * result found so far are opened
+     */
+    std::vector<Neighbor> nearest(GeoPoint point, size_t k) const;
+
+    /**
+     * Located cities inside a rectangle, in slot order
+     */
+    std::vector<int> within(const GeoBox& box) const;
+
+    size_t usedBytes() const;
+    size_t capacityBytes() const;
+};
+
+/**
+ * Straight-line distance in km between two points under the index's
+ * projection
+ */
+double distanceKm(GeoPoint a, GeoPoint b);
+
+#endif // RWANDA_SPATIAL_INDEX_H
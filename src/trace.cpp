@@ -0,0 +1,157 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - timeline tracing
+ *
+ * Implements the per-thread span ring buffers and the Chrome
+ * trace JSON export.
+ *****************************************************************/
+
+#include "trace.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+atomic<bool> traceRecording{false};
+
+//====================================================================
+// RING BUFFERS
+//====================================================================
+
+namespace {
+
+constexpr uint64_t RING_CAPACITY = 1 << 14;
+
+/**
+ * Spans of one thread
+ * Only the owning thread writes; it fills a slot and then publishes
+ * it by advancing written, so readers never wait on the writer
+ */
+struct TraceBuffer {
+    vector<TraceEvent> events = vector<TraceEvent>(RING_CAPACITY);
+    atomic<uint64_t> written{0};
+    uint32_t threadId = 0;
+};
+
+/**
+ * All buffers ever created, so spans survive their thread
+ * The lock is only taken when a thread records its first span
+ * and when exporting
+ */
+struct TraceRegistry {
+    mutex lock;
+    vector<unique_ptr<TraceBuffer>> buffers;
+    atomic<uint64_t> windowStart{0};
+    atomic<uint64_t> windowEnd{0};
+};
+
+TraceRegistry& traceRegistry() {
+    static TraceRegistry* registry = new TraceRegistry();
+    return *registry;
+}
+
+TraceBuffer& threadBuffer() {
+    thread_local TraceBuffer* buffer = nullptr;
+    if (buffer == nullptr) {
+        TraceRegistry& registry = traceRegistry();
+        lock_guard<mutex> guard(registry.lock);
+        registry.buffers.push_back(make_unique<TraceBuffer>());
+        buffer = registry.buffers.back().get();
+        buffer->threadId = registry.buffers.size();
+    }
+    return *buffer;
+}
+
+/**
+ * Escapes a span name for a JSON string
+ */
+string jsonEscape(const char* text) {
+    string escaped;
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            escaped += '\\';
+        }
+        escaped += *c;
+    }
+    return escaped;
+}
+
+} // namespace
+
+//====================================================================
+// TRACE FUNCTIONS
+//====================================================================
+
+bool tracingAvailable() {
+#ifdef RWANDA_ENABLE_TRACING
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint64_t traceNow() {
+    static const auto epoch = chrono::steady_clock::now();
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - epoch).count() + 1;
+}
+
+void startTracing() {
+    // Older spans stay in the rings but fall outside the window
+    TraceRegistry& registry = traceRegistry();
+    registry.windowStart.store(traceNow(), memory_order_relaxed);
+    registry.windowEnd.store(UINT64_MAX, memory_order_relaxed);
+    traceRecording.store(true, memory_order_release);
+}
+
+void stopTracing() {
+    traceRecording.store(false, memory_order_release);
+    traceRegistry().windowEnd.store(traceNow(), memory_order_relaxed);
+}
+
+void recordTraceEvent(const TraceEvent& event) {
+    TraceBuffer& buffer = threadBuffer();
+    uint64_t slot = buffer.written.load(memory_order_relaxed);
+    buffer.events[slot % RING_CAPACITY] = event;
+    buffer.written.store(slot + 1, memory_order_release);
+}
+
+bool writeChromeTrace(const string& path) {
+    ofstream file(path);
+    if (!file.is_open()) {
+        cerr << "Error: Could not open " << path << " for writing!" << endl;
+        return false;
+    }
+
+    TraceRegistry& registry = traceRegistry();
+    uint64_t windowStart = registry.windowStart.load(memory_order_relaxed);
+    uint64_t windowEnd = registry.windowEnd.load(memory_order_relaxed);
+
+    file << fixed << setprecision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"rwanda\"}}";
+
+    lock_guard<mutex> guard(registry.lock);
+    for (const auto& buffer : registry.buffers) {
+        uint64_t written = buffer->written.load(memory_order_acquire);
+        uint64_t first = written > RING_CAPACITY ? written - RING_CAPACITY : 0;
+        for (uint64_t slot = first; slot < written; ++slot) {
+            const TraceEvent& event = buffer->events[slot % RING_CAPACITY];
+            if (event.startNs < windowStart || event.startNs > windowEnd) {
+                continue;
+            }
+            // Chrome trace timestamps are in microseconds
+            file << ",\n{\"name\":\"" << jsonEscape(event.name)
+                 << "\",\"cat\":\"" << jsonEscape(event.category)
+                 << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId
+                 << ",\"ts\":" << (event.startNs - windowStart) / 1000.0
+                 << ",\"dur\":" << event.durationNs / 1000.0 << "}";
+        }
+    }
+    file << "\n]}\n";
+    return file.good();
+}
@@ -0,0 +1,118 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - timeline tracing
+ *
+ * Records scoped spans around the long operations (loading,
+ * imports, saving, matrix growth, analytics) and exports them as
+ * a Chrome trace JSON file, which can be opened in Perfetto
+ * (ui.perfetto.dev) or chrome://tracing.
+ *
+ * Every thread writes its spans to its own fixed-size ring buffer
+ * without locks; the oldest spans are overwritten when it is
+ * full. Spans are only recorded between startTracing() and
+ * stopTracing(), and the whole facility is compiled in only when
+ * RWANDA_ENABLE_TRACING is defined (CMake option of the same name).
+ *****************************************************************/
+
+#ifndef RWANDA_TRACE_H
+#define RWANDA_TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+//====================================================================
+// STRUCTURES
+//====================================================================
+
+/**
+ * One completed span
+ * name and category must be string literals, they are not copied
+ */
+struct TraceEvent {
+    const char* name;
+    const char* category;
+    uint64_t startNs;
+    uint64_t durationNs;
+};
+
+//====================================================================
+// TRACE FUNCTIONS
+//====================================================================
+
+/**
+ * Whether tracing was compiled in
+ */
+bool tracingAvailable();
+
+/**
+ * Starts recording spans, discarding any previous recording
+ */
+void startTracing();
+
+/**
+ * Stops recording spans; recorded spans are kept for export
+ */
+void stopTracing();
+
+// Set while spans are being recorded; read on every span
+extern std::atomic<bool> traceRecording;
+
+/**
+ * Whether spans are currently being recorded
+ */
+inline bool tracingActive() {
+    return traceRecording.load(std::memory_order_relaxed);
+}
+
+/**
+ * Nanoseconds since the trace clock started (never zero)
+ */
+uint64_t traceNow();
+
+/**
+ * Appends a completed span to the calling thread's ring buffer
+ */
+void recordTraceEvent(const TraceEvent& event);
+
+/**
+ * Writes every recorded span as Chrome trace JSON
+ * Call after stopTracing() so no thread is still writing
+ * @param path Destination file
+ * @return False if the file could not be written
+ */
+bool writeChromeTrace(const std::string& path);
+
+/**
+ * Records the enclosing scope as a span when tracing is active
+ */
+class TraceScope {
+private:
+    const char* name;
+    const char* category;
+    uint64_t started;
+
+public:
+    TraceScope(const char* spanName, const char* spanCategory)
+        : name(spanName), category(spanCategory), started(tracingActive() ? traceNow() : 0) {}
+
+    ~TraceScope() {
+        if (started != 0 && tracingActive()) {
+            recordTraceEvent({name, category, started, traceNow() - started});
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
+
+#define RWANDA_TRACE_CONCAT_INNER(a, b) a##b
+#define RWANDA_TRACE_CONCAT(a, b) RWANDA_TRACE_CONCAT_INNER(a, b)
+
+#ifdef RWANDA_ENABLE_TRACING
+#define RWANDA_TRACE_SCOPE(name, category) \
+    TraceScope RWANDA_TRACE_CONCAT(traceScope_, __LINE__)(name, category)
+#else
+#define RWANDA_TRACE_SCOPE(name, category) ((void)0)
+#endif
+
+#endif // RWANDA_TRACE_H
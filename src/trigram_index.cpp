@@ -0,0 +1,183 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - fuzzy name search
+ *
+ * Implements the trigram postings and the ranked search over them.
+ *****************************************************************/
+
+#include "trigram_index.h"
+#include "name_key.h"
+#include "trace.h"
+
+#include <algorithm>
+
+using namespace std;
+
+//====================================================================
+// NAME HELPERS
+//====================================================================
+
+int editDistance(const string& a, const string& b) {
+    // One row of the dynamic programming table at a time
+    vector<int> row(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); ++j) {
+        row[j] = j;
+    }
+    for (size_t i = 1; i <= a.size(); ++i) {
+        int diagonal = row[0];
+        row[0] = i;
+        for (size_t j = 1; j <= b.size(); ++j) {
+            int above = row[j];
+            row[j] = min({row[j] + 1, row[j - 1] + 1, diagonal + (a[i - 1] == b[j - 1] ? 0 : 1)});
+            diagonal = above;
+        }
+    }
+    return row[b.size()];
+}
+
+//====================================================================
+// TRIGRAM INDEX
+//====================================================================
+
+vector<uint32_t> TrigramIndex::trigramsOf(const string& foldedName) {
+    string padded = "  " + foldedName + " ";
+    vector<uint32_t> grams;
+    grams.reserve(padded.size() - 2);
+    for (size_t i = 0; i + 3 <= padded.size(); ++i) {
+        grams.push_back(static_cast<uint32_t>(static_cast<unsigned char>(padded[i])) << 16 |
+                        static_cast<uint32_t>(static_cast<unsigned char>(padded[i + 1])) << 8 |
+                        static_cast<uint32_t>(static_cast<unsigned char>(padded[i + 2])));
+    }
+    sort(grams.begin(), grams.end());
+    grams.erase(unique(grams.begin(), grams.end()), grams.end());
+    return grams;
+}
+
+void TrigramIndex::add(int city, const string& name) {
+    remove(city);
+    if (city >= static_cast<int>(folded.size())) {
+        folded.resize(city + 1);
+        gramCounts.resize(city + 1, 0);
+    }
+
+    folded[city] = normalizeName(name);
+    vector<uint32_t> grams = trigramsOf(folded[city]);
+    gramCounts[city] = min<size_t>(grams.size(), UINT16_MAX);
+    for (uint32_t gram : grams) {
+        vector<int>& list = postings[gram];
+        list.insert(lower_bound(list.begin(), list.end(), city), city);
+    }
+}
+
+void TrigramIndex::remove(int city) {
+    if (city < 0 || city >= static_cast<int>(folded.size()) || gramCounts[city] == 0) {
+        return;
+    }
+    for (uint32_t gram : trigramsOf(folded[city])) {
+        auto found = postings.find(gram);
+        vector<int>& list = found->second;
+        list.erase(lower_bound(list.begin(), list.end(), city));
+        if (list.empty()) {
+            postings.erase(found);
+        }
+    }
+    folded[city].clear();
+    gramCounts[city] = 0;
+
+    // Drop trailing empty slots so removing the newest city shrinks
+    while (!gramCounts.empty() && gramCounts.back() == 0) {
+        gramCounts.pop_back();
+        folded.pop_back();
+    }
+}
+
+void TrigramIndex::clear() {
+    postings.clear();
+    folded.clear();
+    gramCounts.clear();
+    shared.clear();
+    touched.clear();
+}
+
+vector<NameMatch> TrigramIndex::search(const string& query, size_t limit, double threshold) const {
+    RWANDA_TRACE_SCOPE("trigram search", "lookup");
+    vector<NameMatch> matches;
+    string foldedQuery = normalizeName(query);
+    vector<uint32_t> grams = trigramsOf(foldedQuery);
+    if (limit == 0 || folded.empty()) {
+        return matches;
+    }
+
+    // Count the trigrams each city shares with the query
+    if (shared.size() < folded.size()) {
+        shared.resize(folded.size(), 0);
+    }
+    touched.clear();
+    for (uint32_t gram : grams) {
+        auto found = postings.find(gram);
+        if (found == postings.end()) {
+            continue;
+        }
+        for (int city : found->second) {
+            if (shared[city]++ == 0) {
+                touched.push_back(city);
+            }
+        }
+    }
+
+    for (int city : touched) {
+        double similarity = static_cast<double>(shared[city]) / (grams.size() + gramCounts[city] - shared[city]);
+        if (similarity >= threshold) {
+            matches.push_back({city, similarity, editDistance(foldedQuery, folded[city])});
+        }
+        shared[city] = 0;
+    }
+
+    auto better = [](const NameMatch& a, const NameMatch& b) {
+        if (a.similarity != b.similarity) {
+            return a.similarity > b.similarity;
+        }
+        if (a.editDistance != b.editDistance) {
+            return a.editDistance < b.editDistance;
+        }
+        return a.city < b.city;
+    };
+    if (matches.size() > limit) {
+        partial_sort(matches.begin(), matches.begin() + limit, matches.end(), better);
+        matches.resize(limit);
+    } else {
+        sort(matches.begin(), matches.end(), better);
+    }
+    return matches;
+}
+
+size_t TrigramIndex::usedBytes() const {
+    size_t bytes = postings.size() * (sizeof(uint32_t) + sizeof(vector<int>)) +
+                   folded.size() * sizeof(string) + gramCounts.size() * sizeof(uint16_t);
+    size_t inlineCapacity = string().capacity();
+    for (const auto& [gram, list] : postings) {
+        bytes += list.size() * sizeof(int);
+    }
+    for (const string& name : folded) {
+        if (name.capacity() > inlineCapacity) {
+            bytes += name.size() + 1;
+        }
+    }
+    return bytes;
+}
+
+size_t TrigramIndex::capacityBytes() const {
+    size_t bytes = postings.bucket_count() * sizeof(void*) +
+                   postings.size() * (sizeof(uint32_t) + sizeof(vector<int>) + sizeof(void*)) +
+                   folded.capacity() * sizeof(string) + gramCounts.capacity() * sizeof(uint16_t) +
+                   shared.capacity() * sizeof(uint16_t) + touched.capacity() * sizeof(int);
+    size_t inlineCapacity = string().capacity();
+    for (const auto& [gram, list] : postings) {
+        bytes += list.capacity() * sizeof(int);
+    }
+    for (const string& name : folded) {
+        if (name.capacity() > inlineCapacity) {
+            bytes += name.capacity() + 1;
+        }
+    }
+    return bytes;
+}
@@ -0,0 +1,91 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - fuzzy name search
+ *
+ * An inverted index from the trigrams (three-letter pieces) of the
+ * normalized city names to the cities containing them. A query is
+ * split into trigrams the same way; the cities sharing the most
+ * trigrams relative to both names' sizes (the Jaccard similarity)
+ * are the likely matches, ranked by similarity and then by edit
+ * distance. Names are padded with two leading blanks and one
+ * trailing blank, so the first letters weigh more and one-letter
+ * typos still share most trigrams: "Nyagatre" and "Nyagatare"
+ * share 7 of 12 distinct trigrams.
+ *****************************************************************/
+
+#ifndef RWANDA_TRIGRAM_INDEX_H
+#define RWANDA_TRIGRAM_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//====================================================================
+// STRUCTURES
+//====================================================================
+
+/**
+ * A city whose name resembles the query
+ */
+struct NameMatch {
+    int city;                   // Slot of the city
+    double similarity;          // Jaccard similarity of the trigram sets, 0 to 1
+    int editDistance;           // Levenshtein distance of the normalized names
+};
+
+//====================================================================
+// TRIGRAM INDEX
+//====================================================================
+
+class TrigramIndex {
+private:
+    std::unordered_map<uint32_t, std::vector<int>> postings;   // Trigram -> sorted city slots
+    std::vector<std::string> folded;                        // Normalized name by slot, empty if not indexed
+    std::vector<uint16_t> gramCounts;                       // Distinct trigrams by slot
+
+    // Search scratch, kept between searches so a search allocates
+    // only its results; shared is all zeros between searches, so one
+    // index must not be searched from two threads at once
+    mutable std::vector<uint16_t> shared;                   // Trigrams shared with the query by slot
+    mutable std::vector<int> touched;                       // Slots sharing any trigram
+
+    static std::vector<uint32_t> trigramsOf(const std::string& foldedName);
+
+public:
+    static constexpr double DEFAULT_THRESHOLD = 0.3;
+
+    /**
+     * Indexes a city's name, replacing any name it had
+     */
+    void add(int city, const std::string& name);
+
+    /**
+     * Removes a city's name from the index
+     */
+    void remove(int city);
+
+    /**
+     * Forgets every name
+     */
+    void clear();
+
+    /**
+     * Cities whose names resemble the query, best first
+     * @param limit Most matches to return
+     * @param threshold Least Jaccard similarity to count as a match
+     */
+    std::vector<NameMatch> search(const std::string& query, size_t limit,
+                                  double threshold = DEFAULT_THRESHOLD) const;
+
+    size_t usedBytes() const;
+    size_t capacityBytes() const;
+};
+
+/**
+ * Levenshtein distance: the fewest single-character insertions,
+ * deletions and substitutions that turn one string into the other
+ */
+int editDistance(const std::string& a, const std::string& b);
+
+#endif // RWANDA_TRIGRAM_INDEX_H
@@ -0,0 +1,73 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - budget amount tests
+ *
+ * Exact conversion of budgets between text and thousands of RWF.
+ *****************************************************************/
+
+#include "test_harness.h"
+#include "budget.h"
+
+#include <limits>
+#include <string>
+
+using namespace std;
+
+TEST(ParseBudgetReadsBillions) {
+    Budget budget = -1;
+    CHECK(parseBudget("28.6", budget));
+    CHECK_EQ(budget, 28600000);
+    CHECK(parseBudget("117", budget));
+    CHECK_EQ(budget, 117000000);
+    CHECK(parseBudget(" 0.000001 ", budget));
+    CHECK_EQ(budget, 1);
+    CHECK(parseBudget(".5", budget));
+    CHECK_EQ(budget, 500000);
+    CHECK(parseBudget("12.", budget));
+    CHECK_EQ(budget, 12000000);
+}
+
+TEST(ParseBudgetRejectsMalformedText) {
+    Budget budget = 42;
+    CHECK(!parseBudget("", budget));
+    CHECK(!parseBudget("   ", budget));
+    CHECK(!parseBudget(".", budget));
+    CHECK(!parseBudget("-1", budget));
+    CHECK(!parseBudget("1.2.3", budget));
+    CHECK(!parseBudget("12abc", budget));
+    CHECK(!parseBudget("1.0000001", budget));
+    CHECK(!parseBudget("99999999999999999999", budget));
+    CHECK_EQ(budget, 42);
+}
+
+TEST(ParseBudgetStopsAtTheLargestBudget) {
+    Budget budget = 0;
+    Budget largest = numeric_limits<Budget>::max();
+    string text = to_string(largest / BUDGET_PER_BILLION) + "." + to_string(largest % BUDGET_PER_BILLION);
+    CHECK(parseBudget(text, budget));
+    CHECK_EQ(budget, largest);
+    CHECK(!parseBudget(to_string(largest / BUDGET_PER_BILLION + 1), budget));
+}
+
+TEST(FormatBudgetKeepsSignificantDecimals) {
+    CHECK_EQ(formatBudget(28600000), "28.6");
+    CHECK_EQ(formatBudget(70840000), "70.84");
+    CHECK_EQ(formatBudget(0), "0.0");
+    CHECK_EQ(formatBudget(1), "0.000001");
+    CHECK_EQ(formatBudget(-2500000), "-2.5");
+    CHECK_EQ(formatBudget(numeric_limits<Budget>::min()), "-9223372036854.775808");
+}
+
+TEST(FormatBudgetRoundTripsThroughParse) {
+    for (Budget budget : {Budget(0), Budget(1), Budget(999999), Budget(1000000), Budget(123456789012)}) {
+        Budget parsed = -1;
+        CHECK(parseBudget(formatBudget(budget), parsed));
+        CHECK_EQ(parsed, budget);
+    }
+}
+
+TEST(BudgetFromBillionsRounds) {
+    static_assert(budgetFromBillions(28.6) == 28600000, "seed tables are converted at compile time");
+    CHECK_EQ(budgetFromBillions(0.0000004), 0);
+    CHECK_EQ(budgetFromBillions(0.0000005), 1);
+    CHECK_EQ(budgetFromBillions(-1.5), -1500000);
+}
@@ -0,0 +1,89 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - budget history tests
+ *
+ * Yearly budgets round-trip exactly through the delta columns at
+ * every width, and the running-sum kernels agree with plain sums.
+ *****************************************************************/
+
+#include "test_harness.h"
+#include "budget_history.h"
+
+#include <vector>
+
+using namespace std;
+
+TEST(BudgetHistoryKeepsExactBudgets) {
+    BudgetTimeSeries history;
+    CHECK(history.setBudget(0, 2020, budgetFromBillions(28.6)));
+    CHECK(history.setBudget(0, 2021, budgetFromBillions(28.600001)));
+    CHECK(history.setBudget(1, 2021, 1));
+    CHECK_EQ(history.budget(0, 2020), 28600000);
+    CHECK_EQ(history.budget(0, 2021), 28600001);
+    CHECK_EQ(history.budget(1, 2020), 0);
+    CHECK_EQ(history.budget(1, 2021), 1);
+    CHECK_EQ(history.yearOverYear(2021)[0], 1);
+    CHECK_EQ(history.yearOverYear(2021)[1], 1);
+}
+
+TEST(BudgetHistoryRejectsBadYearsAndNegativeBudgets) {
+    BudgetTimeSeries history;
+    CHECK(!history.setBudget(0, BudgetTimeSeries::MIN_YEAR - 1, 10));
+    CHECK(!history.setBudget(0, BudgetTimeSeries::MAX_YEAR + 1, 10));
+    CHECK(!history.setBudget(0, 2020, -1));
+    CHECK_EQ(history.yearCount(), 0);
+}
+
+TEST(BudgetHistoryHoldsBudgetsBeyond32Bits) {
+    // 5000 billion RWF is 5e9 thousands, past what an int32_t holds
+    const Budget large = budgetFromBillions(5000);
+    BudgetTimeSeries history;
+    CHECK(history.setBudget(2, 2000, large));
+    CHECK(history.setBudget(2, 2001, 7));
+    CHECK(history.setBudget(0, 2001, large + 3));
+    CHECK_EQ(history.budget(2, 2000), large);
+    CHECK_EQ(history.budget(2, 2001), 7);
+    CHECK_EQ(history.budget(0, 2001), large + 3);
+    CHECK_EQ(history.yearOverYear(2001)[2], 7 - large);
+    CHECK_EQ(history.yearOverYear(2002)[0], -(large + 3));
+
+    vector<Budget> totals = history.yearTotals();
+    REQUIRE(totals.size() == 2);
+    CHECK_EQ(totals[0], large);
+    CHECK_EQ(totals[1], large + 10);
+}
+
+TEST(BudgetHistoryKernelsMatchPlainSums) {
+    // Enough roads for the vector loops and their scalar tails, with
+    // changes of every width
+    const size_t roadCount = 37;
+    const Budget steps[] = {3, 300, 300000, budgetFromBillions(9000)};
+    BudgetTimeSeries history;
+    vector<vector<Budget>> expected;
+    for (int year = 2010; year < 2014; ++year) {
+        vector<Budget> budgets(roadCount);
+        for (size_t road = 0; road < roadCount; ++road) {
+            budgets[road] = steps[(road + year) % 4] * static_cast<Budget>(road % 5 + 1);
+            CHECK(history.setBudget(road, year, budgets[road]));
+        }
+        expected.push_back(budgets);
+    }
+
+    vector<Budget> cumulative(roadCount, 0);
+    vector<Budget> totals = history.yearTotals();
+    REQUIRE(totals.size() == expected.size());
+    for (size_t y = 0; y < expected.size(); ++y) {
+        int year = 2010 + static_cast<int>(y);
+        vector<Budget> budgets = history.yearBudgets(year);
+        vector<Budget> changes = history.yearOverYear(year);
+        vector<Budget> sums = history.cumulativeBudgets(year);
+        Budget total = 0;
+        for (size_t road = 0; road < roadCount; ++road) {
+            cumulative[road] += expected[y][road];
+            total += expected[y][road];
+            CHECK_EQ(budgets[road], expected[y][road]);
+            CHECK_EQ(changes[road], expected[y][road] - (y > 0 ? expected[y - 1][road] : 0));
+            CHECK_EQ(sums[road], cumulative[road]);
+        }
+        CHECK_EQ(totals[y], total);
+    }
+}
@@ -0,0 +1,130 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - budget kernel tests
+ *
+ * Every kernel level the processor supports against plain loops,
+ * over lengths that leave vector tails, empty runs, thresholds and
+ * budgets near the int64 range.
+ *****************************************************************/
+
+#include "test_harness.h"
+#include "budget_kernels.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Runs check at every supported kernel level, then restores the
+ * widest one
+ */
+template <typename Check>
+static void atEveryLevel(Check check) {
+    for (BudgetKernelLevel level : {BudgetKernelLevel::Baseline, BudgetKernelLevel::Avx2,
+                                    BudgetKernelLevel::Avx512}) {
+        if (setBudgetKernelLevel(level) == level) {
+            check();
+        }
+    }
+    setBudgetKernelLevel(bestBudgetKernelLevel());
+}
+
+/**
+ * Checks every kernel on one run of budgets against plain loops
+ */
+static void checkKernels(const vector<Budget>& values, Budget threshold) {
+    Budget total = 0;
+    Budget largest = values.empty() ? 0 : values[0];
+    size_t funded = 0;
+    size_t atLeast = 0;
+    for (Budget value : values) {
+        total += value;
+        largest = max(largest, value);
+        funded += value != 0;
+        atLeast += value >= threshold;
+    }
+
+    atEveryLevel([&] {
+        CHECK_EQ(sumBudgets(values.data(), values.size()), total);
+        CHECK_EQ(maxBudget(values.data(), values.size()), largest);
+        CHECK_EQ(countFunded(values.data(), values.size()), funded);
+        CHECK_EQ(countAtLeast(values.data(), values.size(), threshold), atLeast);
+        BudgetSummary summary = summarizeBudgets(values.data(), values.size(), threshold);
+        CHECK_EQ(summary.total, total);
+        CHECK_EQ(summary.max, largest);
+        CHECK_EQ(summary.funded, funded);
+        CHECK_EQ(summary.atLeast, atLeast);
+    });
+}
+
+TEST(KernelsMatchPlainLoopsOnEveryTailLength) {
+    mt19937 random(7);
+    uniform_int_distribution<int> unfunded(0, 2);
+    uniform_int_distribution<Budget> amount(1, 5000000);
+    // 70 covers every remainder of the widest unrolled loop (32)
+    for (size_t length = 0; length <= 70; ++length) {
+        vector<Budget> values(length);
+        for (Budget& value : values) {
+            value = unfunded(random) == 0 ? 0 : amount(random);
+        }
+        for (Budget threshold : {Budget(1), Budget(2500000), Budget(5000001)}) {
+            checkKernels(values, threshold);
+        }
+    }
+}
+
+TEST(KernelsHandleEmptyRuns) {
+    atEveryLevel([] {
+        BudgetSummary summary = summarizeBudgets(nullptr, 0, 1);
+        CHECK_EQ(summary.total, 0);
+        CHECK_EQ(summary.max, 0);
+        CHECK_EQ(summary.funded, 0u);
+        CHECK_EQ(summary.atLeast, 0u);
+        CHECK_EQ(sumBudgets(nullptr, 0), 0);
+        CHECK_EQ(maxBudget(nullptr, 0), 0);
+        CHECK_EQ(countFunded(nullptr, 0), 0u);
+        CHECK_EQ(countAtLeast(nullptr, 0, 0), 0u);
+    });
+}
+
+TEST(KernelsCountThresholdsInclusively) {
+    vector<Budget> values;
+    for (Budget value = 0; value < 40; ++value) {
+        values.push_back(value);
+    }
+    for (Budget threshold : {Budget(0), Budget(1), Budget(20), Budget(39), Budget(40)}) {
+        checkKernels(values, threshold);
+    }
+    atEveryLevel([&] {
+        CHECK_EQ(countAtLeast(values.data(), values.size(), 20), 20u);
+        CHECK_EQ(countAtLeast(values.data(), values.size(), 40), 0u);
+    });
+}
+
+TEST(KernelsKeepBudgetsNearTheInt64Range) {
+    const Budget top = numeric_limits<Budget>::max();
+    for (size_t length : {1, 3, 8, 17, 33, 64}) {
+        // The total of the run still fits
+        Budget share = top / static_cast<Budget>(length);
+        vector<Budget> values(length, share);
+        values[length / 2] = share - 1;
+        checkKernels(values, share);
+        checkKernels(values, top);
+    }
+}
+
+TEST(KernelsReduceNegativeRuns) {
+    for (size_t length : {1, 5, 16, 37}) {
+        vector<Budget> values(length);
+        for (size_t i = 0; i < length; ++i) {
+            values[i] = -1000 - static_cast<Budget>(i * 7 % 11);
+        }
+        checkKernels(values, -1005);
+        atEveryLevel([&] {
+            CHECK(maxBudget(values.data(), values.size()) < 0);
+        });
+    }
+}
@@ -0,0 +1,201 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - city ordering tests
+ *
+ * The reverse Cuthill-McKee order as a permutation of the slots,
+ * storage reordering that leaves every query unchanged, and the
+ * bandwidth of the order on banded and grid networks.
+ *****************************************************************/
+
+#include "test_harness.h"
+#include "city_order.h"
+#include "generator.h"
+#include "graph_engine.h"
+
+#include <algorithm>
+#include <numeric>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Distinct neighbors of every slot as compressed sparse rows
+ */
+static void neighborArrays(int cityCount, const vector<Road>& roads, vector<int>& offsets, vector<int>& neighbors) {
+    vector<set<int>> adjacent(cityCount);
+    for (const Road& road : roads) {
+        adjacent[road.city1 - 1].insert(road.city2 - 1);
+        adjacent[road.city2 - 1].insert(road.city1 - 1);
+    }
+    offsets.assign(1, 0);
+    neighbors.clear();
+    for (const set<int>& row : adjacent) {
+        neighbors.insert(neighbors.end(), row.begin(), row.end());
+        offsets.push_back(static_cast<int>(neighbors.size()));
+    }
+}
+
+/**
+ * Row of each slot under an order, the inverse of the permutation
+ */
+static vector<int> rowsOf(const vector<int>& order) {
+    vector<int> rows(order.size());
+    for (size_t r = 0; r < order.size(); ++r) {
+        rows[order[r]] = static_cast<int>(r);
+    }
+    return rows;
+}
+
+/**
+ * Road i joins city i to the next width cities, in insertion order
+ */
+static GeneratedNetwork bandedNetwork(int cityCount, int width) {
+    GeneratedNetwork network;
+    for (int i = 1; i <= cityCount; ++i) {
+        network.cityNames.push_back("City " + to_string(i));
+        for (int j = i + 1; j <= min(cityCount, i + width); ++j) {
+            network.roads.push_back({i, j, static_cast<Budget>(1000 * i + j)});
+        }
+    }
+    return network;
+}
+
+static GeneratedNetwork gridNetwork(int cityCount) {
+    GeneratorOptions options;
+    options.model = GraphModel::Grid;
+    options.cityCount = cityCount;
+    return generateNetwork(options);
+}
+
+static GeneratedNetwork roadLikeNetwork(int cityCount) {
+    GeneratorOptions options;
+    options.cityCount = cityCount;
+    options.averageDegree = 3.0;
+    return generateNetwork(options);
+}
+
+TEST(ReverseCuthillMcKeeIsAPermutation) {
+    // Several components and isolated cities
+    GeneratorOptions options;
+    options.model = GraphModel::RandomGeometric;
+    options.cityCount = 400;
+    options.averageDegree = 1.5;
+    for (const GeneratedNetwork& network : {gridNetwork(400), roadLikeNetwork(500), generateNetwork(options),
+                                            bandedNetwork(50, 3), GeneratedNetwork()}) {
+        int cityCount = static_cast<int>(network.cityNames.size());
+        vector<int> offsets;
+        vector<int> neighbors;
+        neighborArrays(cityCount, network.roads, offsets, neighbors);
+        vector<int> order = reverseCuthillMcKee(offsets, neighbors);
+        vector<int> sorted = order;
+        sort(sorted.begin(), sorted.end());
+        vector<int> slots(cityCount);
+        iota(slots.begin(), slots.end(), 0);
+        CHECK(sorted == slots);
+    }
+}
+
+TEST(ReorderingKeepsComponentsSearchesAndWeights) {
+    GeneratorOptions options;
+    options.model = GraphModel::RandomGeometric;
+    options.cityCount = 300;
+    options.averageDegree = 2.0;
+    for (const GeneratedNetwork& network : {roadLikeNetwork(300), generateNetwork(options)}) {
+        int cityCount = static_cast<int>(network.cityNames.size());
+        BasicInfrastructure<DenseStorage, Budget> engine;
+        REQUIRE(engine.loadNetwork(network.cityNames, network.roads));
+        vector<int> components = engine.componentLabels();
+        vector<vector<Budget>> weights(cityCount, vector<Budget>(cityCount));
+        for (int i = 0; i < cityCount; ++i) {
+            for (int j = 0; j < cityCount; ++j) {
+                weights[i][j] = i == j ? 0 : engine.pairWeight(i, j);
+            }
+        }
+
+        engine.reorderStorage(CityOrder::ReverseCuthillMcKee);
+        CHECK(engine.componentLabels() == components);
+        for (int i = 0; i < cityCount; ++i) {
+            for (int j = 0; j < cityCount; ++j) {
+                if (i != j) {
+                    CHECK_EQ(engine.pairWeight(i, j), weights[i][j]);
+                }
+            }
+        }
+
+        // A search visits the same cities, one hop level after another
+        vector<int> offsets;
+        vector<int> neighbors;
+        neighborArrays(cityCount, network.roads, offsets, neighbors);
+        for (int source = 0; source < cityCount; source += 37) {
+            vector<int> hops(cityCount, -1);
+            vector<int> queue(1, source);
+            hops[source] = 0;
+            for (size_t head = 0; head < queue.size(); ++head) {
+                for (int k = offsets[queue[head]]; k < offsets[queue[head] + 1]; ++k) {
+                    if (hops[neighbors[k]] < 0) {
+                        hops[neighbors[k]] = hops[queue[head]] + 1;
+                        queue.push_back(neighbors[k]);
+                    }
+                }
+            }
+            vector<int> visited = engine.breadthFirstOrder(source);
+            REQUIRE(!visited.empty());
+            CHECK_EQ(visited[0], source);
+            for (size_t k = 1; k < visited.size(); ++k) {
+                CHECK(hops[visited[k - 1]] <= hops[visited[k]]);
+            }
+            sort(visited.begin(), visited.end());
+            sort(queue.begin(), queue.end());
+            CHECK(visited == queue);
+        }
+
+        // Back to insertion order gives the original layout
+        engine.reorderStorage(CityOrder::Insertion);
+        CHECK_EQ(engine.storageRow(cityCount - 1), cityCount - 1);
+        CHECK(engine.componentLabels() == components);
+    }
+}
+
+TEST(ReverseCuthillMcKeeKeepsBandedNetworksBanded) {
+    // Insertion order is already optimal here, so the heuristic must
+    // at least match it
+    for (const GeneratedNetwork& network : {bandedNetwork(200, 1), bandedNetwork(200, 4), gridNetwork(400),
+                                            gridNetwork(900)}) {
+        int cityCount = static_cast<int>(network.cityNames.size());
+        vector<int> offsets;
+        vector<int> neighbors;
+        neighborArrays(cityCount, network.roads, offsets, neighbors);
+        OrderSpread insertion = measureSpread(offsets, neighbors, {});
+        OrderSpread reordered = measureSpread(offsets, neighbors, rowsOf(reverseCuthillMcKee(offsets, neighbors)));
+        CHECK(reordered.bandwidth <= insertion.bandwidth);
+
+        BasicInfrastructure<DenseStorage, Budget> engine;
+        REQUIRE(engine.loadNetwork(network.cityNames, network.roads));
+        engine.reorderStorage(CityOrder::ReverseCuthillMcKee);
+        CHECK_EQ(engine.storageSpread().bandwidth, reordered.bandwidth);
+    }
+}
+
+TEST(ReverseCuthillMcKeeNarrowsAShuffledGrid) {
+    GeneratedNetwork grid = gridNetwork(400);
+    vector<int> shuffle(grid.cityNames.size());
+    iota(shuffle.begin(), shuffle.end(), 0);
+    // A fixed stride that is coprime with 400 scatters the slots
+    for (size_t slot = 0; slot < shuffle.size(); ++slot) {
+        shuffle[slot] = static_cast<int>(slot * 149 % shuffle.size());
+    }
+    vector<Road> roads = grid.roads;
+    for (Road& road : roads) {
+        road.city1 = shuffle[road.city1 - 1] + 1;
+        road.city2 = shuffle[road.city2 - 1] + 1;
+    }
+    vector<int> offsets;
+    vector<int> neighbors;
+    neighborArrays(static_cast<int>(shuffle.size()), roads, offsets, neighbors);
+    OrderSpread insertion = measureSpread(offsets, neighbors, {});
+    OrderSpread reordered = measureSpread(offsets, neighbors, rowsOf(reverseCuthillMcKee(offsets, neighbors)));
+    CHECK(reordered.bandwidth <= 2 * 20);
+    CHECK(reordered.bandwidth < insertion.bandwidth / 4);
+    CHECK(reordered.averageSpan < insertion.averageSpan / 4);
+}
@@ -0,0 +1,152 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - graph storage tests
+ *
+ * The triangular, bitset and CSR policies against dense storage
+ * under the same random sequence of road and city changes, and
+ * after bulk loading the roads that sequence leaves.
+ *****************************************************************/
+
+#include "test_harness.h"
+#include "graph_storage.h"
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/**
+ * The neighbors of a city in ascending order
+ */
+template <typename Storage>
+static vector<pair<int, Budget>> sortedNeighbors(const Storage& storage, int i) {
+    vector<pair<int, Budget>> neighbors;
+    storage.forEachNeighbor(i, [&](int j, Budget w) { neighbors.push_back({j, w}); });
+    sort(neighbors.begin(), neighbors.end());
+    return neighbors;
+}
+
+/**
+ * Checks every query of a storage against dense storage holding the
+ * same roads
+ */
+template <typename Storage>
+static void checkMatchesDense(const Storage& storage, const DenseStorage<Budget>& dense, int cityCount) {
+    for (int i = 0; i < cityCount; ++i) {
+        for (int j = 0; j < cityCount; ++j) {
+            if (i != j) {
+                CHECK_EQ(storage.hasRoad(i, j), dense.hasRoad(i, j));
+                CHECK_EQ(storage.weight(i, j), dense.weight(i, j));
+            }
+        }
+        CHECK(sortedNeighbors(storage, i) == sortedNeighbors(dense, i));
+        CHECK_EQ(storage.rowTotal(i), dense.rowTotal(i));
+        WeightSummary<Budget> row = storage.rowSummary(i, 500);
+        WeightSummary<Budget> expectedRow = dense.rowSummary(i, 500);
+        CHECK_EQ(row.total, expectedRow.total);
+        CHECK_EQ(row.max, expectedRow.max);
+        CHECK_EQ(row.funded, expectedRow.funded);
+        CHECK_EQ(row.atLeast, expectedRow.atLeast);
+    }
+    CHECK_EQ(storage.totalWeight(), dense.totalWeight());
+    for (Budget threshold : {Budget(0), Budget(1), Budget(500), Budget(1001)}) {
+        WeightSummary<Budget> summary = storage.summary(threshold);
+        WeightSummary<Budget> expected = dense.summary(threshold);
+        CHECK_EQ(summary.total, expected.total);
+        CHECK_EQ(summary.max, expected.max);
+        CHECK_EQ(summary.funded, expected.funded);
+        CHECK_EQ(summary.atLeast, expected.atLeast);
+    }
+}
+
+/**
+ * Applies the same change to every policy
+ */
+struct AllStorages {
+    DenseStorage<Budget> dense;
+    TriangularStorage<Budget> triangular;
+    BitsetStorage<Budget> bitset;
+    CsrStorage<Budget> csr;
+
+    template <typename Change>
+    void apply(Change change) {
+        change(dense);
+        change(triangular);
+        change(bitset);
+        change(csr);
+    }
+
+    void check(int cityCount) {
+        checkMatchesDense(triangular, dense, cityCount);
+        checkMatchesDense(bitset, dense, cityCount);
+        checkMatchesDense(csr, dense, cityCount);
+    }
+};
+
+TEST(StoragePoliciesMatchDenseUnderRandomChanges) {
+    mt19937 random(11);
+    AllStorages storages;
+    int cityCount = 0;
+    vector<pair<int, int>> roads;
+
+    for (int step = 0; step < 600; ++step) {
+        int action = uniform_int_distribution<int>(0, 9)(random);
+        if (action == 0 || cityCount < 2) {
+            // Grows past the 64-city bitset word and the dense padding
+            cityCount += uniform_int_distribution<int>(1, 9)(random);
+            storages.apply([&](auto& storage) { storage.resize(cityCount); });
+        } else if (action == 1) {
+            // Drops the last city once its roads are gone
+            int last = cityCount - 1;
+            for (size_t k = roads.size(); k-- > 0;) {
+                if (roads[k].first == last || roads[k].second == last) {
+                    pair<int, int> road = roads[k];
+                    storages.apply([&](auto& storage) { storage.removeRoad(road.first, road.second); });
+                    roads.erase(roads.begin() + k);
+                }
+            }
+            cityCount = last;
+            storages.apply([&](auto& storage) { storage.resize(cityCount); });
+        } else if (action <= 6) {
+            int i = uniform_int_distribution<int>(0, cityCount - 1)(random);
+            int j = uniform_int_distribution<int>(0, cityCount - 1)(random);
+            if (i == j || storages.dense.hasRoad(i, j)) {
+                continue;
+            }
+            // Some roads stay unfunded
+            Budget w = uniform_int_distribution<Budget>(0, 1000)(random);
+            storages.apply([&](auto& storage) {
+                storage.addRoad(i, j);
+                if (w % 3 != 0) {
+                    storage.setWeight(j, i, w);
+                }
+            });
+            roads.push_back({i, j});
+        } else if (action <= 8 && !roads.empty()) {
+            size_t k = uniform_int_distribution<size_t>(0, roads.size() - 1)(random);
+            pair<int, int> road = roads[k];
+            storages.apply([&](auto& storage) { storage.removeRoad(road.second, road.first); });
+            roads.erase(roads.begin() + k);
+        } else if (!roads.empty()) {
+            size_t k = uniform_int_distribution<size_t>(0, roads.size() - 1)(random);
+            Budget w = uniform_int_distribution<Budget>(0, 1000)(random);
+            storages.apply([&](auto& storage) { storage.setWeight(roads[k].first, roads[k].second, w); });
+        }
+        if (step % 50 == 0) {
+            storages.check(cityCount);
+        }
+    }
+    storages.check(cityCount);
+    REQUIRE(!roads.empty());
+
+    // Bulk loading the surviving roads gives the same storage again
+    vector<Budget> weights;
+    for (const auto& road : roads) {
+        weights.push_back(storages.dense.weight(road.first, road.second));
+    }
+    AllStorages loaded;
+    loaded.apply([&](auto& storage) { bulkLoadStorage(storage, cityCount, roads, weights); });
+    checkMatchesDense(loaded.dense, storages.dense, cityCount);
+    loaded.check(cityCount);
+}
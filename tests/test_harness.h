@@ -0,0 +1,190 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - test harness
+ *
+ * A small self-contained unit test harness. Tests are registered
+ * with TEST() and run in registration order; CHECK() and
+ * CHECK_EQ() record a failure and let the test continue, REQUIRE()
+ * stops the test. Every test runs in a fresh scratch directory, so
+ * files written by saveToFiles() never touch the source tree.
+ *
+ * Command line options:
+ *   --filter=<text>      Only run tests whose name contains text
+ *****************************************************************/
+
+#ifndef RWANDA_TEST_HARNESS_H
+#define RWANDA_TEST_HARNESS_H
+
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace test {
+
+/**
+ * A registered test
+ */
+struct Test {
+    std::string name;
+    std::function<void()> function;
+};
+
+inline std::vector<Test>& registry() {
+    static std::vector<Test> tests;
+    return tests;
+}
+
+struct Registrar {
+    Registrar(const std::string& name, std::function<void()> function) {
+        registry().push_back({name, function});
+    }
+};
+
+/**
+ * Failures recorded by the running test
+ */
+inline int& failureCount() {
+    static int count = 0;
+    return count;
+}
+
+/**
+ * Thrown by REQUIRE() to abandon the running test
+ */
+struct Abort {};
+
+inline void reportFailure(const char* file, int line, const std::string& message) {
+    ++failureCount();
+    std::fprintf(stderr, "  %s:%d: %s\n", file, line, message.c_str());
+}
+
+template <typename T>
+std::string describe(const T& value) {
+    std::ostringstream out;
+    out << value;
+    return out.str();
+}
+
+/**
+ * Redirects std::cout to nowhere while in scope
+ * The library reports every operation on the console
+ */
+class SilenceStdout {
+private:
+    std::ostringstream sink;
+    std::streambuf* previous;
+
+public:
+    SilenceStdout() : previous(std::cout.rdbuf()) {
+        sink.setstate(std::ios::badbit);
+        std::cout.rdbuf(sink.rdbuf());
+    }
+    ~SilenceStdout() { std::cout.rdbuf(previous); }
+};
+
+/**
+ * A fresh directory under the system temp directory, removed again
+ * when the test ends
+ */
+inline std::filesystem::path scratchDirectory(const std::string& name) {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "rwanda_tests" / name;
+    std::filesystem::remove_all(path);
+    std::filesystem::create_directories(path);
+    return path;
+}
+
+/**
+ * Runs the registered tests and prints one line per test
+ * @return Process exit code, non-zero if any test failed
+ */
+inline int runTests(int argc, char** argv) {
+    namespace fs = std::filesystem;
+    std::string filter;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option.rfind("--filter=", 0) == 0) {
+            filter = option.substr(9);
+        } else {
+            std::cerr << "Unknown option " << option << std::endl;
+            return 1;
+        }
+    }
+
+    fs::path start = fs::current_path();
+    int run = 0;
+    int failed = 0;
+    for (const Test& t : registry()) {
+        if (!filter.empty() && t.name.find(filter) == std::string::npos) {
+            continue;
+        }
+
+        fs::path scratch = scratchDirectory(t.name);
+        fs::current_path(scratch);
+        failureCount() = 0;
+        try {
+            SilenceStdout silence;
+            t.function();
+        } catch (const Abort&) {
+        } catch (const std::exception& e) {
+            reportFailure(__FILE__, __LINE__, std::string("unexpected exception: ") + e.what());
+        }
+        fs::current_path(start);
+        fs::remove_all(scratch);
+
+        ++run;
+        if (failureCount() > 0) {
+            ++failed;
+        }
+        std::printf("%-6s %s\n", failureCount() > 0 ? "FAIL" : "ok", t.name.c_str());
+        std::fflush(stdout);
+    }
+
+    std::printf("%d tests, %d failed\n", run, failed);
+    return failed > 0 ? 1 : 0;
+}
+
+} // namespace test
+
+#define TEST_CONCAT_INNER(a, b) a##b
+#define TEST_CONCAT(a, b) TEST_CONCAT_INNER(a, b)
+
+/**
+ * Defines and registers a test
+ * Usage: TEST(BudgetParsesDecimals) { CHECK(...); }
+ */
+#define TEST(name)                                                              \
+    static void name();                                                         \
+    static test::Registrar TEST_CONCAT(testRegistrar_, __LINE__)(#name, name);  \
+    static void name()
+
+#define CHECK(condition)                                                        \
+    do {                                                                        \
+        if (!(condition)) {                                                     \
+            test::reportFailure(__FILE__, __LINE__, "CHECK(" #condition ") failed"); \
+        }                                                                       \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                              \
+    do {                                                                        \
+        const auto testActual = (actual);                                       \
+        const auto testExpected = (expected);                                   \
+        if (!(testActual == testExpected)) {                                    \
+            test::reportFailure(__FILE__, __LINE__,                             \
+                "CHECK_EQ(" #actual ", " #expected ") failed: " +               \
+                test::describe(testActual) + " != " + test::describe(testExpected)); \
+        }                                                                       \
+    } while (0)
+
+#define REQUIRE(condition)                                                      \
+    do {                                                                        \
+        if (!(condition)) {                                                     \
+            test::reportFailure(__FILE__, __LINE__, "REQUIRE(" #condition ") failed"); \
+            throw test::Abort();                                                \
+        }                                                                       \
+    } while (0)
+
+#endif // RWANDA_TEST_HARNESS_H
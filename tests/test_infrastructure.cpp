@@ -0,0 +1,168 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - library tests
+ *
+ * Cities, roads and budgets through the rwanda_infra library API.
+ *****************************************************************/
+
+#include "test_harness.h"
+#include "infrastructure.h"
+
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+TEST(AddCityRejectsDuplicateNames) {
+    RwandaInfrastructure network;
+    CHECK(network.addCity("Kigali"));
+    CHECK(network.addCity("Musanze"));
+    CHECK(!network.addCity("Kigali"));
+    CHECK_EQ(network.cityCount(), 2);
+    CHECK_EQ(network.findCityIndex("Musanze"), 2);
+    CHECK_EQ(network.findCityIndex("Huye"), -1);
+}
+
+TEST(AddRoadAndBudget) {
+    RwandaInfrastructure network;
+    network.addCity("Kigali");
+    network.addCity("Musanze");
+    network.addCity("Huye");
+    CHECK(network.addRoad("Kigali", "Musanze"));
+    CHECK(!network.addRoad("Kigali", "Musanze"));
+    CHECK(!network.addRoad("Kigali", "Kigali"));
+    CHECK(network.addBudget("Kigali", "Musanze", 28600000));
+    CHECK(!network.addBudget("Kigali", "Huye", 1000000));
+
+    CHECK_EQ(network.roadCount(), 1);
+    CHECK(network.slotsConnected(0, 1));
+    CHECK(!network.slotsConnected(0, 2));
+    CHECK_EQ(network.pairWeight(0, 1), 28600000);
+    CHECK_EQ(network.networkBudgetTotal(), 28600000);
+    CHECK_EQ(network.componentCount(), 2);
+}
+
+TEST(SaveToFilesWritesBothTables) {
+    RwandaInfrastructure network;
+    network.addCity("Kigali");
+    network.addCity("Musanze");
+    network.addRoad("Kigali", "Musanze");
+    network.saveToFiles();
+    CHECK(filesystem::exists("cities.txt"));
+    CHECK(filesystem::exists("roads.txt"));
+}
+
+TEST(RedoRestoresAnAddedCityWithItsDistrictAndLocation) {
+    RwandaInfrastructure network;
+    network.addCity("Kigali");
+    network.addCity("Musanze");
+    REQUIRE(network.assignDistrict("Musanze", "Musanze"));
+    REQUIRE(network.setCityLocation("Musanze", {-1.4998, 29.6344}));
+    int district = findDistrict("Musanze");
+
+    // Districts and locations are not journaled, so one undo takes
+    // the city with both
+    REQUIRE(network.undo());
+    CHECK_EQ(network.cityCount(), 1);
+    CHECK_EQ(network.regionPartition().districtCityCount(district), 0);
+    CHECK(!network.spatialIndex().hasLocation(1));
+
+    REQUIRE(network.redo());
+    CHECK_EQ(network.findCityIndex("Musanze"), 2);
+    CHECK_EQ(network.regionPartition().districtCityCount(district), 1);
+    REQUIRE(network.spatialIndex().hasLocation(1));
+    CHECK_EQ(network.spatialIndex().location(1).latitude, -1.4998);
+    CHECK_EQ(network.spatialIndex().location(1).longitude, 29.6344);
+}
+
+TEST(RedoRestoresAnAddedRoadWithItsAttributesAndYearlyBudgets) {
+    RwandaInfrastructure network;
+    network.addCity("Kigali");
+    network.addCity("Musanze");
+    network.addRoad("Kigali", "Musanze");
+    REQUIRE(network.setRoadAttributes("Kigali", "Musanze", {93.5, "paved", 2, 4}));
+    REQUIRE(network.addYearBudget("Kigali", "Musanze", 2023, 28600000));
+    REQUIRE(network.addYearBudget("Kigali", "Musanze", 2024, 30250000));
+
+    REQUIRE(network.undo());
+    CHECK_EQ(network.roadCount(), 0);
+    CHECK_EQ(network.budgetTimeSeries().roadCount(), size_t(0));
+
+    REQUIRE(network.redo());
+    REQUIRE(network.roadCount() == 1);
+    RoadAttributes attributes = network.roadAttributes().get(0);
+    CHECK_EQ(attributes.lengthKm, 93.5);
+    CHECK_EQ(attributes.surface, "paved");
+    CHECK_EQ(attributes.lanes, 2);
+    CHECK_EQ(attributes.condition, 4);
+    CHECK_EQ(network.budgetTimeSeries().budget(0, 2023), 28600000);
+    CHECK_EQ(network.budgetTimeSeries().budget(0, 2024), 30250000);
+}
+
+TEST(UndoingACityAfterReorderKeepsTheOtherRoads) {
+    RwandaInfrastructure network;
+    for (const char* name : {"Kigali", "Musanze", "Huye", "Rubavu", "Rusizi"}) {
+        network.addCity(name);
+    }
+    network.addRoad("Kigali", "Huye");
+    network.addRoad("Huye", "Rusizi");
+    network.addRoad("Rusizi", "Musanze");
+    network.addBudget("Kigali", "Huye", 5000);
+    network.addBudget("Rusizi", "Musanze", 7000);
+    network.addCity("Nyagatare");
+    network.reorderStorage(CityOrder::ReverseCuthillMcKee);
+
+    // The new city's empty row is somewhere inside the reordered rows
+    REQUIRE(network.storageRow(5) != 5);
+    REQUIRE(network.undo());
+    CHECK_EQ(network.cityCount(), 5);
+    CHECK_EQ(network.roadCount(), 3);
+    CHECK_EQ(network.pairWeight(0, 2), 5000);
+    CHECK_EQ(network.pairWeight(4, 1), 7000);
+    CHECK(network.slotsConnected(2, 4));
+    CHECK(!network.slotsConnected(0, 1));
+    CHECK_EQ(network.networkBudgetTotal(), 12000);
+    CHECK_EQ(network.componentCount(), 2);
+}
+
+TEST(RoadAttributesRejectNonFiniteLengths) {
+    RoadAttributeStore store;
+    CHECK(!store.set(0, {numeric_limits<double>::quiet_NaN(), "paved", 2, 3}));
+    CHECK(!store.set(0, {numeric_limits<double>::infinity(), "paved", 2, 3}));
+    CHECK(!store.set(0, {-1.0, "paved", 2, 3}));
+    CHECK_EQ(store.size(), size_t(0));
+    CHECK(store.set(0, {12.5, "paved", 2, 3}));
+    CHECK_EQ(store.get(0).lengthKm, 12.5);
+}
+
+TEST(MatrixWindowClampsCountsPastTheLastCity) {
+    RwandaInfrastructure network;
+    network.addCity("Kigali");
+    network.addCity("Musanze");
+    network.addCity("Huye");
+
+    // A count near INT_MAX must not wrap start + count around
+    ostringstream out;
+    streambuf* previous = cout.rdbuf(out.rdbuf());
+    network.displayRoadsWindow({2, numeric_limits<int>::max(), 1, numeric_limits<int>::max()});
+    cout.rdbuf(previous);
+    CHECK(out.str().find("rows 2-3, columns 1-3") != string::npos);
+}
+
+TEST(RoadFilterPrefixIgnoresCaseAndAccents) {
+    RwandaInfrastructure network;
+    network.addCity("Kigali");
+    network.addCity("Musanze");
+    network.addCity("Huye");
+    network.addRoad("Kigali", "Musanze");
+    network.addRoad("Kigali", "Huye");
+
+    ostringstream out;
+    streambuf* previous = cout.rdbuf(out.rdbuf());
+    network.displayEdgeList({0, "  mús"}, false);
+    cout.rdbuf(previous);
+    CHECK(out.str().find("Musanze") != string::npos);
+    CHECK(out.str().find("Huye") == string::npos);
+}
@@ -0,0 +1,17 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - unit tests
+ *
+ * Runs the tests registered by the other files in this directory.
+ *
+ * Usage: rwanda_tests [--filter=<text>]
+ *****************************************************************/
+
+#include "test_harness.h"
+
+//====================================================================
+// MAIN FUNCTION
+//====================================================================
+
+int main(int argc, char** argv) {
+    return test::runTests(argc, argv);
+}
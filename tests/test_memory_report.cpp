@@ -0,0 +1,108 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - memory report tests
+ *
+ * The footprint predictions against what each backend actually
+ * allocates for a generated network, with and without parallel
+ * roads, and against the memory report as a whole.
+ *****************************************************************/
+
+#include "test_harness.h"
+#include "generator.h"
+#include "graph_engine.h"
+#include "memory_report.h"
+#include "road_query.h"
+
+#include <string>
+
+using namespace std;
+
+/**
+ * Checks a backend's predicted storage bytes against its allocation
+ * after loading the network, within the given relative error
+ */
+template <template <typename> class StoragePolicy>
+static void checkStoragePrediction(const GeneratedNetwork& generated, double tolerance) {
+    BasicInfrastructure<StoragePolicy, Budget> engine;
+    REQUIRE(engine.loadNetwork(generated.cityNames, generated.roads));
+    StorageBackend backend = StoragePolicy<Budget>::backend;
+    double actual = engine.roadStorage().capacityBytes();
+    double predicted = predictStorageBytes(backend, engine.cityCount(), engine.pairCount());
+    CHECK(predicted >= actual * (1.0 - tolerance));
+    CHECK(predicted <= actual * (1.0 + tolerance));
+}
+
+TEST(StoragePredictionsMatchGeneratedNetworks) {
+    for (int cityCount : {100, 1000, 3000}) {
+        GeneratorOptions options;
+        options.cityCount = cityCount;
+        options.averageDegree = 3.0;
+        GeneratedNetwork generated = generateNetwork(options);
+
+        checkStoragePrediction<DenseStorage>(generated, 0.01);
+        checkStoragePrediction<TriangularStorage>(generated, 0.01);
+        checkStoragePrediction<BitsetStorage>(generated, 0.05);
+        checkStoragePrediction<CsrStorage>(generated, 0.05);
+    }
+}
+
+TEST(StoragePredictionsCountParallelRoadsOnce) {
+    GeneratorOptions options;
+    options.cityCount = 1000;
+    options.averageDegree = 3.0;
+    GeneratedNetwork generated = generateNetwork(options);
+    size_t pairs = generated.roads.size();
+    // A second road alongside every third one
+    for (size_t k = 0; k < pairs; k += 3) {
+        generated.roads.push_back(generated.roads[k]);
+    }
+
+    BasicInfrastructure<CsrStorage, Budget> engine;
+    REQUIRE(engine.loadNetwork(generated.cityNames, generated.roads));
+    CHECK_EQ(engine.pairCount(), static_cast<int>(pairs));
+    CHECK(engine.roadCount() > engine.pairCount());
+    checkStoragePrediction<BitsetStorage>(generated, 0.05);
+    checkStoragePrediction<CsrStorage>(generated, 0.05);
+}
+
+TEST(MemoryPredictionMatchesTheReport) {
+    for (int cityCount : {500, 3000}) {
+        GeneratorOptions options;
+        options.cityCount = cityCount;
+        options.averageDegree = 3.0;
+        GeneratedNetwork generated = generateNetwork(options);
+        RwandaInfrastructure network;
+        loadGeneratedNetwork(network, generated);
+
+        // Build the structures that are made on demand
+        network.regionPartition();
+        network.routeGraph();
+        RoadQuery query;
+        string error;
+        REQUIRE(parseRoadQuery("budget > 0", query, error));
+        network.queryRoads(query);
+
+        // The storage is checked above; compare everything else the
+        // prediction covers
+        double measured = 0;
+        double storage = 0;
+        for (const MemoryUsage& usage : network.memoryUsage()) {
+            if (usage.structure == "road storage") {
+                storage = usage.usedBytes;
+            } else if (usage.structure != "spatial index" && usage.structure != "budget history" &&
+                       usage.structure != "undo journal") {
+                measured += usage.usedBytes;
+            }
+        }
+        double nameLength = 0;
+        for (const string& name : generated.cityNames) {
+            nameLength += name.size();
+        }
+        nameLength /= cityCount;
+        double predicted = predictMemoryBytes(StorageBackend::Dense, network.cityCount(), network.roadCount(),
+                                              network.pairCount(), nameLength);
+        predicted -= predictStorageBytes(StorageBackend::Dense, network.cityCount(), network.pairCount());
+        CHECK(storage > 0);
+        CHECK(predicted >= measured * 0.9);
+        CHECK(predicted <= measured * 1.1);
+    }
+}
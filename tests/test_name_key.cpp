@@ -0,0 +1,108 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - city name key tests
+ *
+ * Case, accent and blank folding of names, and backshift deletion
+ * in the key table, both inside a probe cluster and across the end
+ * of the bucket array.
+ *****************************************************************/
+
+#include "test_harness.h"
+#include "name_key.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+TEST(NormalizeNameFoldsCaseAndBlanks) {
+    CHECK_EQ(normalizeName("Kigali"), "kigali");
+    CHECK_EQ(normalizeName("  KIGALI\t"), "kigali");
+    CHECK_EQ(normalizeName("Nyamata   Town"), "nyamata town");
+    CHECK_EQ(normalizeName("Nyamata\xC2\xA0Town"), "nyamata town");
+    CHECK_EQ(normalizeName(" \t "), "");
+}
+
+TEST(NormalizeNameFoldsAccents) {
+    CHECK_EQ(normalizeName("KIGAL\xC3\x8D"), "kigali");             // Precomposed capital I acute
+    CHECK_EQ(normalizeName("Kigal\xC3\xAD"), "kigali");             // Precomposed small i acute
+    CHECK_EQ(normalizeName("Kigali\xCC\x81"), "kigali");            // Combining acute accent
+    CHECK_EQ(normalizeName("R\xC3\xBCtsiro"), "rutsiro");
+    CHECK_EQ(normalizeName("\xC5\x92uvre"), "oeuvre");              // Latin Extended-A ligature
+    CHECK_EQ(normalizeName("Stra\xC3\x9F" "e"), "strasse");
+    // Letters outside the folded ranges are kept as they are
+    CHECK_EQ(normalizeName("\xE2\x82\xAC" "A"), "\xE2\x82\xAC" "a");
+}
+
+/**
+ * Keys whose home bucket in a 16-bucket table is the given one
+ */
+static vector<string> keysWithHome(size_t home, size_t count) {
+    vector<string> keys;
+    for (int n = 0; keys.size() < count; ++n) {
+        string key = "city " + to_string(n);
+        if ((static_cast<uint32_t>(hash<string>()(key)) & 15) == home) {
+            keys.push_back(key);
+        }
+    }
+    return keys;
+}
+
+/**
+ * Checks that every slot still present is found under its key, and
+ * that erased slots are not
+ */
+static void checkLookups(const CityKeyTable& table, const vector<string>& keys, const vector<bool>& present) {
+    auto keyOf = [&](int slot) { return keys[slot]; };
+    for (size_t slot = 0; slot < keys.size(); ++slot) {
+        CHECK_EQ(table.find(keys[slot], keyOf), present[slot] ? static_cast<int>(slot) : -1);
+    }
+}
+
+/**
+ * Fills a 16-bucket table with clusters, then erases the slots one
+ * at a time in the given order
+ */
+static void checkEraseOrder(const vector<string>& keys, const vector<int>& order) {
+    auto keyOf = [&](int slot) { return keys[slot]; };
+    CityKeyTable table;
+    vector<bool> present(keys.size(), true);
+    for (size_t slot = 0; slot < keys.size(); ++slot) {
+        table.insert(static_cast<int>(slot), keyOf);
+    }
+    // The homes chosen above assume the first 16 buckets
+    REQUIRE(table.usedBytes() == 16 * (sizeof(int) + sizeof(uint32_t)));
+    checkLookups(table, keys, present);
+    for (int slot : order) {
+        table.erase(slot, keyOf);
+        present[slot] = false;
+        checkLookups(table, keys, present);
+    }
+    CHECK_EQ(table.size(), 0u);
+}
+
+TEST(CityKeyTableEraseKeepsProbeClustersReachable) {
+    // Three keys at home 4 and two at home 5 form one run over
+    // buckets 4 to 8
+    vector<string> keys = keysWithHome(4, 3);
+    for (const string& key : keysWithHome(5, 2)) {
+        keys.push_back(key);
+    }
+    checkEraseOrder(keys, {0, 1, 2, 3, 4});
+    checkEraseOrder(keys, {1, 3, 0, 4, 2});
+    checkEraseOrder(keys, {4, 3, 2, 1, 0});
+}
+
+TEST(CityKeyTableEraseWrapsAroundTheBuckets) {
+    // Three keys at home 14 fill buckets 14, 15 and 0; keys at home 0
+    // and 1 are pushed along behind them
+    vector<string> keys = keysWithHome(14, 3);
+    for (const string& key : keysWithHome(0, 2)) {
+        keys.push_back(key);
+    }
+    keys.push_back(keysWithHome(1, 1)[0]);
+    checkEraseOrder(keys, {0, 1, 2, 3, 4, 5});
+    checkEraseOrder(keys, {2, 0, 5, 3, 1, 4});
+    checkEraseOrder(keys, {3, 1, 4, 0, 5, 2});
+}
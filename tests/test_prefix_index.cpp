@@ -0,0 +1,103 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - prefix search tests
+ *
+ * Prefix ranges over the sorted names, including prefixes longer
+ * than the 8-byte heads, empty prefixes, completion limits, and
+ * one-at-a-time updates against a batch build.
+ *****************************************************************/
+
+#include "test_harness.h"
+#include "infrastructure.h"
+#include "prefix_index.h"
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Index of the given names, slot i holding name i
+ */
+static PrefixIndex indexOf(const vector<string>& names) {
+    PrefixIndex index;
+    index.build(names);
+    return index;
+}
+
+TEST(PrefixRangesFollowTheSortedNames) {
+    PrefixIndex index = indexOf({"Nyanza", "Kigali", "Nyagatare", "Huye", "Nyamasheke", "Ngoma"});
+    CHECK(index.complete("Nya", 10) == (vector<int>{2, 4, 0}));
+    CHECK(index.complete("N", 10) == (vector<int>{5, 2, 4, 0}));
+    CHECK(index.complete("nyaMA", 10) == vector<int>{4});
+    CHECK(index.complete("Huye", 10) == vector<int>{3});
+    CHECK(index.complete("Huyes", 10).empty());
+    CHECK(index.complete("Z", 10).empty());
+    CHECK_EQ(index.countWithPrefix("Ny"), 3u);
+    CHECK_EQ(index.countWithPrefix("Ki"), 1u);
+    CHECK_EQ(index.countWithPrefix("Kb"), 0u);
+}
+
+TEST(PrefixesLongerThanTheHeadCompareTheRest) {
+    // The first three names share the 8-byte head "rwamagan"
+    PrefixIndex index = indexOf({"Rwamagana East", "Rwamaganb", "Rwamagana", "Rwamagan", "Rwamaga"});
+    CHECK(index.complete("Rwamagan", 10) == (vector<int>{3, 2, 0, 1}));
+    CHECK(index.complete("Rwamagana", 10) == (vector<int>{2, 0}));
+    CHECK(index.complete("Rwamagana E", 10) == vector<int>{0});
+    CHECK(index.complete("RWAMAGANA  EAST", 10) == vector<int>{0});
+    CHECK(index.complete("Rwamagana Eastern", 10).empty());
+    CHECK(index.complete("Rwamaganc", 10).empty());
+    CHECK_EQ(index.countWithPrefix("Rwamaga"), 5u);
+    CHECK_EQ(index.countWithPrefix("Rwamaganb"), 1u);
+}
+
+TEST(EmptyPrefixesMatchEveryName) {
+    PrefixIndex index = indexOf({"Musanze", "Huye", "Kigali"});
+    CHECK(index.complete("", 10) == (vector<int>{1, 2, 0}));
+    CHECK(index.complete("  ", 10) == (vector<int>{1, 2, 0}));
+    CHECK_EQ(index.countWithPrefix(""), 3u);
+    CHECK(indexOf({}).complete("", 10).empty());
+}
+
+TEST(CompletionStopsAtTheLimit) {
+    PrefixIndex index = indexOf({"Gisenyi", "Gicumbi", "Gitarama", "Gikongoro", "Gisagara"});
+    CHECK(index.complete("Gi", 2) == (vector<int>{1, 3}));
+    CHECK(index.complete("Gi", 0).empty());
+    CHECK_EQ(index.complete("Gi", 100).size(), 5u);
+    CHECK_EQ(index.countWithPrefix("Gi"), 5u);
+}
+
+TEST(PrefixUpdatesMatchABatchBuild) {
+    vector<string> names = {"Kigali", "kigali", "Kibuye", "Karongi", "Kibungo", "Muhanga"};
+    PrefixIndex built = indexOf(names);
+    PrefixIndex added;
+    for (int slot = static_cast<int>(names.size()) - 1; slot >= 0; --slot) {
+        added.add(slot, names[slot]);
+    }
+    CHECK(added.complete("", 10) == built.complete("", 10));
+    // Equal names stay ordered by slot
+    CHECK(added.complete("Kigali", 10) == (vector<int>{0, 1}));
+
+    added.remove(0, "Kigali");
+    added.remove(4, "Kibungo");
+    added.remove(4, "Kibungo");
+    CHECK(added.complete("Ki", 10) == (vector<int>{2, 1}));
+    CHECK_EQ(added.size(), 4u);
+    added.add(4, "Kibungo");
+    CHECK(added.complete("Kib", 10) == (vector<int>{4, 2}));
+}
+
+TEST(CityNamesCompleteThroughTheNetwork) {
+    RwandaInfrastructure network;
+    network.addCity("Nyagatare");
+    network.addCity("Nyanza");
+    network.addCity("Huye");
+    CHECK(network.completeCityName("ny", 5) == (vector<string>{"Nyagatare", "Nyanza"}));
+    CHECK(network.completeCityName("ny", 1) == vector<string>{"Nyagatare"});
+
+    CHECK(network.editCity("Nyanza", "Gisagara"));
+    CHECK(network.completeCityName("ny", 5) == vector<string>{"Nyagatare"});
+    CHECK(network.completeCityName("Gis", 5) == vector<string>{"Gisagara"});
+    CHECK(network.undo());
+    CHECK(network.completeCityName("Gis", 5).empty());
+    CHECK(network.completeCityName("Nyan", 5) == vector<string>{"Nyanza"});
+}
@@ -0,0 +1,77 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - region tests
+ *
+ * The partitioned layout behind the regional report.
+ *****************************************************************/
+
+#include "test_harness.h"
+#include "infrastructure.h"
+#include "regions.h"
+
+using namespace std;
+
+TEST(RegionPartitionSeparatesUnassignedRoads) {
+    RwandaInfrastructure network;
+    for (const char* name : {"Kigali", "Kicukiro", "Musanze", "Huye", "Nowhere"}) {
+        network.addCity(name);
+    }
+    network.assignDistrict("Kigali", "Gasabo");
+    network.assignDistrict("Kicukiro", "Kicukiro");
+    network.assignDistrict("Musanze", "Musanze");
+    network.assignDistrict("Huye", "Huye");
+    network.addRoad("Kigali", "Kicukiro");
+    network.addRoad("Kigali", "Musanze");
+    network.addRoad("Musanze", "Huye");
+    network.addRoad("Huye", "Nowhere");
+    network.addBudget("Kigali", "Musanze", 2000000);
+    network.addBudget("Musanze", "Huye", 3000000);
+    network.addBudget("Huye", "Nowhere", 5000000);
+
+    const RegionPartition& partition = network.regionPartition();
+    CHECK_EQ(partition.provinceCityCount(0), 2);
+    CHECK_EQ(partition.provinceRoadCount(0), 1);
+    CHECK_EQ(partition.districtCityCount(UNASSIGNED_DISTRICT), 1);
+    CHECK_EQ(partition.crossEdges.size(), 2u);
+    CHECK_EQ(partition.crossBudget(), 5000000);
+    CHECK_EQ(partition.unassignedEdges.size(), 1u);
+    CHECK_EQ(partition.unassignedBudget(), 5000000);
+}
+
+TEST(RegionPartitionFollowsEdits) {
+    RwandaInfrastructure network;
+    network.addCity("Kigali");
+    network.addCity("Huye");
+    network.addRoad("Kigali", "Huye");
+    CHECK_EQ(network.regionPartition().unassignedEdges.size(), 1u);
+
+    network.assignDistrict("Kigali", "Gasabo");
+    network.assignDistrict("Huye", "Huye");
+    CHECK_EQ(network.regionPartition().unassignedEdges.size(), 0u);
+    CHECK_EQ(network.regionPartition().crossEdges.size(), 1u);
+
+    network.addBudget("Kigali", "Huye", 7000000);
+    CHECK_EQ(network.regionPartition().crossBudget(), 7000000);
+
+    network.addCity("Nyanza");
+    network.assignDistrict("Nyanza", "Nyanza");
+    network.addRoad("Huye", "Nyanza");
+    CHECK_EQ(network.regionPartition().provinceRoadCount(2), 1);
+    CHECK_EQ(network.regionPartition().provinceCityCount(2), 2);
+}
+
+TEST(RegionLookupsIgnoreCaseAndAccents) {
+    CHECK_EQ(findDistrict("Gasabo"), 0);
+    CHECK_EQ(findDistrict("gasabo"), 0);
+    CHECK_EQ(findDistrict("  NYARUGENGE "), 2);
+    CHECK_EQ(findDistrict("Nyarug\xC3\xA9nge"), 2);
+    CHECK_EQ(findDistrict("Kigali"), -1);
+    CHECK_EQ(findProvince("Kigali City"), 0);
+    CHECK_EQ(findProvince("kigali  city"), 0);
+    CHECK_EQ(findProvince("WESTERN"), 4);
+    CHECK_EQ(findProvince("Westerns"), -1);
+
+    RwandaInfrastructure network;
+    network.addCity("Kigali");
+    CHECK(network.assignDistrict("kigali", "gasabo"));
+    CHECK_EQ(network.regionPartition().provinceCityCount(0), 1);
+}
@@ -0,0 +1,199 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - road query tests
+ *
+ * Parsing of the query text and execution over the road columns.
+ *****************************************************************/
+
+#include "test_harness.h"
+#include "infrastructure.h"
+#include "road_query.h"
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+TEST(ParseRoadQueryReadsPredicates) {
+    RoadQuery query;
+    string error;
+    REQUIRE(parseRoadQuery("city = \"Musanze\" and budget >= 50.5 and lanes != 2", query, error));
+    REQUIRE(query.predicates.size() == 3u);
+    CHECK(query.predicates[0].field == QueryField::City);
+    CHECK(query.predicates[0].comparison == Comparison::Equal);
+    CHECK_EQ(query.predicates[0].text, "Musanze");
+    CHECK_EQ(query.predicates[0].code, -1);
+    CHECK(query.predicates[1].field == QueryField::Budget);
+    CHECK(query.predicates[1].comparison == Comparison::GreaterEqual);
+    CHECK_EQ(query.predicates[1].budget, 50500000);
+    CHECK(query.predicates[2].field == QueryField::Lanes);
+    CHECK(query.predicates[2].comparison == Comparison::NotEqual);
+    CHECK_EQ(query.predicates[2].number, 2.0);
+    CHECK(query.aggregate == QueryAggregate::List);
+    CHECK(query.grouping == QueryGrouping::None);
+}
+
+TEST(ParseRoadQueryReadsAggregatesAndGrouping) {
+    RoadQuery query;
+    string error;
+    REQUIRE(parseRoadQuery("where surface = gravel and condition < 3 sum", query, error));
+    CHECK_EQ(query.predicates.size(), 2u);
+    CHECK(query.aggregate == QueryAggregate::Sum);
+
+    REQUIRE(parseRoadQuery("count by bucket 25", query, error));
+    CHECK(query.predicates.empty());
+    CHECK(query.aggregate == QueryAggregate::Count);
+    CHECK(query.grouping == QueryGrouping::BudgetBucket);
+    CHECK_EQ(query.bucketWidth, 25000000);
+
+    CHECK(!parseRoadQuery("by surface", query, error));
+    REQUIRE(parseRoadQuery("list by surface", query, error));
+    CHECK(query.aggregate == QueryAggregate::Count);
+    CHECK(query.grouping == QueryGrouping::Surface);
+}
+
+TEST(ParseRoadQueryReportsErrors) {
+    RoadQuery query;
+    string error;
+    CHECK(!parseRoadQuery("speed > 3", query, error));
+    CHECK_EQ(error, "Unknown field 'speed'");
+    CHECK(!parseRoadQuery("budget 3", query, error));
+    CHECK(!parseRoadQuery("budget >", query, error));
+    CHECK(!parseRoadQuery("budget > 1.0000001", query, error));
+    CHECK(!parseRoadQuery("city < Huye", query, error));
+    CHECK(!parseRoadQuery("lanes > two", query, error));
+    CHECK(!parseRoadQuery("lanes > 2 and", query, error));
+    CHECK(!parseRoadQuery("lanes > 2 lanes < 4", query, error));
+    CHECK(!parseRoadQuery("count by bucket 0", query, error));
+    CHECK(!parseRoadQuery("count extra", query, error));
+}
+
+TEST(QueryRoadsFiltersAndAggregates) {
+    RwandaInfrastructure network;
+    for (const char* name : {"Kigali", "Musanze", "Huye", "Rubavu"}) {
+        network.addCity(name);
+    }
+    network.addRoad("Kigali", "Musanze");
+    network.addRoad("Kigali", "Huye");
+    network.addRoad("Musanze", "Rubavu");
+    network.addBudget("Kigali", "Musanze", 30000000);
+    network.addBudget("Kigali", "Huye", 60000000);
+    network.addBudget("Musanze", "Rubavu", 10000000);
+
+    RoadQuery query;
+    string error;
+    REQUIRE(parseRoadQuery("city = kigali", query, error));
+    QueryResult result = network.queryRoads(query);
+    CHECK(result.error.empty());
+    CHECK_EQ(result.roadIds.size(), 2u);
+
+    REQUIRE(parseRoadQuery("budget > 20 sum", query, error));
+    result = network.queryRoads(query);
+    REQUIRE(result.groups.size() == 1u);
+    CHECK_EQ(result.groups[0].count, 2u);
+    CHECK_EQ(result.groups[0].sum, 90000000);
+
+    REQUIRE(parseRoadQuery("city = Nyanza", query, error));
+    CHECK(!network.queryRoads(query).error.empty());
+}
+
+TEST(QueryTableFollowsEdits) {
+    RwandaInfrastructure network;
+    for (const char* name : {"Kigali", "Musanze", "Huye"}) {
+        network.addCity(name);
+    }
+    network.addRoad("Kigali", "Musanze");
+    network.addBudget("Kigali", "Musanze", 30000000);
+
+    RoadQuery budgetQuery;
+    RoadQuery districtQuery;
+    RoadQuery surfaceQuery;
+    string error;
+    REQUIRE(parseRoadQuery("budget > 20", budgetQuery, error));
+    REQUIRE(parseRoadQuery("district = Musanze", districtQuery, error));
+    REQUIRE(parseRoadQuery("surface = gravel", surfaceQuery, error));
+    CHECK_EQ(network.queryRoads(budgetQuery).roadIds.size(), 1u);
+    CHECK_EQ(network.queryRoads(districtQuery).roadIds.size(), 0u);
+    CHECK_EQ(network.queryRoads(surfaceQuery).roadIds.size(), 0u);
+
+    // Each kind of edit must reach the cached table
+    network.addBudget("Kigali", "Musanze", 10000000);
+    CHECK_EQ(network.queryRoads(budgetQuery).roadIds.size(), 0u);
+    network.addRoad("Kigali", "Huye");
+    network.addBudget("Kigali", "Huye", 25000000);
+    CHECK_EQ(network.queryRoads(budgetQuery).roadIds.size(), 1u);
+    network.assignDistrict("Musanze", "Musanze");
+    CHECK_EQ(network.queryRoads(districtQuery).roadIds.size(), 1u);
+    network.setRoadAttributes("Kigali", "Huye", {40.0, "gravel", 2, 3});
+    CHECK_EQ(network.queryRoads(surfaceQuery).roadIds.size(), 1u);
+    network.undo();
+    CHECK_EQ(network.queryRoads(budgetQuery).roadIds.size(), 0u);
+}
+
+/**
+ * Ids of the roads matching a query, which must be valid
+ */
+static vector<int> matchingRoads(RwandaInfrastructure& network, const string& text) {
+    RoadQuery query;
+    string error;
+    if (!parseRoadQuery(text, query, error)) {
+        return {-1};
+    }
+    return network.queryRoads(query).roadIds;
+}
+
+TEST(ConditionQueriesSkipUnratedRoads) {
+    RwandaInfrastructure network;
+    for (const char* name : {"Kigali", "Musanze", "Huye", "Rubavu"}) {
+        network.addCity(name);
+    }
+    network.addRoad("Kigali", "Musanze");
+    network.addRoad("Kigali", "Huye");
+    network.addRoad("Musanze", "Rubavu");
+    network.addRoad("Huye", "Rubavu");
+    network.setRoadAttributes("Kigali", "Musanze", {10.0, "paved", 2, 2});
+    network.setRoadAttributes("Kigali", "Huye", {10.0, "paved", 2, 4});
+    // Musanze-Rubavu has attributes but no rating; Huye-Rubavu has none at all
+    network.setRoadAttributes("Musanze", "Rubavu", {10.0, "gravel", 1, RoadAttributeStore::NOT_RATED});
+
+    CHECK(matchingRoads(network, "condition < 3") == vector<int>({0}));
+    CHECK(matchingRoads(network, "condition <= 4") == vector<int>({0, 1}));
+    CHECK(matchingRoads(network, "condition != 4") == vector<int>({0}));
+    CHECK(matchingRoads(network, "condition >= 1") == vector<int>({0, 1}));
+
+    // Option 17 selects the same roads
+    const RoadAttributeStore& attributes = network.roadAttributes();
+    CHECK(attributes.ratedBelow({0, 1, 2}, 3) == vector<int>({0}));
+}
+
+TEST(LengthQueriesCompareAtStoredPrecision) {
+    RwandaInfrastructure network;
+    network.addCity("Kigali");
+    network.addCity("Musanze");
+    network.addCity("Huye");
+    network.addRoad("Kigali", "Musanze");
+    network.addRoad("Kigali", "Huye");
+    network.setRoadAttributes("Kigali", "Musanze", {12.3, "paved", 2, 3});
+    network.setRoadAttributes("Kigali", "Huye", {40.1, "paved", 2, 3});
+
+    CHECK(matchingRoads(network, "length = 12.3") == vector<int>({0}));
+    CHECK(matchingRoads(network, "length <= 12.3") == vector<int>({0}));
+    CHECK(matchingRoads(network, "length >= 40.1") == vector<int>({1}));
+    CHECK(matchingRoads(network, "length != 12.3") == vector<int>({1}));
+}
+
+TEST(RegionQueriesIgnoreCaseAndAccents) {
+    RwandaInfrastructure network;
+    for (const char* name : {"Kigali", "Musanze", "Huye"}) {
+        network.addCity(name);
+    }
+    network.addRoad("Kigali", "Musanze");
+    network.addRoad("Musanze", "Huye");
+    network.assignDistrict("Kigali", "Gasabo");
+    network.assignDistrict("Musanze", "Musanze");
+
+    CHECK(matchingRoads(network, "city = kigali") == vector<int>({0}));
+    CHECK(matchingRoads(network, "district = GASABO") == vector<int>({0}));
+    CHECK(matchingRoads(network, "district = musanz\xC3\xA9") == vector<int>({0, 1}));
+    CHECK(matchingRoads(network, "province = \"kigali city\"") == vector<int>({0}));
+    CHECK(matchingRoads(network, "province = northern") == vector<int>({0, 1}));
+}
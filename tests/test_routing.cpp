@@ -0,0 +1,138 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - routing tests
+ *
+ * Cheapest routes over one-way and two-way roads, and the engine's
+ * undirected cheapest costs.
+ *****************************************************************/
+
+#include "test_harness.h"
+#include "directed_graph.h"
+#include "graph_engine.h"
+#include "infrastructure.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * A random network with some one-way and some parallel roads
+ */
+static vector<Road> randomRoads(int cityCount, int roadCount, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_int_distribution<int> pick(1, cityCount);
+    uniform_int_distribution<int> budget(0, 50);
+    vector<Road> roads;
+    while (static_cast<int>(roads.size()) < roadCount) {
+        int a = pick(rng);
+        int b = pick(rng);
+        if (a != b) {
+            roads.push_back({a, b, static_cast<Budget>(budget(rng)) * 1000, rng() % 3 == 0});
+        }
+    }
+    return roads;
+}
+
+TEST(BidirectionalRouteMatchesOneWayDijkstra) {
+    const int cityCount = 60;
+    vector<Road> roads = randomRoads(cityCount, 150, 11);
+    DirectedRoadGraph graph;
+    graph.build(cityCount, roads);
+
+    for (int source = 0; source < cityCount; ++source) {
+        vector<double> forward = graph.cheapestFrom(source);
+        for (int target = 0; target < cityCount; ++target) {
+            Route route = graph.cheapestRoute(source, target);
+            CHECK_EQ(route.cost, forward[target]);
+            CHECK_EQ(graph.cheapestTo(target)[source], forward[target]);
+            if (isinf(forward[target])) {
+                CHECK(route.cities.empty());
+                continue;
+            }
+
+            // The route follows each road in its direction and adds up to its cost
+            REQUIRE(route.cities.size() == route.roads.size() + 1);
+            CHECK_EQ(route.cities.front(), source);
+            CHECK_EQ(route.cities.back(), target);
+            double cost = 0.0;
+            for (size_t k = 0; k < route.roads.size(); ++k) {
+                const Road& road = roads[route.roads[k]];
+                int from = route.cities[k] + 1;
+                int to = route.cities[k + 1] + 1;
+                CHECK((road.city1 == from && road.city2 == to) ||
+                      (!road.oneWay && road.city1 == to && road.city2 == from));
+                cost += road.budget;
+            }
+            CHECK_EQ(cost, route.cost);
+        }
+    }
+}
+
+TEST(OneWayRoadIsNotTravelledBackward) {
+    RwandaInfrastructure network;
+    network.addCity("Kigali");
+    network.addCity("Musanze");
+    network.addCity("Rubavu");
+    network.addRoad("Kigali", "Musanze", false, true);
+    network.addRoad("Musanze", "Rubavu");
+    network.addBudget("Kigali", "Musanze", 5000000);
+    network.addBudget("Musanze", "Rubavu", 7000000);
+
+    const DirectedRoadGraph& graph = network.routeGraph();
+    CHECK_EQ(graph.cheapestRoute(0, 2).cost, 12000000.0);
+    CHECK(graph.cheapestRoute(2, 0).cities.empty());
+    CHECK_EQ(graph.cheapestRoute(2, 1).cost, 7000000.0);
+}
+
+TEST(RouteGraphCoversCitiesAddedAfterABuild) {
+    RwandaInfrastructure network;
+    network.addCity("Kigali");
+    network.addCity("Musanze");
+    network.addRoad("Kigali", "Musanze");
+    CHECK_EQ(network.routeGraph().cityCount(), 2);
+
+    network.addCity("Huye");
+    CHECK_EQ(network.routeGraph().cityCount(), 3);
+    CHECK(network.routeGraph().cheapestRoute(0, 2).cities.empty());
+    network.undo();
+    CHECK_EQ(network.routeGraph().cityCount(), 2);
+}
+
+TEST(EngineCheapestCostsTakeTheCheapestParallelRoad) {
+    BasicInfrastructure<CsrStorage, Budget> engine;
+    CHECK(engine.loadNetwork({"Kigali", "Musanze", "Rubavu"},
+                             {{1, 2, 10}, {1, 2, 100}, {2, 3, 5}}));
+    vector<double> cost = engine.cheapestCosts(0);
+    CHECK_EQ(cost[1], 10.0);
+    CHECK_EQ(cost[2], 15.0);
+    // The pair still weighs the combined budget for totals
+    CHECK_EQ(engine.pairWeight(0, 1), 110);
+}
+
+TEST(EngineCheapestCostsMatchDirectedGraphWithoutOneWayRoads) {
+    const int cityCount = 60;
+    vector<Road> roads = randomRoads(cityCount, 150, 23);
+    for (Road& road : roads) {
+        road.oneWay = false;
+    }
+    vector<string> names;
+    for (int i = 1; i <= cityCount; ++i) {
+        names.push_back("City " + to_string(i));
+    }
+    DirectedRoadGraph graph;
+    graph.build(cityCount, roads);
+    BasicInfrastructure<DenseStorage, Budget> engine;
+    REQUIRE(engine.loadNetwork(names, roads));
+    engine.reorderStorage(CityOrder::ReverseCuthillMcKee);
+
+    for (int source = 0; source < cityCount; ++source) {
+        vector<double> expected = graph.cheapestFrom(source);
+        vector<double> cost = engine.cheapestCosts(source);
+        for (int target = 0; target < cityCount; ++target) {
+            CHECK_EQ(cost[target], expected[target]);
+        }
+    }
+}
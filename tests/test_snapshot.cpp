@@ -0,0 +1,162 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - snapshot tests
+ *
+ * Writing and reading cities.txt / roads.txt, and the diff of two
+ * snapshots.
+ *****************************************************************/
+
+#include "test_harness.h"
+#include "generator.h"
+#include "infrastructure.h"
+#include "snapshot.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Checks that two snapshots hold the same cities and roads in the
+ * same order, and that their diff is empty
+ */
+static void checkSameNetwork(const NetworkSnapshot& expected, const NetworkSnapshot& actual) {
+    CHECK(actual.cityNames == expected.cityNames);
+    REQUIRE(actual.roads.size() == expected.roads.size());
+    for (size_t k = 0; k < expected.roads.size(); ++k) {
+        const Road& a = actual.roads[k];
+        const Road& e = expected.roads[k];
+        bool sameEnds = (a.city1 == e.city1 && a.city2 == e.city2) ||
+                        (!e.oneWay && a.city1 == e.city2 && a.city2 == e.city1);
+        CHECK(sameEnds);
+        CHECK_EQ(a.budget, e.budget);
+        CHECK_EQ(a.oneWay, e.oneWay);
+    }
+    CHECK(diffSnapshots(expected, actual).empty());
+}
+
+/**
+ * More than a thousand roads between cities whose names are longer
+ * than the padded columns, contain blanks and dashes
+ */
+static NetworkSnapshot largeSnapshot() {
+    NetworkSnapshot snapshot;
+    for (int i = 0; i < 200; ++i) {
+        snapshot.cityNames.push_back("Long City Name Number-" + to_string(i) + " Of The Eastern Province");
+    }
+    for (int i = 1; i <= 200; ++i) {
+        for (int step : {1, 3, 7, 11, 19, 23}) {
+            int j = (i - 1 + step) % 200 + 1;
+            snapshot.roads.push_back({min(i, j), max(i, j), static_cast<Budget>(i * 1000 + step), false});
+        }
+    }
+    snapshot.roads.push_back({5, 2, 1500000, true});
+    return snapshot;
+}
+
+TEST(SnapshotRoundTripsLargeNetworks) {
+    NetworkSnapshot written = largeSnapshot();
+    REQUIRE(written.roads.size() > 1000u);
+    REQUIRE(writeSnapshot(written, "snapshot"));
+
+    NetworkSnapshot read;
+    REQUIRE(readSnapshot("snapshot", read));
+    checkSameNetwork(written, read);
+}
+
+TEST(SavedFilesReadBackAsSnapshot) {
+    GeneratorOptions options;
+    options.cityCount = 600;
+    GeneratedNetwork generated = generateNetwork(options);
+    RwandaInfrastructure network;
+    loadGeneratedNetwork(network, generated);
+    network.addCity("A City Name Far Longer Than Twenty-Five Characters");
+    network.addRoad("A City Name Far Longer Than Twenty-Five Characters", generated.cityNames[0], false, true);
+    REQUIRE(network.roadCount() > 1000);
+    network.saveToFiles();
+
+    NetworkSnapshot read;
+    REQUIRE(readSnapshot(".", read));
+    NetworkSnapshot current = network.snapshot();
+    CHECK_EQ(read.roads.size(), current.roads.size());
+    CHECK(read.cityNames == current.cityNames);
+    CHECK(diffSnapshots(current, read).empty());
+}
+
+TEST(GeneratedFilesReadBackAsSnapshot) {
+    GeneratorOptions options;
+    options.cityCount = 2000;
+    GeneratedNetwork generated = generateNetwork(options);
+    REQUIRE(generated.roads.size() > 1000u);
+    REQUIRE(writeGeneratedNetwork(generated, "."));
+
+    NetworkSnapshot read;
+    REQUIRE(readSnapshot(".", read));
+    CHECK_EQ(read.roads.size(), generated.roads.size());
+    CHECK(diffSnapshots({generated.cityNames, generated.roads}, read).empty());
+}
+
+TEST(SnapshotDiffReportsEachKindOfChange) {
+    NetworkSnapshot before = {{"Kigali", "Musanze", "Huye", "Rubavu"},
+                              {{1, 2, 1000, false}, {1, 3, 2000, false}, {2, 4, 3000, false}}};
+    NetworkSnapshot after = {{"Kigali", "Ruhengeri", "Huye", "Nyanza"},
+                             {{1, 2, 1500, false}, {1, 3, 2000, false}, {3, 4, 500, false}}};
+    vector<NetworkChange> changes = diffSnapshots(before, after);
+
+    int counts[6] = {0, 0, 0, 0, 0, 0};
+    for (const NetworkChange& change : changes) {
+        counts[static_cast<int>(change.kind)]++;
+    }
+    CHECK_EQ(counts[static_cast<int>(ChangeKind::CityRenamed)], 2);
+    CHECK_EQ(counts[static_cast<int>(ChangeKind::RoadAdded)], 1);
+    CHECK_EQ(counts[static_cast<int>(ChangeKind::RoadRemoved)], 1);
+    CHECK_EQ(counts[static_cast<int>(ChangeKind::BudgetChanged)], 1);
+
+    ostringstream out;
+    printChanges(before, after, changes, out);
+    CHECK(out.str().find("Musanze -> Ruhengeri") != string::npos);
+}
+
+TEST(SnapshotDiffReportsDirectionChanges) {
+    // Kigali-Musanze turns one-way, Musanze->Huye is reversed, the
+    // Kigali->Huye one-way road keeps its direction next to a new
+    // parallel two-way road, and Huye->Rubavu is removed
+    NetworkSnapshot before = {{"Kigali", "Musanze", "Huye", "Rubavu"},
+                              {{1, 2, 1000, false}, {2, 3, 2000, true}, {1, 3, 3000, true}, {3, 4, 4000, true}}};
+    NetworkSnapshot after = {{"Kigali", "Musanze", "Huye", "Rubavu"},
+                             {{2, 1, 1000, true}, {3, 2, 2500, true}, {1, 3, 500, false}, {1, 3, 3000, true}}};
+    vector<NetworkChange> changes = diffSnapshots(before, after);
+
+    REQUIRE(changes.size() == 4u);
+    CHECK(changes[0].kind == ChangeKind::DirectionChanged);
+    CHECK(changes[0].oldDirection == RoadDirection::TwoWay);
+    CHECK(changes[0].newDirection == RoadDirection::Backward);
+    CHECK(changes[1].kind == ChangeKind::RoadAdded);
+    CHECK(changes[1].newDirection == RoadDirection::TwoWay);
+    CHECK(changes[2].kind == ChangeKind::DirectionChanged);
+    CHECK(changes[2].oldDirection == RoadDirection::Forward);
+    CHECK(changes[2].newDirection == RoadDirection::Backward);
+    CHECK_EQ(changes[2].newBudget, 2500);
+    CHECK(changes[3].kind == ChangeKind::RoadRemoved);
+    CHECK(changes[3].oldDirection == RoadDirection::Forward);
+
+    ostringstream out;
+    printChanges(before, after, changes, out);
+    string text = out.str();
+    CHECK(text.find("~ road  Kigali-Musanze now Musanze->Kigali") != string::npos);
+    CHECK(text.find("~ road  Musanze->Huye now Huye->Musanze  0.002 -> 0.0025") != string::npos);
+    CHECK(text.find("- road  Huye->Rubavu") != string::npos);
+    CHECK(text.find("2 directions changed") != string::npos);
+}
+
+TEST(SnapshotDiffFollowsDirectionAcrossRenumbering) {
+    // Rubavu is removed, so its one-way road is reported with the
+    // older city numbers, leaving the lower index
+    NetworkSnapshot before = {{"Kigali", "Rubavu", "Huye"}, {{3, 2, 1000, true}}};
+    NetworkSnapshot after = {{"Kigali", "Huye"}, {}};
+    vector<NetworkChange> changes = diffSnapshots(before, after);
+
+    ostringstream out;
+    printChanges(before, after, changes, out);
+    CHECK(out.str().find("- road  Huye->Rubavu") != string::npos);
+}
@@ -0,0 +1,109 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - spatial index tests
+ *
+ * Nearest-city and area queries against a linear scan.
+ *****************************************************************/
+
+#include "test_harness.h"
+#include "spatial_index.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Random locations across Rwanda for slots 0 .. count - 1
+ */
+static vector<GeoPoint> randomPoints(int count, unsigned seed) {
+    mt19937 rng(seed);
+    uniform_real_distribution<double> latitude(-2.85, -1.05);
+    uniform_real_distribution<double> longitude(28.85, 30.9);
+    vector<GeoPoint> points;
+    for (int i = 0; i < count; ++i) {
+        points.push_back({latitude(rng), longitude(rng)});
+    }
+    return points;
+}
+
+/**
+ * Distances from a point to the k nearest of the given points, sorted
+ */
+static vector<double> bruteForceNearest(const vector<GeoPoint>& points, const vector<bool>& live,
+                                        GeoPoint query, size_t k) {
+    vector<double> distances;
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (live[i]) {
+            distances.push_back(distanceKm(query, points[i]));
+        }
+    }
+    sort(distances.begin(), distances.end());
+    distances.resize(min(k, distances.size()));
+    return distances;
+}
+
+TEST(NearestMatchesBruteForce) {
+    // Enough points for several merged trees and a partly filled buffer
+    const int count = 1000;
+    vector<GeoPoint> points = randomPoints(count, 5);
+    vector<bool> live(count, true);
+    SpatialIndex index;
+    for (int i = 0; i < count; ++i) {
+        REQUIRE(index.setLocation(i, points[i]));
+    }
+
+    // Moved and removed cities leave stale entries the queries must skip
+    vector<GeoPoint> moved = randomPoints(100, 6);
+    for (int i = 0; i < 100; ++i) {
+        points[i * 7] = moved[i];
+        index.setLocation(i * 7, moved[i]);
+    }
+    for (int i = 3; i < count; i += 11) {
+        live[i] = false;
+        index.clearLocation(i);
+    }
+
+    vector<GeoPoint> queries = randomPoints(50, 7);
+    for (const GeoPoint& query : queries) {
+        for (size_t k : {size_t(1), size_t(5), size_t(40)}) {
+            vector<SpatialIndex::Neighbor> found = index.nearest(query, k);
+            vector<double> expected = bruteForceNearest(points, live, query, k);
+            REQUIRE(found.size() == expected.size());
+            for (size_t r = 0; r < found.size(); ++r) {
+                CHECK_EQ(found[r].distanceKm, expected[r]);
+                CHECK(live[found[r].city]);
+                CHECK_EQ(found[r].distanceKm, distanceKm(query, points[found[r].city]));
+            }
+        }
+    }
+}
+
+TEST(WithinMatchesBruteForce) {
+    const int count = 500;
+    vector<GeoPoint> points = randomPoints(count, 8);
+    SpatialIndex index;
+    for (int i = 0; i < count; ++i) {
+        index.setLocation(i, points[i]);
+    }
+
+    GeoBox area = {-2.2, 29.5, -1.6, 30.2};
+    vector<int> expected;
+    for (int i = 0; i < count; ++i) {
+        if (points[i].latitude >= area.south && points[i].latitude <= area.north &&
+            points[i].longitude >= area.west && points[i].longitude <= area.east) {
+            expected.push_back(i);
+        }
+    }
+    CHECK(index.within(area) == expected);
+}
+
+TEST(NearestWithFewerLocatedCities) {
+    SpatialIndex index;
+    CHECK(index.nearest({-1.95, 30.06}, 3).empty());
+    index.setLocation(4, {-1.95, 30.06});
+    CHECK(!index.setLocation(1, {95.0, 30.0}));
+    vector<SpatialIndex::Neighbor> found = index.nearest({-1.5, 29.6}, 3);
+    REQUIRE(found.size() == 1u);
+    CHECK_EQ(found[0].city, 4);
+}
@@ -0,0 +1,138 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - fuzzy name search tests
+ *
+ * Ranking of similar names, suggestions for unknown cities, and
+ * the index kept current as cities are added, renamed and undone.
+ *****************************************************************/
+
+#include "test_harness.h"
+#include "infrastructure.h"
+#include "trigram_index.h"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Slots of the matches, best first
+ */
+static vector<int> citiesOf(const vector<NameMatch>& matches) {
+    vector<int> cities;
+    for (const NameMatch& match : matches) {
+        cities.push_back(match.city);
+    }
+    return cities;
+}
+
+TEST(EditDistanceCountsSingleCharacterEdits) {
+    CHECK_EQ(editDistance("", ""), 0);
+    CHECK_EQ(editDistance("huye", ""), 4);
+    CHECK_EQ(editDistance("nyagatre", "nyagatare"), 1);
+    CHECK_EQ(editDistance("kigali", "kigaly"), 1);
+    CHECK_EQ(editDistance("rubavu", "rusizi"), 4);
+}
+
+TEST(TrigramSearchRanksCloserNamesFirst) {
+    TrigramIndex index;
+    index.add(0, "Nyagatare");
+    index.add(1, "Nyanza");
+    index.add(2, "Kigali");
+    index.add(3, "Nyagatare Town");
+    index.add(4, "Nyagatere");
+
+    vector<NameMatch> matches = index.search("Nyagatre", 10);
+    REQUIRE(matches.size() >= 3);
+    CHECK_EQ(matches[0].city, 0);
+    for (size_t i = 1; i < matches.size(); ++i) {
+        CHECK(matches[i - 1].similarity >= matches[i].similarity);
+        if (matches[i - 1].similarity == matches[i].similarity) {
+            CHECK(matches[i - 1].editDistance <= matches[i].editDistance);
+        }
+    }
+    for (const NameMatch& match : matches) {
+        CHECK(match.city != 2);
+        CHECK(match.similarity >= TrigramIndex::DEFAULT_THRESHOLD);
+    }
+
+    // An exact match in any case or accents is similarity 1
+    matches = index.search("KIGAL\xC3\x8D", 1);
+    REQUIRE(matches.size() == 1u);
+    CHECK_EQ(matches[0].city, 2);
+    CHECK_EQ(matches[0].similarity, 1.0);
+    CHECK_EQ(matches[0].editDistance, 0);
+}
+
+TEST(TrigramSearchHonoursLimitAndThreshold) {
+    TrigramIndex index;
+    index.add(0, "Nyagatare");
+    index.add(1, "Nyagatere");
+    index.add(2, "Nyagatari");
+
+    vector<NameMatch> all = index.search("Nyagatare", 10);
+    CHECK_EQ(all.size(), 3u);
+    vector<NameMatch> best = index.search("Nyagatare", 2);
+    REQUIRE(best.size() == 2u);
+    CHECK_EQ(best[0].city, all[0].city);
+    CHECK_EQ(best[1].city, all[1].city);
+    CHECK(index.search("Nyagatare", 0).empty());
+    CHECK_EQ(index.search("Nyagatare", 10, 1.0).size(), 1u);
+    CHECK(index.search("Huye", 10).empty());
+
+    // Searches reuse their scratch counts, so repeating one gives the
+    // same answer
+    CHECK(citiesOf(index.search("Nyagatare", 10)) == citiesOf(all));
+}
+
+TEST(TrigramIndexFollowsAddsRenamesAndRemovals) {
+    TrigramIndex index;
+    index.add(0, "Musanze");
+    index.add(1, "Rubavu");
+    index.add(2, "Huye");
+    CHECK(citiesOf(index.search("Rubavu", 5)) == vector<int>{1});
+
+    // Re-adding a slot replaces its name
+    index.add(1, "Karongi");
+    CHECK(index.search("Rubavu", 5).empty());
+    CHECK(citiesOf(index.search("Karongi", 5)) == vector<int>{1});
+
+    index.remove(2);
+    CHECK(index.search("Huye", 5).empty());
+    index.remove(2);
+    index.add(7, "Huye");
+    CHECK(citiesOf(index.search("Huye", 5)) == vector<int>{7});
+
+    index.clear();
+    CHECK(index.search("Musanze", 5).empty());
+    index.add(0, "Musanze");
+    CHECK(citiesOf(index.search("Musanze", 5)) == vector<int>{0});
+}
+
+TEST(UnknownCitiesGetSuggestions) {
+    RwandaInfrastructure network;
+    network.addCity("Kigali");
+    network.addCity("Nyagatare");
+    network.addCity("Huye");
+
+    ostringstream out;
+    streambuf* previous = cout.rdbuf(out.rdbuf());
+    network.addRoad("Nyagatre", "Huye");
+    cout.rdbuf(previous);
+    CHECK(out.str().find("City Nyagatre not found. Did you mean Nyagatare?") != string::npos);
+
+    vector<NameMatch> matches = network.findSimilarCities("kigaly", 3);
+    REQUIRE(!matches.empty());
+    CHECK_EQ(matches[0].city, 0);
+
+    // Renamed and undone cities leave the suggestions
+    CHECK(network.editCity("Nyagatare", "Rwamagana"));
+    CHECK(citiesOf(network.findSimilarCities("Nyagatre", 3)).empty());
+    CHECK(network.undo());
+    CHECK(citiesOf(network.findSimilarCities("Nyagatre", 3)) == vector<int>{1});
+    network.addCity("Gicumbi");
+    CHECK(citiesOf(network.findSimilarCities("Gicumby", 3)) == vector<int>{3});
+    CHECK(network.undo());
+    CHECK(network.findSimilarCities("Gicumby", 3).empty());
+}
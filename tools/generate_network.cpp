@@ -0,0 +1,113 @@
+/*****************************************************************
+ * Rwanda Infrastructure Management System - network generator tool
+ *
+ * Writes a synthetic network as cities.txt and roads.txt so that
+ * large datasets can be produced for scale and load testing.
+ *
+ * Usage: rwanda_generate [options]
+ *   --model=<geometric|grid|scalefree|road>   Graph model (road)
+ *   --cities=<n>                              Number of cities (100)
+ *   --degree=<d>                              Average roads per city (4)
+ *   --budget=<uniform|normal|lognormal|constant>
+ *   --budget-min=<x> --budget-max=<x>         Uniform bounds (1, 150)
+ *   --budget-mean=<x> --budget-stddev=<x>     Other distributions (50, 20)
+ *   --seed=<n>                                Random seed (42)
+ *   --out=<directory>                         Output directory (.)
+ *   --trace=<file>                            Write a Chrome trace of the run
+ *****************************************************************/
+
+#include "generator.h"
+#include "trace.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+/**
+ * Reads the value of a --name=value option
+ * @return False if the argument is not that option
+ */
+static bool optionValue(const string& argument, const string& name, string& value) {
+    string prefix = "--" + name + "=";
+    if (argument.rfind(prefix, 0) != 0) {
+        return false;
+    }
+    value = argument.substr(prefix.size());
+    return true;
+}
+
+int main(int argc, char** argv) {
+    GeneratorOptions options;
+    string outputDirectory = ".";
+    string tracePath;
+
+    for (int i = 1; i < argc; ++i) {
+        string argument = argv[i];
+        string value;
+        if (optionValue(argument, "model", value)) {
+            if (!parseGraphModel(value, options.model)) {
+                cerr << "Unknown model " << value << endl;
+                return 1;
+            }
+        } else if (optionValue(argument, "cities", value)) {
+            options.cityCount = atoi(value.c_str());
+        } else if (optionValue(argument, "degree", value)) {
+            options.averageDegree = atof(value.c_str());
+        } else if (optionValue(argument, "budget", value)) {
+            if (!parseBudgetDistribution(value, options.budgetDistribution)) {
+                cerr << "Unknown budget distribution " << value << endl;
+                return 1;
+            }
+        } else if (optionValue(argument, "budget-min", value)) {
+            options.budgetMin = atof(value.c_str());
+        } else if (optionValue(argument, "budget-max", value)) {
+            options.budgetMax = atof(value.c_str());
+        } else if (optionValue(argument, "budget-mean", value)) {
+            options.budgetMean = atof(value.c_str());
+        } else if (optionValue(argument, "budget-stddev", value)) {
+            options.budgetStdDev = atof(value.c_str());
+        } else if (optionValue(argument, "seed", value)) {
+            options.seed = static_cast<unsigned>(strtoul(value.c_str(), nullptr, 10));
+        } else if (optionValue(argument, "out", value)) {
+            outputDirectory = value;
+        } else if (optionValue(argument, "trace", value)) {
+            tracePath = value;
+        } else {
+            cerr << "Unknown option " << argument << endl;
+            return 1;
+        }
+    }
+
+    if (options.cityCount <= 0) {
+        cerr << "Number of cities must be positive." << endl;
+        return 1;
+    }
+    if (options.averageDegree < 0 || options.budgetMin < 0 || options.budgetMin > options.budgetMax) {
+        cerr << "Degree must not be negative and budget bounds must satisfy 0 <= min <= max." << endl;
+        return 1;
+    }
+
+    if (!tracePath.empty()) {
+        startTracing();
+    }
+
+    GeneratedNetwork network = generateNetwork(options);
+    fs::create_directories(outputDirectory);
+    bool written = writeGeneratedNetwork(network, outputDirectory);
+
+    if (!tracePath.empty()) {
+        stopTracing();
+        writeChromeTrace(tracePath);
+    }
+    if (!written) {
+        return 1;
+    }
+
+    cout << "Generated " << network.cityNames.size() << " cities and " << network.roads.size()
+         << " roads in " << fs::absolute(outputDirectory).string() << endl;
+    return 0;
+}